@@ -0,0 +1,108 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ *
+ *  Times the dispatch of actions to contracts that do next to nothing, one with a single page of
+ *  linear memory and one with a large memory whose data segment sits at its end, on both runtimes.
+ *  Every action starts from a freshly reset linear memory, so the difference between the two
+ *  contracts is the cost of resetting the larger memory. Run it on both sides of a change to the
+ *  reset to compare them.
+ */
+#include <snax/testing/tester.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/time.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <iostream>
+#include <iomanip>
+
+using namespace snax::chain;
+using namespace snax::testing;
+
+namespace {
+
+   /// a contract with `pages` pages of memory, 60KiB of initial data at its end, which writes to
+   /// its first and last page
+   string make_contract( uint32_t pages ) {
+      const uint32_t data_size = 60*1024;
+      const uint32_t end = pages * 64*1024;
+      return "(module"
+             " (memory " + std::to_string( pages ) + ")"
+             " (data (i32.const " + std::to_string( end - data_size ) + ") \"" + string( data_size, 'x' ) + "\")"
+             " (export \"apply\" (func $apply))"
+             " (func $apply (param i64 i64 i64)"
+             "  (i64.store (i32.const 0) (get_local 0))"
+             "  (i64.store (i32.const " + std::to_string( end - 8 ) + ") (get_local 2))))";
+   }
+
+   controller::config make_config( const fc::path& dir, wasm_interface::vm_type vm ) {
+      controller::config cfg;
+      cfg.blocks_dir = dir / config::default_blocks_dir_name;
+      cfg.state_dir = dir / config::default_state_dir_name;
+      cfg.state_size = 1024*1024*64;
+      cfg.state_guard_size = 0;
+      cfg.reversible_cache_size = 1024*1024*64;
+      cfg.reversible_guard_size = 0;
+      cfg.contracts_console = false;
+      cfg.wasm_runtime = vm;
+      cfg.genesis.initial_timestamp = fc::time_point::from_iso_string( "2020-01-01T00:00:00.000" );
+      cfg.genesis.initial_key = tester::get_public_key( config::system_account_name, "active" );
+      return cfg;
+   }
+
+   /// microseconds per action
+   double time_dispatch( tester& chain, account_name contract, uint32_t actions_per_trx, uint32_t trxs ) {
+      auto start = fc::time_point::now();
+      for( uint32_t t = 0; t < trxs; ++t ) {
+         signed_transaction trx;
+         for( uint32_t a = 0; a < actions_per_trx; ++a ) {
+            // the data keeps the transactions apart
+            trx.actions.emplace_back( vector<permission_level>{{contract, config::active_name}}, contract, N(run),
+                                      fc::raw::pack( t ) );
+         }
+         chain.set_transaction_headers( trx );
+         trx.sign( tester::get_private_key( contract, "active" ), chain.control->get_chain_id() );
+         chain.push_transaction( trx );
+         if( (t + 1) % 10 == 0 )
+            chain.produce_block();
+      }
+      return ( fc::time_point::now() - start ).count() / double( actions_per_trx * trxs );
+   }
+
+}
+
+int main( int argc, char** argv ) {
+   try {
+      uint32_t pages = argc > 1 ? std::stoul( argv[1] ) : 256;
+      uint32_t actions_per_trx = argc > 2 ? std::stoul( argv[2] ) : 10;
+      uint32_t trxs = argc > 3 ? std::stoul( argv[3] ) : 500;
+
+      fc::temp_directory tempdir;
+      std::cout << actions_per_trx * trxs << " actions, in transactions of " << actions_per_trx << std::endl;
+
+      for( auto vm : {wasm_interface::vm_type::wavm, wasm_interface::vm_type::wabt} ) {
+         string name = vm == wasm_interface::vm_type::wavm ? "wavm" : "wabt";
+         tester chain( make_config( tempdir.path() / name, vm ) );
+         chain.create_accounts( {N(small), N(large)} );
+         chain.produce_block();
+         chain.set_code( N(small), make_contract( 1 ).c_str() );
+         chain.set_code( N(large), make_contract( pages ).c_str() );
+         chain.produce_block();
+
+         // the first actions compile the contracts
+         time_dispatch( chain, N(small), 1, 1 );
+         time_dispatch( chain, N(large), 1, 1 );
+
+         double small = time_dispatch( chain, N(small), actions_per_trx, trxs );
+         double large = time_dispatch( chain, N(large), actions_per_trx, trxs );
+         std::cout << name << ": " << std::fixed << std::setprecision( 1 )
+                   << std::setw( 8 ) << small << " us/action with 1 page, "
+                   << std::setw( 8 ) << large << " us/action with " << pages << " pages" << std::endl;
+      }
+   } catch( const fc::exception& e ) {
+      std::cerr << e.to_detail_string() << std::endl;
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ *
+ *  Rebuilds the index of a synthetic block log with the sequential walk block_log used before,
+ *  which decodes every block to find the next one, and with block_log::construct_index on one
+ *  and on all cores, reporting the throughput over the log size.
+ *
+ *  The synthetic log holds blocks padded with a block extension to the given average size.
+ */
+#include <snax/chain/block_log.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/time.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace snax::chain;
+
+namespace {
+
+   // the implementation previously in block_log.cpp, kept as the baseline
+   void construct_index_sequential( const fc::path& block_file, const fc::path& index_file ) {
+      std::fstream block_stream;
+      std::fstream index_stream;
+      block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+      index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+      block_stream.open(block_file.generic_string().c_str(), std::ios::in | std::ios::binary);
+      index_stream.open(index_file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+      uint64_t end_pos;
+      block_stream.seekg(-sizeof( uint64_t), std::ios::end);
+      block_stream.read((char*)&end_pos, sizeof(end_pos));
+      signed_block tmp;
+
+      uint64_t pos = 8;
+      block_stream.seekg(pos);
+
+      genesis_state gs;
+      fc::raw::unpack(block_stream, gs);
+
+      uint64_t totem;
+      block_stream.read((char*) &totem, sizeof(totem));
+
+      while( pos < end_pos ) {
+         fc::raw::unpack(block_stream, tmp);
+         block_stream.read((char*)&pos, sizeof(pos));
+         index_stream.write((char*)&pos, sizeof(pos));
+      }
+   }
+
+   void make_log( const fc::path& dir, uint32_t block_count, uint32_t block_size ) {
+      block_log log( dir );
+      auto b = std::make_shared<signed_block>();
+      log.reset( genesis_state(), b );
+      for( uint32_t n = 2; n <= block_count; ++n ) {
+         auto next = std::make_shared<signed_block>();
+         next->previous = b->id();
+         next->timestamp = block_timestamp_type( n );
+         // vary the size so that block boundaries don't fall on a fixed stride
+         next->block_extensions.emplace_back( 0, vector<char>( block_size / 2 + (n * 7919) % block_size, char(n) ) );
+         log.append( next );
+         b = next;
+      }
+   }
+
+   template<typename F>
+   void run( const char* name, const fc::path& dir, uint32_t rounds, F&& f ) {
+      auto block_file = dir / "blocks.log";
+      auto index_file = dir / "blocks.index";
+      std::ifstream original_stream( index_file.generic_string().c_str(), std::ios::binary );
+      std::vector<char> original( (std::istreambuf_iterator<char>( original_stream )), std::istreambuf_iterator<char>() );
+      auto rebuilt_file = dir / "rebuilt.index";
+
+      auto start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r )
+         f( block_file, rebuilt_file );
+      auto us = (fc::time_point::now() - start).count() / rounds;
+
+      std::ifstream rebuilt_stream( rebuilt_file.generic_string().c_str(), std::ios::binary );
+      std::vector<char> rebuilt( (std::istreambuf_iterator<char>( rebuilt_stream )), std::istreambuf_iterator<char>() );
+      FC_ASSERT( rebuilt == original, "${n} produced a different index", ("n", name) );
+
+      double gb = double( fc::file_size( block_file ) ) / (1024 * 1024 * 1024);
+      std::cout << std::setw(24) << name << std::setw(12) << us << " us, "
+                << std::setprecision(3) << gb / std::max<double>( us, 1 ) * 1000000 << " GB/s" << std::endl;
+   }
+}
+
+int main( int argc, char** argv ) {
+   try {
+      const uint32_t block_count = argc > 1 ? std::stoul( argv[1] ) : 100000;
+      const uint32_t block_size = argc > 2 ? std::stoul( argv[2] ) : 4096;
+      const uint32_t rounds = argc > 3 ? std::stoul( argv[3] ) : 3;
+
+      fc::temp_directory tempdir;
+      make_log( tempdir.path(), block_count, block_size );
+      std::cout << block_count << " blocks, " << fc::file_size( tempdir.path() / "blocks.log" ) << " bytes" << std::endl;
+
+      run( "sequential decode", tempdir.path(), rounds, []( const fc::path& log, const fc::path& index ) {
+         construct_index_sequential( log, index );
+      });
+      run( "construct_index 1 thread", tempdir.path(), rounds, []( const fc::path& log, const fc::path& index ) {
+         block_log::construct_index( log, index, 1 );
+      });
+      const uint32_t threads = std::max( 1u, std::thread::hardware_concurrency() );
+      run( "construct_index all cores", tempdir.path(), rounds, [threads]( const fc::path& log, const fc::path& index ) {
+         block_log::construct_index( log, index, threads );
+      });
+   } catch( const fc::exception& e ) {
+      std::cerr << e.to_detail_string() << std::endl;
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,199 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ *
+ *  Measures the checktime injection from both ends. For every .wasm under a directory, the
+ *  contracts of the build by default, it times parsing, injecting and serializing the code the way
+ *  wasm_interface does before instantiating it and reports how much the injections grow it. It then
+ *  times snax.token transfers and a contract spinning in a loop on both runtimes, the overhead of
+ *  the injected metering at run time. Run it on both sides of a change to the injections to
+ *  compare them.
+ */
+#include <snax/testing/tester.hpp>
+#include <snax/chain/asset.hpp>
+#include <snax/chain/wasm_snax_injection.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/fstream.hpp>
+#include <fc/time.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <snax.token/snax.token.wast.hpp>
+#include <snax.token/snax.token.abi.hpp>
+
+#include "IR/Module.h"
+#include "WASM/WASM.h"
+#include "Inline/Serialization.h"
+
+#include <boost/filesystem.hpp>
+
+#include <iostream>
+#include <iomanip>
+
+using namespace snax::chain;
+using namespace snax::testing;
+
+namespace {
+
+   /// a contract spinning `iterations` times through a loop that calls a function of its own
+   string make_loop_contract( uint32_t iterations ) {
+      return "(module"
+             " (export \"apply\" (func $apply))"
+             " (func $step (param i32) (result i32)"
+             "  (i32.xor (i32.mul (get_local 0) (i32.const 1103515245)) (i32.const 12345)))"
+             " (func $apply (param i64 i64 i64)"
+             "  (local i32 i32)"
+             "  (set_local 3 (i32.const " + std::to_string( iterations ) + "))"
+             "  (loop $l"
+             "   (set_local 4 (call $step (get_local 4)))"
+             "   (set_local 3 (i32.sub (get_local 3) (i32.const 1)))"
+             "   (br_if $l (get_local 3)))"
+             "  (drop (get_local 4))))";
+   }
+
+   struct transfer_args {
+      account_name   from;
+      account_name   to;
+      asset          quantity;
+      string         memo;
+   };
+
+}
+
+FC_REFLECT( transfer_args, (from)(to)(quantity)(memo) )
+
+namespace {
+
+   /// microseconds per injection and the size of the injected code
+   std::pair<double, size_t> time_injection( const std::vector<char>& code, uint32_t rounds ) {
+      size_t injected_size = 0;
+      auto start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r ) {
+         IR::Module module;
+         Serialization::MemoryInputStream stream( (const U8*)code.data(), code.size() );
+         WASM::serialize( stream, module );
+         module.userSections.clear();
+
+         wasm_injections::wasm_binary_injection injector( module );
+         injector.inject();
+
+         Serialization::ArrayOutputStream outstream;
+         WASM::serialize( outstream, module );
+         injected_size = outstream.getBytes().size();
+      }
+      return { ( fc::time_point::now() - start ).count() / double( rounds ), injected_size };
+   }
+
+   void bench_injection( const fc::path& dir, uint32_t rounds ) {
+      std::cout << "injection, " << rounds << " rounds" << std::endl;
+      for( boost::filesystem::recursive_directory_iterator itr( dir ), end; itr != end; ++itr ) {
+         if( itr->path().extension() != ".wasm" )
+            continue;
+         string content;
+         fc::read_file_contents( itr->path(), content );
+         std::vector<char> code( content.begin(), content.end() );
+         try {
+            auto r = time_injection( code, rounds );
+            std::cout << std::setw( 32 ) << std::left << itr->path().filename().generic_string() << std::right
+                      << std::fixed << std::setprecision( 1 ) << std::setw( 10 ) << r.first << " us, "
+                      << std::setw( 8 ) << code.size() << " -> " << std::setw( 8 ) << r.second << " bytes" << std::endl;
+         } catch( ... ) {
+            // some test contracts are invalid on purpose
+            std::cout << std::setw( 32 ) << std::left << itr->path().filename().generic_string() << std::right
+                      << " not a valid module" << std::endl;
+         }
+      }
+   }
+
+   controller::config make_config( const fc::path& dir, wasm_interface::vm_type vm ) {
+      controller::config cfg;
+      cfg.blocks_dir = dir / config::default_blocks_dir_name;
+      cfg.state_dir = dir / config::default_state_dir_name;
+      cfg.state_size = 1024*1024*64;
+      cfg.state_guard_size = 0;
+      cfg.reversible_cache_size = 1024*1024*64;
+      cfg.reversible_guard_size = 0;
+      cfg.contracts_console = false;
+      cfg.wasm_runtime = vm;
+      cfg.genesis.initial_timestamp = fc::time_point::from_iso_string( "2020-01-01T00:00:00.000" );
+      cfg.genesis.initial_key = tester::get_public_key( config::system_account_name, "active" );
+      return cfg;
+   }
+
+   /// microseconds per transaction
+   template<typename MakeAction>
+   double time_actions( tester& chain, account_name signer, uint32_t trxs, MakeAction&& make_action ) {
+      auto start = fc::time_point::now();
+      for( uint32_t t = 0; t < trxs; ++t ) {
+         signed_transaction trx;
+         trx.actions.emplace_back( make_action( t ) );
+         chain.set_transaction_headers( trx );
+         trx.sign( tester::get_private_key( signer, "active" ), chain.control->get_chain_id() );
+         chain.push_transaction( trx );
+         if( (t + 1) % 50 == 0 )
+            chain.produce_block();
+      }
+      return ( fc::time_point::now() - start ).count() / double( trxs );
+   }
+
+   void bench_runtime( wasm_interface::vm_type vm, const fc::path& dir, uint32_t trxs, uint32_t iterations ) {
+      tester chain( make_config( dir, vm ) );
+      chain.create_accounts( {N(snax.token), N(alice), N(bob), N(spin)} );
+      chain.produce_block();
+      chain.set_code( N(snax.token), snax_token_wast );
+      chain.set_abi( N(snax.token), snax_token_abi );
+      chain.set_code( N(spin), make_loop_contract( iterations ).c_str() );
+      chain.produce_block();
+      chain.push_action( N(snax.token), N(create), N(snax.token), fc::mutable_variant_object()
+                         ("issuer", "snax.token")
+                         ("maximum_supply", "1000000000.0000 TKN") );
+      chain.push_action( N(snax.token), N(issue), N(snax.token), fc::mutable_variant_object()
+                         ("to", "alice")
+                         ("quantity", "1000000.0000 TKN")
+                         ("memo", "") );
+      chain.produce_block();
+
+      auto transfer = [&]( uint32_t t ) {
+         // the memo keeps the transactions apart
+         return action( {permission_level{N(alice), config::active_name}}, N(snax.token), N(transfer),
+                        fc::raw::pack( transfer_args{N(alice), N(bob), asset::from_string( "0.0001 TKN" ), std::to_string( t )} ) );
+      };
+      auto spin = [&]( uint32_t t ) {
+         return action( {permission_level{N(spin), config::active_name}}, N(spin), N(run),
+                        // the data keeps the transactions apart
+                        fc::raw::pack( t ) );
+      };
+
+      // the first actions compile the contracts
+      time_actions( chain, N(alice), 1, transfer );
+      time_actions( chain, N(spin), 1, spin );
+
+      double transfers = time_actions( chain, N(alice), trxs, transfer );
+      double loops = time_actions( chain, N(spin), trxs, spin );
+      std::cout << ( vm == wasm_interface::vm_type::wavm ? "wavm" : "wabt" ) << ": "
+                << std::fixed << std::setprecision( 1 )
+                << std::setw( 8 ) << transfers << " us/transfer, "
+                << std::setw( 8 ) << loops << " us/" << iterations << " loop iterations" << std::endl;
+   }
+
+}
+
+int main( int argc, char** argv ) {
+   try {
+      fc::path dir = argc > 1 ? fc::path( argv[1] ) : fc::path( "contracts" );
+      uint32_t rounds = argc > 2 ? std::stoul( argv[2] ) : 20;
+      uint32_t trxs = argc > 3 ? std::stoul( argv[3] ) : 1000;
+      uint32_t iterations = argc > 4 ? std::stoul( argv[4] ) : 10000;
+
+      bench_injection( dir, rounds );
+
+      fc::temp_directory tempdir;
+      std::cout << trxs << " transactions of each" << std::endl;
+      bench_runtime( wasm_interface::vm_type::wavm, tempdir.path() / "wavm", trxs, iterations );
+      bench_runtime( wasm_interface::vm_type::wabt, tempdir.path() / "wabt", trxs, iterations );
+   } catch( const fc::exception& e ) {
+      std::cerr << e.to_detail_string() << std::endl;
+      return 1;
+   }
+   return 0;
+}
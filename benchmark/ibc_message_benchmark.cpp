@@ -0,0 +1,199 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ *
+ *  Replays a capture of framed ibc_plugin messages through the receive and send paths of a
+ *  connection, comparing decoding through mb_datastream with decode_message() and a fresh
+ *  vector per outgoing message with send_buffer_pool.
+ *
+ *  The capture holds frames as they go over the wire, a uint32_t length followed by the packed
+ *  ibc_message. Without a capture file one is synthesized from lwc_section_data_message and
+ *  ibc_trxs_data_message frames of the sizes a catching up relay sends.
+ */
+#include <snax/ibc_plugin/message_buffers.hpp>
+#include <fc/time.hpp>
+#include <fc/exception/exception.hpp>
+#include <boost/asio/buffer.hpp>
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+using namespace snax::ibc;
+
+namespace {
+
+   using frame = std::vector<char>;
+   using buffer_type = fc::message_buffer<1024*1024>;
+
+   frame make_frame( const ibc_message& msg ) {
+      uint32_t payload_size = fc::raw::pack_size( msg );
+      frame f( sizeof(payload_size) + payload_size );
+      fc::datastream<char*> ds( f.data(), f.size() );
+      ds.write( reinterpret_cast<const char*>(&payload_size), sizeof(payload_size) );
+      fc::raw::pack( ds, msg );
+      return f;
+   }
+
+   std::vector<frame> synthesize_capture( uint32_t count ) {
+      std::vector<frame> frames;
+      for( uint32_t n = 0; n < count; ++n ) {
+         if( n % 2 == 0 ) {
+            lwc_section_data_message msg;
+            for( uint32_t i = 0; i < 30; ++i ) {
+               signed_block_header h;
+               h.timestamp = block_timestamp_type( n * 30 + i );
+               h.transaction_mroot = digest_type::hash( i );
+               h.action_mroot = digest_type::hash( n );
+               msg.headers.push_back( h );
+               msg.blockroot_merkle.append( h.id() );
+            }
+            frames.push_back( make_frame( msg ) );
+         } else {
+            ibc_trxs_data_message msg;
+            msg.table = N(origtrxs);
+            for( uint32_t i = 0; i < 50; ++i ) {
+               ibc_trx_rich_info info;
+               info.table_id = n * 50 + i;
+               info.block_num = n;
+               info.trx_id = transaction_id_type::hash( i );
+               info.packed_trx_receipt.resize( 320, char(i) );
+               info.merkle_path.resize( 10, digest_type::hash( n ) );
+               msg.trxs_rich_info.push_back( info );
+            }
+            frames.push_back( make_frame( msg ) );
+         }
+      }
+      return frames;
+   }
+
+   std::vector<frame> load_capture( const std::string& path ) {
+      std::vector<frame> frames;
+      std::ifstream in( path, std::ios::binary );
+      FC_ASSERT( in, "can't open capture ${p}", ("p", path) );
+      uint32_t size = 0;
+      while( in.read( reinterpret_cast<char*>(&size), sizeof(size) ) ) {
+         frame f( sizeof(size) + size );
+         memcpy( f.data(), &size, sizeof(size) );
+         FC_ASSERT( in.read( f.data() + sizeof(size), size ), "truncated frame in capture" );
+         frames.push_back( std::move(f) );
+      }
+      return frames;
+   }
+
+   // same framing as ibc_plugin_impl::start_read_message, returns the number of decoded messages
+   template<typename Decode>
+   uint64_t replay( const std::vector<frame>& frames, Decode&& decode ) {
+      buffer_type buffer;
+      uint64_t decoded = 0;
+      for( const auto& f : frames ) {
+         if( buffer.bytes_to_write() < f.size() )
+            buffer.add_space( f.size() - buffer.bytes_to_write() );
+         boost::asio::buffer_copy( buffer.get_buffer_sequence_for_boost_async_read(), boost::asio::buffer( f ) );
+         buffer.advance_write_ptr( f.size() );
+
+         uint32_t message_length = 0;
+         auto index = buffer.read_index();
+         buffer.peek( &message_length, sizeof(message_length), index );
+         buffer.advance_read_ptr( sizeof(message_length) );
+
+         ibc_message msg;
+         decode( buffer, message_length, msg );
+         decoded += msg.which() + 1;
+      }
+      return decoded;
+   }
+
+   void run_decode( const std::vector<frame>& frames, uint32_t rounds ) {
+      uint64_t sink = 0;
+
+      auto start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r ) {
+         sink += replay( frames, []( buffer_type& buffer, uint32_t, ibc_message& msg ) {
+            auto ds = buffer.create_datastream();
+            fc::raw::unpack( ds, msg );
+         });
+      }
+      auto stream_us = (fc::time_point::now() - start).count();
+
+      std::vector<char> scratch;
+      start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r ) {
+         sink += replay( frames, [&scratch]( buffer_type& buffer, uint32_t message_length, ibc_message& msg ) {
+            decode_message( buffer, message_length, scratch, msg );
+         });
+      }
+      auto view_us = (fc::time_point::now() - start).count();
+
+      std::cout << "decode: mb_datastream " << std::setw(10) << double(stream_us) / rounds << " us/capture, "
+                << "decode_message " << std::setw(10) << double(view_us) / rounds << " us/capture, "
+                << "speedup " << std::setprecision(3) << double(stream_us) / std::max<int64_t>(view_us, 1)
+                << "  (" << sink % 10 << ")" << std::endl;
+   }
+
+   void run_encode( const std::vector<frame>& frames, uint32_t rounds ) {
+      std::vector<ibc_message> msgs;
+      for( const auto& f : frames ) {
+         fc::datastream<const char*> ds( f.data() + sizeof(uint32_t), f.size() - sizeof(uint32_t) );
+         ibc_message msg;
+         fc::raw::unpack( ds, msg );
+         msgs.push_back( std::move(msg) );
+      }
+
+      // keep a few buffers outstanding like a connection's write queue does
+      const size_t in_flight = 16;
+      uint64_t sink = 0;
+
+      auto encode = [&]( auto&& get_buffer ) {
+         std::deque<std::shared_ptr<std::vector<char>>> queue;
+         for( const auto& msg : msgs ) {
+            uint32_t payload_size = fc::raw::pack_size( msg );
+            auto buff = get_buffer( sizeof(payload_size) + payload_size );
+            fc::datastream<char*> ds( buff->data(), buff->size() );
+            ds.write( reinterpret_cast<const char*>(&payload_size), sizeof(payload_size) );
+            fc::raw::pack( ds, msg );
+            sink += buff->size();
+            queue.push_back( buff );
+            if( queue.size() > in_flight )
+               queue.pop_front();
+         }
+      };
+
+      auto start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r )
+         encode( []( size_t size ) { return std::make_shared<std::vector<char>>( size ); } );
+      auto alloc_us = (fc::time_point::now() - start).count();
+
+      send_buffer_pool pool;
+      start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r )
+         encode( [&pool]( size_t size ) { return pool.get( size ); } );
+      auto pool_us = (fc::time_point::now() - start).count();
+
+      std::cout << "encode: make_shared   " << std::setw(10) << double(alloc_us) / rounds << " us/capture, "
+                << "send_buffer_pool " << std::setw(8) << double(pool_us) / rounds << " us/capture, "
+                << "speedup " << std::setprecision(3) << double(alloc_us) / std::max<int64_t>(pool_us, 1)
+                << ", " << pool.allocations() << " allocations " << pool.reuses() << " reuses"
+                << "  (" << sink % 10 << ")" << std::endl;
+   }
+}
+
+int main( int argc, char** argv ) {
+   try {
+      const uint32_t rounds = argc > 1 ? std::stoul( argv[1] ) : 20;
+      auto frames = argc > 2 ? load_capture( argv[2] ) : synthesize_capture( 200 );
+
+      uint64_t bytes = 0;
+      for( const auto& f : frames )
+         bytes += f.size();
+      std::cout << frames.size() << " frames, " << bytes << " bytes" << std::endl;
+
+      run_decode( frames, rounds );
+      run_encode( frames, rounds );
+   } catch( const fc::exception& e ) {
+      std::cerr << e.to_detail_string() << std::endl;
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ *
+ *  Compares producing transaction inclusion proofs for a block with merkle_tree against the
+ *  per-transaction get_merkle_path that ibc_plugin used before, which rehashes the whole tree
+ *  and recomputes merkle() for every requested transaction.
+ */
+#include <snax/chain/merkle.hpp>
+#include <fc/time.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <iostream>
+#include <iomanip>
+
+using namespace snax::chain;
+
+namespace {
+
+   // the implementation previously in ibc_plugin.cpp, kept as the baseline
+   vector<digest_type> get_merkle_path( vector<digest_type> ids, uint32_t num ) {
+      if( 0 == ids.size() || num > ids.size() - 1 ) { return vector<digest_type>(); }
+
+      vector<digest_type> result;
+
+      if( ids.size() == 1 ){
+         result.push_back( ids.front() );
+         return result;
+      }
+
+      if ( num % 2 == 0 ){
+         result.push_back(ids[num]);
+         if ( num == ids.size() - 1 ){
+            result.push_back(ids[num]);
+         } else {
+            result.push_back(ids[num+1]);
+         }
+      } else {
+         result.push_back(ids[num-1]);
+         result.push_back(ids[num]);
+      }
+
+      uint32_t idx_in_layer = num;
+      while( ids.size() > 1 ) {
+         if( ids.size() % 2 )
+            ids.push_back(ids.back());
+
+         for (size_t i = 0; i < ids.size() / 2; i++) {
+            ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+         }
+         ids.resize(ids.size() / 2);
+
+         if ( ids.size() > 1 ){
+            idx_in_layer /= 2;
+            if ( idx_in_layer % 2 == 0 ){
+               if ( idx_in_layer == ids.size() - 1 ){
+                  result.push_back( make_canonical_right(ids[idx_in_layer]) );
+               } else {
+                  result.push_back( make_canonical_right(ids[idx_in_layer+1]) );
+               }
+            } else {
+               result.push_back( make_canonical_left(ids[idx_in_layer-1]) );
+            }
+         }
+      }
+
+      result.push_back( ids.front() );
+      return result;
+   }
+
+   vector<digest_type> make_leaves( uint32_t count ) {
+      vector<digest_type> leaves;
+      leaves.reserve( count );
+      for( uint32_t i = 0; i < count; ++i )
+         leaves.push_back( digest_type::hash( i ) );
+      return leaves;
+   }
+
+   void run( uint32_t leaf_count, uint32_t proof_count, uint32_t rounds ) {
+      auto leaves = make_leaves( leaf_count );
+      proof_count = std::min( proof_count, leaf_count );
+
+      // both implementations must agree before their timings mean anything
+      merkle_tree check( leaves );
+      FC_ASSERT( check.root() == merkle( leaves ) );
+      for( uint32_t i = 0; i < leaf_count; ++i )
+         FC_ASSERT( check.get_path( i ) == get_merkle_path( leaves, i ), "path mismatch for leaf ${i}", ("i", i) );
+
+      size_t sink = 0;
+
+      auto start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r ) {
+         for( uint32_t i = 0; i < proof_count; ++i ) {
+            sink += merkle( leaves )._hash[0] & 1;
+            sink += get_merkle_path( leaves, i ).size();
+         }
+      }
+      auto legacy_us = (fc::time_point::now() - start).count();
+
+      start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r ) {
+         merkle_tree tree( leaves );
+         sink += tree.root()._hash[0] & 1;
+         for( uint32_t i = 0; i < proof_count; ++i )
+            sink += tree.get_path( i ).size();
+      }
+      auto tree_us = (fc::time_point::now() - start).count();
+
+      std::cout << std::setw(8) << leaf_count << " leaves "
+                << std::setw(4) << proof_count << " proofs: "
+                << "get_merkle_path " << std::setw(10) << double(legacy_us) / rounds << " us/block, "
+                << "merkle_tree " << std::setw(10) << double(tree_us) / rounds << " us/block, "
+                << "speedup " << std::setprecision(3) << double(legacy_us) / std::max<int64_t>(tree_us, 1)
+                << "  (" << sink % 10 << ")" << std::endl;
+   }
+}
+
+int main( int argc, char** argv ) {
+   try {
+      const uint32_t rounds = argc > 1 ? std::stoul( argv[1] ) : 100;
+      for( uint32_t leaf_count : {1, 10, 50, 200, 1000, 5000} ) {
+         run( leaf_count, 1, rounds );
+         run( leaf_count, 50, rounds );
+      }
+   } catch( const fc::exception& e ) {
+      std::cerr << e.to_detail_string() << std::endl;
+      return 1;
+   }
+   return 0;
+}
@@ -9,6 +9,7 @@
 #include <snax/chain/resource_limits.hpp>
 #include <snax/chain/account_object.hpp>
 #include <snax/chain/global_property_object.hpp>
+#include <snax/chain/cpu_profiler.hpp>
 #include <boost/container/flat_set.hpp>
 
 using boost::container::flat_set;
@@ -47,6 +48,7 @@ void apply_context::exec_one( action_trace& trace )
    const auto& cfg = control.get_global_properties().configuration;
    try {
       try {
+         cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::action, receiver, act.account, act.name );
          const auto& a = control.get_account( receiver );
          privileged = a.privileged;
          auto native = control.find_apply_handler( receiver, act.account, act.name );
@@ -521,6 +523,7 @@ int apply_context::db_store_i64( uint64_t scope, uint64_t table, const account_n
 }
 
 int apply_context::db_store_i64( uint64_t code, uint64_t scope, uint64_t table, const account_name& payer, uint64_t id, const char* buffer, size_t buffer_size ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_store_i64" );
 //   require_write_lock( scope );
    const auto& tab = find_or_create_table( code, scope, table, payer );
    auto tableid = tab.id;
@@ -547,6 +550,7 @@ int apply_context::db_store_i64( uint64_t code, uint64_t scope, uint64_t table,
 }
 
 void apply_context::db_update_i64( int iterator, account_name payer, const char* buffer, size_t buffer_size ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_update_i64" );
    const key_value_object& obj = keyval_cache.get( iterator );
 
    const auto& table_obj = keyval_cache.get_table( obj.t_id );
@@ -578,6 +582,7 @@ void apply_context::db_update_i64( int iterator, account_name payer, const char*
 }
 
 void apply_context::db_remove_i64( int iterator ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_remove_i64" );
    const key_value_object& obj = keyval_cache.get( iterator );
 
    const auto& table_obj = keyval_cache.get_table( obj.t_id );
@@ -600,6 +605,7 @@ void apply_context::db_remove_i64( int iterator ) {
 }
 
 int apply_context::db_get_i64( int iterator, char* buffer, size_t buffer_size ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_get_i64" );
    const key_value_object& obj = keyval_cache.get( iterator );
 
    auto s = obj.value.size();
@@ -612,6 +618,7 @@ int apply_context::db_get_i64( int iterator, char* buffer, size_t buffer_size )
 }
 
 int apply_context::db_next_i64( int iterator, uint64_t& primary ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_next_i64" );
    if( iterator < -1 ) return -1; // cannot increment past end iterator of table
 
    const auto& obj = keyval_cache.get( iterator ); // Check for iterator != -1 happens in this call
@@ -627,6 +634,7 @@ int apply_context::db_next_i64( int iterator, uint64_t& primary ) {
 }
 
 int apply_context::db_previous_i64( int iterator, uint64_t& primary ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_previous_i64" );
    const auto& idx = db.get_index<key_value_index, by_scope_primary>();
 
    if( iterator < -1 ) // is end iterator
@@ -659,6 +667,7 @@ int apply_context::db_previous_i64( int iterator, uint64_t& primary ) {
 }
 
 int apply_context::db_find_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_find_i64" );
    //require_read_lock( code, scope ); // redundant?
 
    const auto* tab = find_table( code, scope, table );
@@ -673,6 +682,7 @@ int apply_context::db_find_i64( uint64_t code, uint64_t scope, uint64_t table, u
 }
 
 int apply_context::db_lowerbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_lowerbound_i64" );
    //require_read_lock( code, scope ); // redundant?
 
    const auto* tab = find_table( code, scope, table );
@@ -689,6 +699,7 @@ int apply_context::db_lowerbound_i64( uint64_t code, uint64_t scope, uint64_t ta
 }
 
 int apply_context::db_upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_upperbound_i64" );
    //require_read_lock( code, scope ); // redundant?
 
    const auto* tab = find_table( code, scope, table );
@@ -705,6 +716,7 @@ int apply_context::db_upperbound_i64( uint64_t code, uint64_t scope, uint64_t ta
 }
 
 int apply_context::db_end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
+   cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::db, receiver, account_name(), action_name(), "db_end_i64" );
    //require_read_lock( code, scope ); // redundant?
 
    const auto* tab = find_table( code, scope, table );
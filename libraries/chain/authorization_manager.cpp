@@ -145,6 +145,7 @@ namespace snax { namespace chain {
          creation_time = _control.pending_block_time();
       }
 
+      permission_changed( {account, name} );
       const auto& perm_usage = _db.create<permission_usage_object>([&](auto& p) {
          p.last_used = creation_time;
       });
@@ -172,6 +173,7 @@ namespace snax { namespace chain {
          creation_time = _control.pending_block_time();
       }
 
+      permission_changed( {account, name} );
       const auto& perm_usage = _db.create<permission_usage_object>([&](auto& p) {
          p.last_used = creation_time;
       });
@@ -188,6 +190,7 @@ namespace snax { namespace chain {
    }
 
    void authorization_manager::modify_permission( const permission_object& permission, const authority& auth ) {
+      permission_changed( {permission.owner, permission.name} );
       _db.modify( permission, [&](permission_object& po) {
          po.auth = auth;
          po.last_updated = _control.pending_block_time();
@@ -200,10 +203,54 @@ namespace snax { namespace chain {
       SNAX_ASSERT( range.first == range.second, action_validate_exception,
                   "Cannot remove a permission which has children. Remove the children first.");
 
+      permission_changed( {permission.owner, permission.name} );
       _db.get_mutable_index<permission_usage_index>().remove_object( permission.usage_id._id );
       _db.remove( permission );
    }
 
+   void authorization_manager::permission_changed( const permission_level& level ) {
+      ++_revision;
+      std::lock_guard<std::mutex> g( _cache_mutex );
+      _authority_cache.erase( level );
+   }
+
+   void authorization_manager::permission_link_changed( account_name account, account_name code ) {
+      ++_revision;
+      std::lock_guard<std::mutex> g( _cache_mutex );
+      // the contract-wide link of the code decides for all its actions without a link of their own
+      auto itr = _link_cache.lower_bound( link_key( account, code, action_name() ) );
+      while( itr != _link_cache.end() && std::get<0>( itr->first ) == account && std::get<1>( itr->first ) == code )
+         itr = _link_cache.erase( itr );
+   }
+
+   void authorization_manager::undone( uint64_t session_revision ) {
+      if( _revision != session_revision )
+         clear_cache();
+   }
+
+   void authorization_manager::clear_cache() {
+      ++_revision;
+      std::lock_guard<std::mutex> g( _cache_mutex );
+      _authority_cache.clear();
+      _link_cache.clear();
+   }
+
+   std::shared_ptr<const authority> authorization_manager::get_cached_authority( const permission_level& level )const {
+      {
+         std::lock_guard<std::mutex> g( _cache_mutex );
+         auto itr = _authority_cache.find( level );
+         if( itr != _authority_cache.end() )
+            return itr->second;
+      }
+
+      auto auth = std::make_shared<const authority>( get_permission( level ).auth.to_authority() );
+      std::lock_guard<std::mutex> g( _cache_mutex );
+      if( _authority_cache.size() >= config::max_cached_authorities )
+         _authority_cache.clear();
+      _authority_cache.emplace( level, auth );
+      return auth;
+   }
+
    void authorization_manager::update_permission_usage( const permission_object& permission ) {
       const auto& puo = _db.get<permission_usage_object, by_id>( permission.usage_id );
       _db.modify( puo, [&](permission_usage_object& p) {
@@ -233,6 +280,14 @@ namespace snax { namespace chain {
                                                                             )const
    {
       try {
+         link_key cache_key( authorizer_account, scope, act_name );
+         {
+            std::lock_guard<std::mutex> g( _cache_mutex );
+            auto itr = _link_cache.find( cache_key );
+            if( itr != _link_cache.end() )
+               return itr->second;
+         }
+
          // First look up a specific link for this message act_name
          auto key = boost::make_tuple(authorizer_account, scope, act_name);
          auto link = _db.find<permission_link_object, by_action_name>(key);
@@ -243,10 +298,16 @@ namespace snax { namespace chain {
          }
 
          // If no specific or default link found, use active permission
+         optional<permission_name> result;
          if (link != nullptr) {
-            return link->required_permission;
+            result = link->required_permission;
          }
-         return optional<permission_name>();
+
+         std::lock_guard<std::mutex> g( _cache_mutex );
+         if( _link_cache.size() >= config::max_cached_authorities )
+            _link_cache.clear();
+         _link_cache.emplace( cache_key, result );
+         return result;
 
        //  return optional<permission_name>();
       } FC_CAPTURE_AND_RETHROW((authorizer_account)(scope)(act_name))
@@ -441,7 +502,11 @@ namespace snax { namespace chain {
 
       auto effective_provided_delay =  (provided_delay >= delay_max_limit) ? fc::microseconds::maximum() : provided_delay;
 
-      auto checker = make_auth_checker( [&](const permission_level& p){ return get_permission(p).auth; },
+      vector<std::shared_ptr<const authority>> resolved; // keeps the cached authorities alive while the checker runs
+      auto checker = make_auth_checker( [&](const permission_level& p) -> const authority& {
+                                           resolved.emplace_back( get_cached_authority( p ) );
+                                           return *resolved.back();
+                                        },
                                         _control.get_global_properties().configuration.max_authority_depth,
                                         provided_keys,
                                         provided_permissions,
@@ -542,7 +607,11 @@ namespace snax { namespace chain {
 
       auto delay_max_limit = fc::seconds( _control.get_global_properties().configuration.max_transaction_delay );
 
-      auto checker = make_auth_checker( [&](const permission_level& p){ return get_permission(p).auth; },
+      vector<std::shared_ptr<const authority>> resolved;
+      auto checker = make_auth_checker( [&](const permission_level& p) -> const authority& {
+                                           resolved.emplace_back( get_cached_authority( p ) );
+                                           return *resolved.back();
+                                        },
                                         _control.get_global_properties().configuration.max_authority_depth,
                                         provided_keys,
                                         provided_permissions,
@@ -573,7 +642,11 @@ namespace snax { namespace chain {
                                                                        fc::microseconds provided_delay
                                                                      )const
    {
-      auto checker = make_auth_checker( [&](const permission_level& p){ return get_permission(p).auth; },
+      vector<std::shared_ptr<const authority>> resolved;
+      auto checker = make_auth_checker( [&](const permission_level& p) -> const authority& {
+                                           resolved.emplace_back( get_cached_authority( p ) );
+                                           return *resolved.back();
+                                        },
                                         _control.get_global_properties().configuration.max_authority_depth,
                                         candidate_keys,
                                         {},
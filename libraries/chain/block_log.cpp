@@ -3,9 +3,17 @@
  *  @copyright defined in snax/LICENSE.txt
  */
 #include <snax/chain/block_log.hpp>
+#include <snax/chain/block_log_reader.hpp>
 #include <snax/chain/exceptions.hpp>
 #include <fstream>
 #include <fc/io/raw.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
+#include <future>
+#include <thread>
 
 #define LOG_READ  (std::ios::in | std::ios::binary)
 #define LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
@@ -23,6 +31,14 @@ namespace snax { namespace chain {
    const uint32_t block_log::max_supported_version = 2;
 
    namespace detail {
+      /// a completed part of a segmented block log, a block log of its own named after its block range
+      struct block_log_segment {
+         uint32_t   first_block_num = 0;
+         uint32_t   last_block_num = 0;
+         fc::path   block_file;
+         fc::path   index_file;
+      };
+
       class block_log_impl {
          public:
             signed_block_ptr         head;
@@ -36,6 +52,20 @@ namespace snax { namespace chain {
             bool                     genesis_written_to_block_log = false;
             uint32_t                 version = 0;
             uint32_t                 first_block_num = 0;
+            std::shared_ptr<block_log_reader> reader;
+
+            fc::path                 data_dir;
+            uint32_t                 segment_blocks = 0;   ///< 0 when the log is not segmented
+            uint32_t                 retained_segments = 0;   ///< 0 keeps all of them
+            std::map<uint32_t, block_log_segment> segments;   ///< completed segments by first block number
+            uint32_t                 open_segment = 0;   ///< first block number of the segment read by the streams below
+            std::fstream             segment_block_stream;
+            std::fstream             segment_index_stream;
+
+            inline void publish() {
+               reader->publish( first_block_num, head ? block_header::num_from_id(head_id) : 0,
+                                fc::exists(block_file) ? fc::file_size(block_file) : 0 );
+            }
 
             inline void check_block_read() {
                if (block_write) {
@@ -71,13 +101,247 @@ namespace snax { namespace chain {
                   index_write = true;
                }
             }
+
+            fc::path segment_file( uint32_t first, uint32_t last, const char* extension )const {
+               char name[64];
+               snprintf( name, sizeof(name), "blocks-%010u-%010u%s", first, last, extension );
+               return data_dir / name;
+            }
+
+            void close_segment() {
+               if (segment_block_stream.is_open())
+                  segment_block_stream.close();
+               if (segment_index_stream.is_open())
+                  segment_index_stream.close();
+               open_segment = 0;
+            }
+
+            /// the stream of the completed segment holding `block_num` positioned at the block, or nullptr
+            std::fstream* seek_segment_block( uint32_t block_num ) {
+               auto itr = segments.upper_bound( block_num );
+               if (itr == segments.begin())
+                  return nullptr;
+               const auto& seg = (--itr)->second;
+               if (block_num > seg.last_block_num)
+                  return nullptr;
+
+               if (open_segment != seg.first_block_num) {
+                  close_segment();
+                  segment_block_stream.open(seg.block_file.generic_string().c_str(), LOG_READ);
+                  segment_index_stream.open(seg.index_file.generic_string().c_str(), LOG_READ);
+                  open_segment = seg.first_block_num;
+               }
+
+               uint64_t pos;
+               segment_index_stream.seekg(sizeof(uint64_t) * (block_num - seg.first_block_num));
+               segment_index_stream.read((char*)&pos, sizeof(pos));
+               segment_block_stream.seekg(pos);
+               return &segment_block_stream;
+            }
+
+            void scan_segments();
+            void prune_segments();
       };
+
+      /// of a block log or a segment of it
+      genesis_state read_genesis_state( const fc::path& block_file );
+
+      inline uint64_t position_word( const char* data, uint64_t offset ) {
+         uint64_t pos;
+         memcpy( &pos, data + offset, sizeof(pos) );
+         return pos;
+      }
+
+      /// offset of the first block in a block log, right after its header
+      uint64_t first_block_position( const char* data, uint64_t size ) {
+         fc::datastream<const char*> ds( data, size );
+         uint32_t version = 0;
+         fc::raw::unpack( ds, version );
+         if (version > 1) {
+            uint32_t first_block_num = 0;
+            fc::raw::unpack( ds, first_block_num );
+         }
+         genesis_state gs;
+         fc::raw::unpack( ds, gs );
+         if (version > 1)
+            ds.skip( sizeof(uint64_t) ); // the totem
+         return ds.tellp();
+      }
+
+      /**
+       * Offset of the first block starting at or after `target`, or `end` if there is none. A block
+       * start is recognized by the position word right before it: it has to point back past the position
+       * word of the previous block, and the bytes in between have to decode to exactly one block.
+       */
+      uint64_t find_block_start( const char* data, uint64_t first_pos, uint64_t end, uint64_t target ) {
+         for (uint64_t t = std::max( target, first_pos + sizeof(uint64_t) ) - sizeof(uint64_t); t + sizeof(uint64_t) < end; ++t) {
+            uint64_t pos = position_word( data, t );
+            if (pos < first_pos || pos >= t)
+               continue;
+            if (pos != first_pos && (pos < first_pos + sizeof(uint64_t) || position_word( data, pos - sizeof(uint64_t) ) >= pos - sizeof(uint64_t)))
+               continue;
+            try {
+               fc::datastream<const char*> ds( data + pos, t - pos );
+               signed_block b;
+               fc::raw::unpack( ds, b );
+               if (ds.remaining() == 0)
+                  return t + sizeof(uint64_t);
+            } catch( ... ) {
+               // not a block
+            }
+         }
+         return end;
+      }
+
+      /**
+       * Walk back along the position words from the block ending at `end` to the block starting at `begin`,
+       * handing every block position to `f` last block first. Returns the number of blocks, or npos if the
+       * walk doesn't end at `begin`.
+       */
+      template<typename F>
+      uint64_t walk_back( const char* data, uint64_t begin, uint64_t end, F&& f ) {
+         uint64_t count = 0;
+         for (uint64_t t = end; t != begin; ++count) {
+            if (t < begin + sizeof(uint64_t))
+               return block_log::npos;
+            uint64_t pos = position_word( data, t - sizeof(uint64_t) );
+            if (pos < begin || pos >= t - sizeof(uint64_t))
+               return block_log::npos;
+            f( pos );
+            t = pos;
+         }
+         return count;
+      }
+
+      template<typename F>
+      void run_on( boost::asio::thread_pool& pool, size_t count, F&& f ) {
+         vector<std::future<void>> results;
+         for (size_t i = 0; i < count; ++i) {
+            auto task = std::make_shared<std::packaged_task<void()>>( [&f, i]() { f( i ); } );
+            results.emplace_back( task->get_future() );
+            boost::asio::post( pool, [task]() { (*task)(); } );
+         }
+         for (auto& r : results)
+            r.get();
+      }
+   }
+
+   void block_log::construct_index( const fc::path& block_file, const fc::path& index_file, uint32_t thread_count ) {
+      namespace bip = boost::interprocess;
+
+      bip::file_mapping log_mapping( block_file.generic_string().c_str(), bip::read_only );
+      bip::mapped_region log_region( log_mapping, bip::read_only );
+      const char* data = static_cast<const char*>( log_region.get_address() );
+      const uint64_t size = log_region.get_size();
+      const uint64_t first_pos = detail::first_block_position( data, size );
+
+      // no point in splitting off ranges smaller than this
+      const uint64_t min_range_size = 16*1024*1024;
+      if (thread_count == 0)
+         thread_count = std::max( 1u, std::thread::hardware_concurrency() );
+      uint64_t range_count = std::max<uint64_t>( 1, std::min<uint64_t>( thread_count, (size - first_pos) / min_range_size ) );
+      boost::asio::thread_pool pool( range_count );
+
+      // split the log at the first block start after evenly spaced offsets, ranges are walked independently
+      vector<uint64_t> bounds( range_count + 1 );
+      bounds.front() = first_pos;
+      bounds.back() = size;
+      detail::run_on( pool, range_count - 1, [&]( size_t i ) {
+         bounds[i + 1] = detail::find_block_start( data, first_pos, size, first_pos + (size - first_pos) * (i + 1) / range_count );
+      });
+      bounds.erase( std::unique( bounds.begin(), bounds.end() ), bounds.end() );
+
+      vector<uint64_t> counts( bounds.size() - 1 );
+      detail::run_on( pool, counts.size(), [&]( size_t i ) {
+         counts[i] = detail::walk_back( data, bounds[i], bounds[i + 1], []( uint64_t ) {} );
+      });
+      if (std::find( counts.begin(), counts.end(), npos ) != counts.end()) {
+         // a misplaced split, walking the whole log back from its end doesn't rely on any
+         wlog( "Block log could not be split for reindexing, walking it as a whole" );
+         bounds = { first_pos, size };
+         counts = { detail::walk_back( data, first_pos, size, []( uint64_t ) {} ) };
+         SNAX_ASSERT( counts.front() != npos, block_log_exception, "Block log ${f} is corrupted, its positions don't link up",
+                      ("f", block_file.generic_string()) );
+      }
+
+      vector<uint64_t> offsets( counts.size() + 1, 0 );
+      for (size_t i = 0; i < counts.size(); ++i)
+         offsets[i + 1] = offsets[i] + counts[i];
+
+      std::ofstream( index_file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+      boost::filesystem::resize_file( index_file, offsets.back() * sizeof(uint64_t) );
+      if (offsets.back() == 0)
+         return;
+
+      bip::file_mapping index_mapping( index_file.generic_string().c_str(), bip::read_write );
+      bip::mapped_region index_region( index_mapping, bip::read_write );
+      char* index = static_cast<char*>( index_region.get_address() );
+      detail::run_on( pool, counts.size(), [&]( size_t i ) {
+         char* out = index + offsets[i + 1] * sizeof(uint64_t);
+         detail::walk_back( data, bounds[i], bounds[i + 1], [&out]( uint64_t pos ) {
+            out -= sizeof(uint64_t);
+            memcpy( out, &pos, sizeof(pos) );
+         });
+      });
+      index_region.flush();
    }
 
-   block_log::block_log(const fc::path& data_dir)
+   namespace detail {
+
+      void block_log_impl::scan_segments() {
+         close_segment();
+         segments.clear();
+         for (boost::filesystem::directory_iterator itr(data_dir), end; itr != end; ++itr) {
+            block_log_segment seg;
+            char extension[8] = {};
+            auto name = itr->path().filename().generic_string();
+            if (sscanf(name.c_str(), "blocks-%10u-%10u%7s", &seg.first_block_num, &seg.last_block_num, extension) != 3 ||
+                std::string(extension) != ".log" || seg.last_block_num < seg.first_block_num)
+               continue;
+            seg.block_file = itr->path();
+            seg.index_file = segment_file(seg.first_block_num, seg.last_block_num, ".index");
+            if (!fc::exists(seg.index_file) ||
+                fc::file_size(seg.index_file) != sizeof(uint64_t) * (seg.last_block_num - seg.first_block_num + 1)) {
+               ilog("Reconstructing index of block log segment ${f} to ${l}", ("f", seg.first_block_num)("l", seg.last_block_num));
+               block_log::construct_index(seg.block_file, seg.index_file);
+            }
+            segments[seg.first_block_num] = seg;
+         }
+
+         // only the segments leading up to the active log without a gap are usable
+         auto next = first_block_num;
+         for (auto itr = segments.rbegin(); itr != segments.rend(); ++itr) {
+            if (next && itr->second.last_block_num + 1 != next) {
+               wlog("Block log segment ${f} to ${l} is not followed by block ${n}, ignoring it and all older segments",
+                    ("f", itr->second.first_block_num)("l", itr->second.last_block_num)("n", next));
+               segments.erase(segments.begin(), itr.base());
+               break;
+            }
+            next = itr->second.first_block_num;
+         }
+      }
+
+      void block_log_impl::prune_segments() {
+         while (retained_segments && segments.size() > retained_segments) {
+            auto itr = segments.begin();
+            if (open_segment == itr->first)
+               close_segment();
+            fc::remove(itr->second.block_file);
+            fc::remove(itr->second.index_file);
+            ilog("Pruned blocks ${f} to ${l} from the block log", ("f", itr->second.first_block_num)("l", itr->second.last_block_num));
+            segments.erase(itr);
+         }
+      }
+   }
+
+   block_log::block_log(const fc::path& data_dir, uint32_t segment_blocks, uint32_t retained_segments)
    :my(new detail::block_log_impl()) {
       my->block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
       my->index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+      my->segment_block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+      my->segment_index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+      my->segment_blocks = segment_blocks;
+      my->retained_segments = retained_segments;
       open(data_dir);
    }
 
@@ -100,8 +364,12 @@ namespace snax { namespace chain {
 
       if (!fc::is_directory(data_dir))
          fc::create_directories(data_dir);
+      my->data_dir = data_dir;
       my->block_file = data_dir / "blocks.log";
       my->index_file = data_dir / "blocks.index";
+      if (my->reader)
+         my->reader->reset(); // the files may be rebuilt below, whoever still holds the old reader is served no more
+      my->reader = std::make_shared<block_log_reader>(data_dir);
 
       //ilog("Opening block log at ${path}", ("path", my->block_file.generic_string()));
       my->block_stream.open(my->block_file.generic_string().c_str(), LOG_WRITE);
@@ -130,6 +398,26 @@ namespace snax { namespace chain {
       auto log_size = fc::file_size(my->block_file);
       auto index_size = fc::file_size(my->index_file);
 
+      uint32_t log_version = 0;
+      if (log_size >= sizeof(log_version)) {
+         my->check_block_read();
+         my->block_stream.seekg( 0 );
+         my->block_stream.read( (char*)&log_version, sizeof(log_version) );
+      }
+      // rolling into a segment renames blocks.log before the next one is written, a crash in between
+      // leaves it missing, empty or without its version while the segments hold all the blocks
+      if (log_version == 0) {
+         my->first_block_num = 0;
+         my->scan_segments();
+         if (!my->segments.empty()) {
+            const auto& last = my->segments.rbegin()->second;
+            ilog("Block log is not set up, restarting it after segment ${f} to ${l}", ("f", last.first_block_num)("l", last.last_block_num));
+            reset_active( detail::read_genesis_state( last.block_file ), signed_block_ptr(), last.last_block_num + 1 );
+            log_size = fc::file_size(my->block_file);
+            index_size = 0;
+         }
+      }
+
       if (log_size) {
          ilog("Log is nonempty");
          my->check_block_read();
@@ -151,10 +439,16 @@ namespace snax { namespace chain {
             my->first_block_num = 1;
          }
 
+         my->scan_segments();
+         my->prune_segments();
+
          my->head = read_head();
-         my->head_id = my->head->id();
+         if (my->head)
+            my->head_id = my->head->id();
 
-         if (index_size) {
+         if (!my->head || my->head->block_num() < my->first_block_num) {
+            // no blocks in the active log yet, its index is empty
+         } else if (index_size) {
             my->check_block_read();
             my->check_index_read();
 
@@ -185,12 +479,18 @@ namespace snax { namespace chain {
          my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
          my->index_write = true;
       }
+
+      flush();
+      my->publish();
    }
 
    uint64_t block_log::append(const signed_block_ptr& b) {
       try {
          SNAX_ASSERT( my->genesis_written_to_block_log, block_log_append_fail, "Cannot append to block log until the genesis is first written" );
 
+         if (my->segment_blocks && my->head && b->block_num() >= my->first_block_num + my->segment_blocks)
+            roll_segment();
+
          my->check_block_write();
          my->check_index_write();
 
@@ -208,6 +508,7 @@ namespace snax { namespace chain {
          my->head_id = b->id();
 
          flush();
+         my->publish();
 
          return pos;
       }
@@ -220,6 +521,41 @@ namespace snax { namespace chain {
    }
 
    void block_log::reset( const genesis_state& gs, const signed_block_ptr& first_block, uint32_t first_block_num ) {
+      my->close_segment();
+      for (const auto& seg : my->segments) {
+         fc::remove(seg.second.block_file);
+         fc::remove(seg.second.index_file);
+      }
+      my->segments.clear();
+      reset_active(gs, first_block, first_block_num);
+   }
+
+   void block_log::roll_segment() {
+      auto gs = extract_genesis_state(my->data_dir);
+
+      detail::block_log_segment seg;
+      seg.first_block_num = my->first_block_num;
+      seg.last_block_num = block_header::num_from_id(my->head_id);
+      seg.block_file = my->segment_file(seg.first_block_num, seg.last_block_num, ".log");
+      seg.index_file = my->segment_file(seg.first_block_num, seg.last_block_num, ".index");
+
+      flush();
+      my->block_stream.close();
+      my->index_stream.close();
+      my->reader->reset(); // before the files move away from the paths a remap opens
+      fc::rename(my->block_file, seg.block_file);
+      fc::rename(my->index_file, seg.index_file);
+      my->segments[seg.first_block_num] = seg;
+      ilog("Moved blocks ${f} to ${l} of the block log into segment ${p}",
+           ("f", seg.first_block_num)("l", seg.last_block_num)("p", seg.block_file.generic_string()));
+
+      reset_active(gs, signed_block_ptr(), seg.last_block_num + 1);
+      my->prune_segments();
+   }
+
+   void block_log::reset_active( const genesis_state& gs, const signed_block_ptr& first_block, uint32_t first_block_num ) {
+      my->reader->reset();
+
       if (my->block_stream.is_open())
          my->block_stream.close();
       if (my->index_stream.is_open())
@@ -282,6 +618,11 @@ namespace snax { namespace chain {
          uint64_t pos = get_block_pos(block_num);
          if (pos != npos) {
             b = read_block(pos).first;
+         } else if (auto stream = my->seek_segment_block(block_num)) {
+            b = std::make_shared<signed_block>();
+            fc::raw::unpack(*stream, *b);
+         }
+         if (b) {
             SNAX_ASSERT(b->block_num() == block_num, reversible_blocks_exception,
                       "Wrong block was read from block log.", ("returned", b->block_num())("expected", block_num));
          }
@@ -289,6 +630,66 @@ namespace snax { namespace chain {
       } FC_LOG_AND_RETHROW()
    }
 
+   signed_block_header block_log::read_block_header(uint64_t pos)const {
+      my->check_block_read();
+
+      my->block_stream.seekg(pos);
+      signed_block_header result;
+      fc::raw::unpack(my->block_stream, result);
+      return result;
+   }
+
+   optional<signed_block_header> block_log::read_block_header_by_num(uint32_t block_num)const {
+      try {
+         optional<signed_block_header> h;
+         uint64_t pos = get_block_pos(block_num);
+         if (pos != npos) {
+            h = read_block_header(pos);
+         } else if (auto stream = my->seek_segment_block(block_num)) {
+            h = signed_block_header();
+            fc::raw::unpack(*stream, *h);
+         }
+         if (h) {
+            SNAX_ASSERT(h->block_num() == block_num, block_log_exception,
+                      "Wrong block header was read from block log.", ("returned", h->block_num())("expected", block_num));
+         }
+         return h;
+      } FC_LOG_AND_RETHROW()
+   }
+
+   vector<signed_block_header> block_log::read_block_headers_by_num(uint32_t block_num, uint32_t count)const {
+      try {
+         vector<signed_block_header> headers;
+
+         // blocks of completed segments are read one by one
+         for (; count > 0 && block_num < my->first_block_num; ++block_num, --count) {
+            auto h = read_block_header_by_num(block_num);
+            if (!h)
+               return headers;
+            headers.emplace_back(std::move(*h));
+         }
+
+         if (count == 0 || get_block_pos(block_num) == npos)
+            return headers;
+         count = std::min(count, block_header::num_from_id(my->head_id) - block_num + 1);
+
+         vector<uint64_t> positions(count);
+         my->check_index_read();
+         my->index_stream.seekg(sizeof(uint64_t) * (block_num - my->first_block_num));
+         my->index_stream.read((char*)positions.data(), sizeof(uint64_t) * count);
+
+         headers.reserve(headers.size() + count);
+         for (auto pos : positions) {
+            headers.emplace_back(read_block_header(pos));
+            SNAX_ASSERT(headers.back().block_num() == block_num, block_log_exception,
+                      "Wrong block header was read from block log.",
+                      ("returned", headers.back().block_num())("expected", block_num));
+            ++block_num;
+         }
+         return headers;
+      } FC_LOG_AND_RETHROW()
+   }
+
    uint64_t block_log::get_block_pos(uint32_t block_num) const {
       my->check_index_read();
       if (!(my->head && block_num <= block_header::num_from_id(my->head_id) && block_num >= my->first_block_num))
@@ -300,6 +701,13 @@ namespace snax { namespace chain {
    }
 
    signed_block_ptr block_log::read_head()const {
+      auto head = read_active_head();
+      if (!head && !my->segments.empty())
+         head = read_block_by_num(my->segments.rbegin()->second.last_block_num);
+      return head;
+   }
+
+   signed_block_ptr block_log::read_active_head()const {
       my->check_block_read();
 
       uint64_t pos;
@@ -323,45 +731,29 @@ namespace snax { namespace chain {
    }
 
    uint32_t block_log::first_block_num() const {
+      if (!my->segments.empty())
+         return my->segments.begin()->first;
       return my->first_block_num;
    }
 
+   vector<std::pair<uint32_t, uint32_t>> block_log::segment_ranges() const {
+      vector<std::pair<uint32_t, uint32_t>> ranges;
+      for (const auto& seg : my->segments)
+         ranges.emplace_back(seg.second.first_block_num, seg.second.last_block_num);
+      return ranges;
+   }
+
+   std::shared_ptr<const block_log_reader> block_log::get_reader() const {
+      return my->reader;
+   }
+
    void block_log::construct_index() {
       ilog("Reconstructing Block Log Index...");
       my->index_stream.close();
-      fc::remove_all(my->index_file);
+      flush();
+      construct_index(my->block_file, my->index_file);
       my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
       my->index_write = true;
-
-      uint64_t end_pos;
-      my->check_block_read();
-
-      my->block_stream.seekg(-sizeof( uint64_t), std::ios::end);
-      my->block_stream.read((char*)&end_pos, sizeof(end_pos));
-      signed_block tmp;
-
-      uint64_t pos = 0;
-      if (my->version == 1) {
-         pos = 4; // Skip version which should have already been checked.
-      } else {
-         pos = 8; // Skip version and first block offset which should have already been checked
-      }
-      my->block_stream.seekg(pos);
-
-      genesis_state gs;
-      fc::raw::unpack(my->block_stream, gs);
-
-      // skip the totem
-      if (my->version > 1) {
-         uint64_t totem;
-         my->block_stream.read((char*) &totem, sizeof(totem));
-      }
-
-      while( pos < end_pos ) {
-         fc::raw::unpack(my->block_stream, tmp);
-         my->block_stream.read((char*)&pos, sizeof(pos));
-         my->index_stream.write((char*)&pos, sizeof(pos));
-      }
    } // construct_index
 
    fc::path block_log::repair_log( const fc::path& data_dir, uint32_t truncate_at_block ) {
@@ -390,6 +782,17 @@ namespace snax { namespace chain {
       fc::create_directories(blocks_dir);
       auto block_log_path = blocks_dir / "blocks.log";
 
+      // completed segments of a segmented log are never written again, only the active log is recovered
+      for (boost::filesystem::directory_iterator itr(backup_dir), end; itr != end; ++itr) {
+         uint32_t first = 0, last = 0;
+         auto name = itr->path().filename().generic_string();
+         if (sscanf(name.c_str(), "blocks-%10u-%10u", &first, &last) == 2) {
+            if (truncate_at_block && truncate_at_block <= last)
+               wlog( "Block log segment ${f} to ${l} is kept whole, truncating only applies to blocks.log", ("f", first)("l", last) );
+            fc::rename( itr->path(), blocks_dir / name );
+         }
+      }
+
       ilog( "Reconstructing '${new_block_log}' from backed up block log", ("new_block_log", block_log_path) );
 
       std::fstream  old_block_stream;
@@ -528,9 +931,12 @@ namespace snax { namespace chain {
    genesis_state block_log::extract_genesis_state( const fc::path& data_dir ) {
       SNAX_ASSERT( fc::is_directory(data_dir) && fc::is_regular_file(data_dir / "blocks.log"), block_log_not_found,
                  "Block log not found in '${blocks_dir}'", ("blocks_dir", data_dir)          );
+      return detail::read_genesis_state( data_dir / "blocks.log" );
+   }
 
+   genesis_state detail::read_genesis_state( const fc::path& block_file ) {
       std::fstream  block_stream;
-      block_stream.open( (data_dir / "blocks.log").generic_string().c_str(), LOG_READ );
+      block_stream.open( block_file.generic_string().c_str(), LOG_READ );
 
       uint32_t version = 0;
       block_stream.read( (char*)&version, sizeof(version) );
@@ -0,0 +1,194 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#include <snax/chain/block_log_reader.hpp>
+#include <snax/chain/block_log.hpp>
+#include <snax/chain/exceptions.hpp>
+#include <fc/io/raw.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace snax { namespace chain {
+
+   namespace detail {
+      namespace bip = boost::interprocess;
+
+      /// what the writer published last, a read uses one of these throughout
+      struct block_log_published {
+         uint64_t   generation = 0;
+         uint32_t   first_block_num = 0;
+         uint32_t   head_block_num = 0;   ///< 0 while no block is published
+         uint64_t   log_size = 0;   ///< of blocks.log
+      };
+
+      /// the files mapped with a reserve past their size at the time, which the blocks appended later fill in
+      struct block_log_mapping {
+         static const uint64_t block_reserve = 64*1024*1024;
+         static const uint64_t index_reserve = 512*1024;   ///< 65536 blocks
+
+         block_log_mapping( const fc::path& block_file, const fc::path& index_file, uint64_t generation, uint32_t first, uint32_t head )
+         :block_mapping( block_file.generic_string().c_str(), bip::read_only ),
+          index_mapping( index_file.generic_string().c_str(), bip::read_only ),
+          blocks( block_mapping, bip::read_only, 0, fc::file_size( block_file ) + block_reserve ),
+          index( index_mapping, bip::read_only, 0, fc::file_size( index_file ) + index_reserve ),
+          generation( generation ),
+          first_block_num( first )
+         {
+            SNAX_ASSERT( fc::file_size( index_file ) >= sizeof(uint64_t) * (head - first + 1), block_log_exception,
+                         "Block log index is shorter than the published head ${h}", ("h", head) );
+         }
+
+         /// only valid for published blocks, their index entries are in the file
+         bool covers( uint32_t block_num )const {
+            return block_num >= first_block_num &&
+                   sizeof(uint64_t) * (uint64_t(block_num - first_block_num) + 1) <= index.get_size() &&
+                   block_pos( block_num ) < blocks.get_size();
+         }
+
+         uint64_t block_pos( uint32_t block_num )const {
+            uint64_t pos;
+            memcpy( &pos, static_cast<const char*>(index.get_address()) + sizeof(uint64_t) * (block_num - first_block_num), sizeof(pos) );
+            return pos;
+         }
+
+         /// the pages of the reserve past the end of blocks.log must never be touched, `log_size` bounds the stream
+         fc::datastream<const char*> block_stream( uint32_t block_num, uint64_t log_size )const {
+            auto pos = block_pos( block_num );
+            auto end = std::min<uint64_t>( blocks.get_size(), log_size );
+            SNAX_ASSERT( pos < end, block_log_exception,
+                         "Block log index points past the end of the log for block ${n}", ("n", block_num) );
+            return fc::datastream<const char*>( static_cast<const char*>(blocks.get_address()) + pos, end - pos );
+         }
+
+         bip::file_mapping   block_mapping;
+         bip::file_mapping   index_mapping;
+         bip::mapped_region  blocks;
+         bip::mapped_region  index;
+         uint64_t            generation;
+         uint32_t            first_block_num;
+      };
+   }
+
+   block_log_reader::block_log_reader(const fc::path& data_dir)
+   :block_file(data_dir / "blocks.log"),
+    index_file(data_dir / "blocks.index"),
+    published(std::make_shared<detail::block_log_published>()) {
+   }
+
+   block_log_reader::~block_log_reader() {
+   }
+
+   void block_log_reader::publish(uint32_t first_block_num, uint32_t head_block_num, uint64_t log_size) {
+      auto state = std::make_shared<detail::block_log_published>();
+      {
+         std::lock_guard<std::mutex> g( remap_mutex );
+         state->generation = generation;
+      }
+      state->first_block_num = first_block_num;
+      state->head_block_num = head_block_num;
+      state->log_size = log_size;
+      std::atomic_store( &published, published_ptr( std::move(state) ) );
+   }
+
+   void block_log_reader::reset() {
+      // waits for a remap under way, which maps the files as they are still
+      std::lock_guard<std::mutex> g( remap_mutex );
+      auto state = std::make_shared<detail::block_log_published>();
+      state->generation = ++generation;
+      std::atomic_store( &published, published_ptr( std::move(state) ) );
+      std::atomic_store( &current, mapping_ptr() );
+   }
+
+   uint32_t block_log_reader::first_block_num()const {
+      return std::atomic_load( &published )->first_block_num;
+   }
+
+   uint32_t block_log_reader::head_block_num()const {
+      return std::atomic_load( &published )->head_block_num;
+   }
+
+   std::pair<block_log_reader::mapping_ptr, block_log_reader::published_ptr> block_log_reader::mapping_for(uint32_t block_num)const {
+      while( true ) {
+         auto state = std::atomic_load( &published );
+         if( state->head_block_num == 0 || block_num < state->first_block_num || block_num > state->head_block_num )
+            return {};
+
+         auto m = std::atomic_load( &current );
+         if( m && m->generation == state->generation && m->first_block_num == state->first_block_num && m->covers( block_num ) )
+            return { m, state };
+         if( auto fresh = remap( *state, state->head_block_num ) )
+            return { fresh, state };
+         // the files were replaced meanwhile, look again with what is published now
+      }
+   }
+
+   block_log_reader::mapping_ptr block_log_reader::remap(const detail::block_log_published& state, uint32_t head_block_num)const {
+      std::lock_guard<std::mutex> g( remap_mutex );
+      if( state.generation != generation )
+         return {};
+
+      // the files hold at least everything up to `head_block_num` by now
+      mapping_ptr fresh = std::make_shared<detail::block_log_mapping>( block_file, index_file, state.generation,
+                                                                      state.first_block_num, head_block_num );
+      // another reader may have remapped first, keep whichever maps more
+      auto m = std::atomic_load( &current );
+      if( !m || m->generation != fresh->generation || m->first_block_num != fresh->first_block_num ||
+          m->blocks.get_size() < fresh->blocks.get_size() )
+         std::atomic_store( &current, fresh );
+      return fresh;
+   }
+
+   template<typename T>
+   bool block_log_reader::unpack_block(uint32_t block_num, T& value)const {
+      auto found = mapping_for( block_num );
+      auto& m = found.first;
+      if( !m )
+         return false;
+      // the size published along with the head, the mapping covers at least the blocks up to it
+      const auto log_size = found.second->log_size;
+      try {
+         auto ds = m->block_stream( block_num, log_size );
+         fc::raw::unpack( ds, value );
+      } catch( const fc::out_of_range_exception& ) {
+         if( m->blocks.get_size() >= log_size )
+            throw;
+         // the block runs past the reserve of the mapping
+         value = T();
+         m = remap( *found.second, block_num );
+         if( !m )
+            return unpack_block( block_num, value );   // the files were replaced meanwhile
+         auto ds = m->block_stream( block_num, log_size );
+         fc::raw::unpack( ds, value );
+      }
+      return true;
+   }
+
+   uint64_t block_log_reader::get_block_pos(uint32_t block_num)const {
+      auto m = mapping_for( block_num ).first;
+      return m ? m->block_pos( block_num ) : block_log::npos;
+   }
+
+   signed_block_ptr block_log_reader::read_block_by_num(uint32_t block_num)const {
+      try {
+         auto b = std::make_shared<signed_block>();
+         if( !unpack_block( block_num, *b ) )
+            return signed_block_ptr();
+         SNAX_ASSERT(b->block_num() == block_num, block_log_exception,
+                   "Wrong block was read from block log.", ("returned", b->block_num())("expected", block_num));
+         return b;
+      } FC_LOG_AND_RETHROW()
+   }
+
+   optional<signed_block_header> block_log_reader::read_block_header_by_num(uint32_t block_num)const {
+      try {
+         signed_block_header h;
+         if( !unpack_block( block_num, h ) )
+            return optional<signed_block_header>();
+         SNAX_ASSERT(h.block_num() == block_num, block_log_exception,
+                   "Wrong block header was read from block log.", ("returned", h.block_num())("expected", block_num));
+         return h;
+      } FC_LOG_AND_RETHROW()
+   }
+
+} } /// snax::chain
@@ -0,0 +1,135 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#include <snax/chain/block_slot_index.hpp>
+#include <snax/chain/mapped_file.hpp>
+#include <snax/chain/exceptions.hpp>
+
+namespace snax { namespace chain {
+
+   /**
+    * History:
+    * Version 1: one uint32_t block number per slot
+    */
+   const uint32_t block_slot_index::supported_version = 1;
+
+   namespace detail {
+      struct block_slot_index_header {
+         uint32_t version = 0;
+         uint32_t head_block_num = 0;
+         uint32_t first_slot = 0;
+         uint32_t head_slot = 0;   ///< 0 when the index is empty
+      };
+
+      class block_slot_index_impl {
+         public:
+            mapped_file   index_file;
+
+            // the mapping moves when the file grows, never hold on to the returned reference across a write
+            block_slot_index_header& header()const {
+               return *reinterpret_cast<block_slot_index_header*>( index_file.data() );
+            }
+
+            uint64_t entry_pos( uint32_t slot )const {
+               return sizeof(block_slot_index_header) + uint64_t(slot - header().first_slot) * sizeof(uint32_t);
+            }
+      };
+   }
+
+   block_slot_index::block_slot_index(const fc::path& data_dir)
+   :my(new detail::block_slot_index_impl()) {
+      open(data_dir);
+   }
+
+   block_slot_index::block_slot_index(block_slot_index&& other) {
+      my = std::move(other.my);
+   }
+
+   block_slot_index::~block_slot_index() {
+      if (my) {
+         flush();
+         my.reset();
+      }
+   }
+
+   void block_slot_index::open(const fc::path& data_dir) {
+      if (!fc::is_directory(data_dir))
+         fc::create_directories(data_dir);
+
+      my->index_file.open( data_dir / "blocks.slots" );
+
+      const auto& h = my->header();
+      if( h.version != supported_version ) {
+         if( h.version != 0 )
+            ilog( "block slot index has unsupported version ${v}, discarding it", ("v", h.version) );
+         reset();
+      } else if( !empty() && ( h.head_slot < h.first_slot || my->index_file.size() < my->entry_pos( h.head_slot + 1 ) ) ) {
+         wlog( "block slot index is inconsistent with its file, discarding it" );
+         reset();
+      }
+   }
+
+   void block_slot_index::append(uint32_t slot, uint32_t block_num) {
+      try {
+         SNAX_ASSERT( slot > 0, block_log_append_fail, "block slot index can't hold slot 0" );
+         if( empty() ) {
+            my->header().first_slot = slot;
+         } else {
+            SNAX_ASSERT( slot > head_slot() && block_num == head_block_num() + 1, block_log_append_fail,
+                         "Append to block slot index out of order, block ${n} in slot ${s} after block ${hn} in slot ${hs}",
+                         ("n", block_num)("s", slot)("hn", head_block_num())("hs", head_slot()) );
+         }
+
+         // entries of missed slots are still zero, the file is only ever grown with zeros
+         auto pos = my->entry_pos( slot );
+         memcpy( my->index_file.reserve( pos + sizeof(uint32_t) ) + pos, &block_num, sizeof(uint32_t) );
+
+         auto& h = my->header();
+         h.head_block_num = block_num;
+         h.head_slot = slot;
+      }
+      FC_LOG_AND_RETHROW()
+   }
+
+   void block_slot_index::flush() {
+      my->index_file.flush();
+   }
+
+   void block_slot_index::reset() {
+      auto& h = my->header();
+      // entries past the head must read as missed slots once the index is refilled
+      memset( my->index_file.data() + sizeof(detail::block_slot_index_header), 0,
+              my->index_file.size() - sizeof(detail::block_slot_index_header) );
+      h.version = supported_version;
+      h.head_block_num = 0;
+      h.first_slot = 0;
+      h.head_slot = 0;
+      flush();
+   }
+
+   uint32_t block_slot_index::block_num_for_slot(uint32_t slot)const {
+      if( empty() || slot < first_slot() || slot > head_slot() )
+         return 0;
+      uint32_t block_num = 0;
+      memcpy( &block_num, my->index_file.data() + my->entry_pos( slot ), sizeof(uint32_t) );
+      return block_num;
+   }
+
+   bool block_slot_index::empty()const {
+      return my->header().head_slot == 0;
+   }
+
+   uint32_t block_slot_index::first_slot()const {
+      return my->header().first_slot;
+   }
+
+   uint32_t block_slot_index::head_slot()const {
+      return my->header().head_slot;
+   }
+
+   uint32_t block_slot_index::head_block_num()const {
+      return my->header().head_block_num;
+   }
+
+} } /// snax::chain
@@ -0,0 +1,199 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#include <snax/chain/blockroot_merkle_log.hpp>
+#include <snax/chain/mapped_file.hpp>
+#include <snax/chain/exceptions.hpp>
+
+namespace snax { namespace chain {
+
+   /**
+    * History:
+    * Version 1: fixed size checkpoint slots every `stride` blocks plus a dense id file
+    */
+   const uint32_t blockroot_merkle_log::supported_version = 1;
+
+   namespace detail {
+      struct blockroot_merkle_log_header {
+         uint32_t version = 0;
+         uint32_t stride = 0;
+         uint32_t first_block_num = 0;
+         uint32_t head_block_num = 0;   ///< 0 when the log is empty
+      };
+
+      struct blockroot_merkle_slot {
+         uint64_t node_count = 0;
+         uint32_t active_count = 0;
+         uint32_t reserved = 0;
+         char     active_nodes[blockroot_merkle_log::max_active_nodes][sizeof(digest_type)];
+      };
+
+      class blockroot_merkle_log_impl {
+         public:
+            mapped_file   index_file;
+            mapped_file   ids_file;
+            uint32_t      stride = 0;
+
+            // the mapping moves when a file grows, never hold on to the returned reference across a write
+            blockroot_merkle_log_header& header()const {
+               return *reinterpret_cast<blockroot_merkle_log_header*>( index_file.data() );
+            }
+
+            static uint64_t slot_pos( uint32_t slot ) {
+               return sizeof(blockroot_merkle_log_header) + uint64_t(slot) * sizeof(blockroot_merkle_slot);
+            }
+
+            uint64_t id_pos( uint32_t block_num )const {
+               return uint64_t(block_num - header().first_block_num) * sizeof(block_id_type);
+            }
+
+            void write_slot( uint32_t slot, const incremental_merkle& merkle ) {
+               SNAX_ASSERT( merkle._active_nodes.size() <= blockroot_merkle_log::max_active_nodes, block_log_append_fail,
+                            "blockroot merkle has too many active nodes", ("nodes", merkle._active_nodes.size()) );
+               auto pos = slot_pos( slot );
+               auto& s = *reinterpret_cast<blockroot_merkle_slot*>( index_file.reserve( pos + sizeof(blockroot_merkle_slot) ) + pos );
+               s.node_count = merkle._node_count;
+               s.active_count = merkle._active_nodes.size();
+               for( uint32_t i = 0; i < s.active_count; ++i )
+                  memcpy( s.active_nodes[i], merkle._active_nodes[i].data(), sizeof(digest_type) );
+            }
+
+            incremental_merkle read_slot( uint32_t slot )const {
+               const auto& s = *reinterpret_cast<const blockroot_merkle_slot*>( index_file.data() + slot_pos( slot ) );
+               incremental_merkle merkle;
+               merkle._node_count = s.node_count;
+               merkle._active_nodes.resize( s.active_count );
+               for( uint32_t i = 0; i < s.active_count; ++i )
+                  memcpy( merkle._active_nodes[i].data(), s.active_nodes[i], sizeof(digest_type) );
+               return merkle;
+            }
+
+            void write_id( uint32_t block_num, const block_id_type& id ) {
+               auto pos = id_pos( block_num );
+               memcpy( ids_file.reserve( pos + sizeof(block_id_type) ) + pos, id.data(), sizeof(block_id_type) );
+            }
+
+            block_id_type read_id( uint32_t block_num )const {
+               block_id_type id;
+               memcpy( id.data(), ids_file.data() + id_pos( block_num ), sizeof(block_id_type) );
+               return id;
+            }
+      };
+   }
+
+   blockroot_merkle_log::blockroot_merkle_log(const fc::path& data_dir, uint32_t stride)
+   :my(new detail::blockroot_merkle_log_impl()) {
+      SNAX_ASSERT( stride > 0, block_log_exception, "blockroot merkle log stride must be positive" );
+      my->stride = stride;
+      open(data_dir);
+   }
+
+   blockroot_merkle_log::blockroot_merkle_log(blockroot_merkle_log&& other) {
+      my = std::move(other.my);
+   }
+
+   blockroot_merkle_log::~blockroot_merkle_log() {
+      if (my) {
+         flush();
+         my.reset();
+      }
+   }
+
+   void blockroot_merkle_log::open(const fc::path& data_dir) {
+      if (!fc::is_directory(data_dir))
+         fc::create_directories(data_dir);
+
+      my->index_file.open( data_dir / "blockroot_merkle.index" );
+      my->ids_file.open( data_dir / "blockroot_merkle.ids" );
+
+      const auto& h = my->header();
+      if( h.version != supported_version || h.stride != my->stride ) {
+         if( h.version != 0 ) {
+            ilog( "blockroot merkle log has version ${v} and stride ${s}, expected version ${ev} and stride ${es}, discarding it",
+                  ("v", h.version)("s", h.stride)("ev", supported_version)("es", my->stride) );
+         }
+         reset();
+         return;
+      }
+
+      if( empty() )
+         return;
+
+      // the head is only advanced after its data is written, but make sure both files still cover it
+      if( h.head_block_num < h.first_block_num
+          || my->index_file.size() < detail::blockroot_merkle_log_impl::slot_pos( (h.head_block_num - h.first_block_num) / my->stride + 1 )
+          || my->ids_file.size() < my->id_pos( h.head_block_num + 1 ) ) {
+         wlog( "blockroot merkle log is inconsistent with its files, discarding it" );
+         reset();
+      }
+   }
+
+   void blockroot_merkle_log::append(uint32_t block_num, const block_id_type& id, const incremental_merkle& merkle) {
+      try {
+         if( empty() ) {
+            my->header().first_block_num = block_num;
+         } else {
+            SNAX_ASSERT( block_num == head_block_num() + 1, block_log_append_fail,
+                         "Append to blockroot merkle log out of order, expected block ${e}, got block ${n}",
+                         ("e", head_block_num() + 1)("n", block_num) );
+         }
+
+         uint32_t offset = block_num - first_block_num();
+         if( offset % my->stride == 0 )
+            my->write_slot( offset / my->stride, merkle );
+         my->write_id( block_num, id );
+
+         my->header().head_block_num = block_num;
+      }
+      FC_LOG_AND_RETHROW()
+   }
+
+   void blockroot_merkle_log::flush() {
+      my->ids_file.flush();
+      my->index_file.flush();
+   }
+
+   void blockroot_merkle_log::reset() {
+      auto& h = my->header();
+      h.version = supported_version;
+      h.stride = my->stride;
+      h.first_block_num = 0;
+      h.head_block_num = 0;
+      flush();
+   }
+
+   optional<incremental_merkle> blockroot_merkle_log::read_merkle_by_num(uint32_t block_num)const {
+      if( empty() || block_num < first_block_num() || block_num > head_block_num() )
+         return optional<incremental_merkle>();
+
+      uint32_t slot = (block_num - first_block_num()) / my->stride;
+      auto merkle = my->read_slot( slot );
+      for( uint32_t n = first_block_num() + slot * my->stride; n < block_num; ++n )
+         merkle.append( my->read_id( n ) );
+      return merkle;
+   }
+
+   optional<block_id_type> blockroot_merkle_log::read_id_by_num(uint32_t block_num)const {
+      if( empty() || block_num < first_block_num() || block_num > head_block_num() )
+         return optional<block_id_type>();
+      return my->read_id( block_num );
+   }
+
+   bool blockroot_merkle_log::empty()const {
+      return my->header().head_block_num == 0;
+   }
+
+   uint32_t blockroot_merkle_log::first_block_num()const {
+      return my->header().first_block_num;
+   }
+
+   uint32_t blockroot_merkle_log::head_block_num()const {
+      return my->header().head_block_num;
+   }
+
+   uint32_t blockroot_merkle_log::stride()const {
+      return my->stride;
+   }
+
+} } /// snax::chain
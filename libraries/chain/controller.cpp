@@ -2,6 +2,8 @@
 #include <snax/chain/transaction_context.hpp>
 
 #include <snax/chain/block_log.hpp>
+#include <snax/chain/block_slot_index.hpp>
+#include <snax/chain/blockroot_merkle_log.hpp>
 #include <snax/chain/fork_database.hpp>
 #include <snax/chain/exceptions.hpp>
 
@@ -57,52 +59,70 @@ public:
    maybe_session() = default;
 
    maybe_session(maybe_session &&other)
-       : _session(move(other._session))
+       : _session(move(other._session)), _authorization(other._authorization), _auth_revision(other._auth_revision)
    {
+      other._session.reset();
    }
 
-   explicit maybe_session(database &db)
+   explicit maybe_session(database &db, authorization_manager &authorization)
+       : _authorization(&authorization), _auth_revision(authorization.revision())
    {
       _session = db.start_undo_session(true);
    }
 
    maybe_session(const maybe_session &) = delete;
 
+   ~maybe_session()
+   {
+      undo(); // what the session would do on destruction, also letting the authorization cache know
+   }
+
    void squash()
    {
       if (_session)
+      {
          _session->squash();
+         _session.reset();
+      }
    }
 
    void undo()
    {
       if (_session)
+      {
          _session->undo();
+         _session.reset();
+         _authorization->undone(_auth_revision);
+      }
    }
 
    void push()
    {
       if (_session)
+      {
          _session->push();
+         _session.reset();
+      }
    }
 
    maybe_session &operator=(maybe_session &&mv)
    {
+      undo();
       if (mv._session)
       {
          _session = move(*mv._session);
          mv._session.reset();
       }
-      else
-      {
-         _session.reset();
-      }
+      _authorization = mv._authorization;
+      _auth_revision = mv._auth_revision;
 
       return *this;
    };
 
 private:
    optional<database::session> _session;
+   authorization_manager *_authorization = nullptr;
+   uint64_t _auth_revision = 0; ///< authorization revision when the session started
 };
 
 struct pending_state
@@ -126,12 +146,26 @@ struct pending_state
    }
 };
 
+/**
+ * A block read ahead of the one being replayed. Its transactions are unpacked with their signing keys
+ * recovered, and its block state is built on top of the one of the block before it, on the thread pool.
+ */
+struct replay_block
+{
+   signed_block_ptr block;
+   std::vector<std::future<transaction_metadata_ptr>> transactions;
+   std::shared_future<block_state_ptr> state;
+   uint64_t size = 0;
+};
+
 struct controller_impl
 {
    controller &self;
    chainbase::database db;
    chainbase::database reversible_blocks; ///< a special database to persist blocks that have successfully been applied but are still reversible
    block_log blog;
+   block_slot_index slot_index;
+   blockroot_merkle_log blockroot_merkle_index;
    optional<pending_state> pending;
    block_state_ptr head;
    fork_database fork_db;
@@ -149,6 +183,12 @@ struct controller_impl
    uint32_t snapshot_head_block = 0;
    optional<boost::asio::thread_pool> thread_pool;
 
+   /// blocks up to this one are replayed from the block log without key recovery and authorization
+   uint32_t trusted_replay_block_num = 0;
+
+   /// transactions of the block being replayed, prepared by the replay read ahead for apply_block
+   optional<pair<signed_block_ptr, std::vector<std::future<transaction_metadata_ptr>>>> replay_transactions;
+
    typedef pair<scope_name, action_name> handler_key;
    map<account_name, map<handler_key, apply_handler>> apply_handlers;
 
@@ -186,6 +226,7 @@ struct controller_impl
       }
       head = prev;
       db.undo();
+      authorization.clear_cache();
    }
 
    void set_apply_handler(account_name receiver, account_name contract, action_name action, apply_handler v)
@@ -201,9 +242,12 @@ struct controller_impl
          reversible_blocks(cfg.blocks_dir / config::reversible_blocks_dir_name,
                            cfg.read_only ? database::read_only : database::read_write,
                            cfg.reversible_cache_size),
-         blog(cfg.blocks_dir),
+         blog(cfg.blocks_dir, cfg.blocks_log_segment_size, cfg.blocks_log_retained_segments),
+         slot_index(cfg.blocks_dir),
+         blockroot_merkle_index(cfg.blocks_dir, cfg.blockroot_merkle_stride),
          fork_db(cfg.state_dir),
-         wasmif(cfg.wasm_runtime),
+         wasmif(cfg.wasm_runtime, cfg.persistent_code_cache ? cfg.state_dir / config::code_cache_dir_name : path(),
+                cfg.wasm_cache_size, cfg.wasm_cache_pinned_accounts),
          resource_limits(db),
          authorization(s, db),
          conf(cfg),
@@ -305,12 +349,9 @@ struct controller_impl
 
       if (append_to_blog)
       {
-         block_state bs = *s;
-         if (bs.block_num % 64 == 0)
-         {
-            bs.block->block_extensions.emplace_back(std::make_pair(0xF, fc::raw::pack(bs.blockroot_merkle))); // used by ibc_plugin
-         }
          blog.append(s->block);
+         append_block_slot(*s);
+         append_blockroot_merkle(*s);
       }
 
       const auto &ubi = reversible_blocks.get_index<reversible_block_index, by_num>();
@@ -349,6 +390,144 @@ struct controller_impl
       }
    }
 
+   /**
+    *  Bring the slot index up to the head of the block log, resuming from its head when it
+    *  still matches the log and rebuilding it from the block headers otherwise.
+    */
+   void sync_slot_index()
+   {
+      auto log_head = blog.read_head();
+      if (!log_head)
+      {
+         if (!slot_index.empty())
+            slot_index.reset();
+         return;
+      }
+
+      uint32_t next_num = blog.first_block_num();
+      if (!slot_index.empty())
+      {
+         auto h = blog.read_block_header_by_num(slot_index.head_block_num());
+         if (h && h->timestamp.slot == slot_index.head_slot())
+         {
+            next_num = slot_index.head_block_num() + 1;
+         }
+         else
+         {
+            wlog("block slot index doesn't match the block log, rebuilding it");
+            slot_index.reset();
+         }
+      }
+
+      if (next_num <= log_head->block_num())
+         ilog("indexing block slots of blocks ${from} to ${to}", ("from", next_num)("to", log_head->block_num()));
+      while (next_num <= log_head->block_num())
+      {
+         auto headers = blog.read_block_headers_by_num(next_num, 10000);
+         if (headers.empty())
+            break;
+         for (const auto &h : headers)
+            slot_index.append(h.timestamp.slot, h.block_num());
+         next_num += headers.size();
+      }
+      slot_index.flush();
+   }
+
+   void append_block_slot(const block_header_state &s)
+   {
+      // anything but the next block is a gap, refill the index from the block log which already holds s
+      if (slot_index.empty() ? s.block_num != blog.first_block_num() : s.block_num != slot_index.head_block_num() + 1)
+      {
+         wlog("block slot index head ${h} is not followed by irreversible block ${n}, syncing it with the block log",
+              ("h", slot_index.head_block_num())("n", s.block_num));
+         sync_slot_index();
+         return;
+      }
+      slot_index.append(s.header.timestamp.slot, s.block_num);
+   }
+
+   void append_blockroot_merkle(const block_header_state &s)
+   {
+      if (!blockroot_merkle_index.empty() && s.block_num != blockroot_merkle_index.head_block_num() + 1)
+      {
+         // the block log already holds s, resyncing keeps the checkpoints before the gap
+         wlog("blockroot merkle index head ${h} is not followed by irreversible block ${n}, syncing it with the block log",
+              ("h", blockroot_merkle_index.head_block_num())("n", s.block_num));
+         sync_blockroot_merkle_index();
+         return;
+      }
+      blockroot_merkle_index.append(s.block_num, s.id, s.blockroot_merkle);
+   }
+
+   /**
+    *  Bring the blockroot merkle index up to the head of the block log. An index that still matches
+    *  the log is resumed from its head, otherwise it is rebuilt from the ids in the block log, starting
+    *  from genesis when the log has it or from the irreversible block state in the fork database.
+    */
+   void sync_blockroot_merkle_index()
+   {
+      auto log_head = blog.read_head();
+      if (!log_head)
+      {
+         if (!blockroot_merkle_index.empty())
+            blockroot_merkle_index.reset();
+         return;
+      }
+      const uint32_t log_head_num = log_head->block_num();
+
+      if (!blockroot_merkle_index.empty())
+      {
+         auto h = blockroot_merkle_index.head_block_num() <= log_head_num ? blog.read_block_header_by_num(blockroot_merkle_index.head_block_num())
+                                                                        : optional<signed_block_header>();
+         if (!h || h->id() != *blockroot_merkle_index.read_id_by_num(blockroot_merkle_index.head_block_num()))
+         {
+            wlog("blockroot merkle index doesn't match the block log, rebuilding it");
+            blockroot_merkle_index.reset();
+         }
+      }
+
+      uint32_t next_num = 0;
+      incremental_merkle merkle;
+      if (!blockroot_merkle_index.empty())
+      {
+         next_num = blockroot_merkle_index.head_block_num();
+         merkle = *blockroot_merkle_index.read_merkle_by_num(next_num);
+         merkle.append(*blockroot_merkle_index.read_id_by_num(next_num));
+         ++next_num;
+      }
+      else if (blog.first_block_num() == 1)
+      {
+         next_num = 1; // the blockroot_merkle of the genesis block is empty
+      }
+      else if (auto bs = fork_db.get_block_in_current_chain_by_num(log_head_num))
+      {
+         next_num = log_head_num;
+         merkle = bs->blockroot_merkle;
+      }
+      else
+      {
+         wlog("no starting point for the blockroot merkle index, it starts with the next irreversible block");
+         return;
+      }
+
+      if (next_num <= log_head_num)
+         ilog("indexing blockroot merkle of blocks ${from} to ${to}", ("from", next_num)("to", log_head_num));
+      while (next_num <= log_head_num)
+      {
+         auto headers = blog.read_block_headers_by_num(next_num, 10000);
+         if (headers.empty())
+            break;
+         for (const auto &h : headers)
+         {
+            auto id = h.id();
+            blockroot_merkle_index.append(h.block_num(), id, merkle);
+            merkle.append(id);
+         }
+         next_num += headers.size();
+      }
+      blockroot_merkle_index.flush();
+   }
+
    void replay(std::function<bool()> shutdown)
    {
       auto blog_head = blog.read_head();
@@ -359,13 +538,60 @@ struct controller_impl
       ilog("existing block log, attempting to replay from ${s} to ${n} blocks",
            ("s", start_block_num)("n", blog_head->block_num()));
 
+      // the reversible blocks replayed below become irreversible onto the indexes
+      sync_slot_index();
+      sync_blockroot_merkle_index();
+
+      trusted_replay_block_num = 0;
+      if (conf.trusted_replay)
+      {
+         // every block before the checkpoint is tied to it through the previous ids checked on replay
+         for (auto itr = conf.checkpoints.rbegin(); itr != conf.checkpoints.rend(); ++itr)
+         {
+            if (itr->first > blog_head->block_num() || itr->first < start_block_num)
+               continue;
+            auto checkpoint_block = blog.read_block_by_num(itr->first);
+            SNAX_ASSERT(checkpoint_block && checkpoint_block->id() == itr->second, checkpoint_exception,
+                        "block log does not contain checkpoint block ${n} ${id}", ("n", itr->first)("id", itr->second));
+            trusted_replay_block_num = itr->first;
+            break;
+         }
+         ilog("trusted replay up to checkpoint block ${n}", ("n", trusted_replay_block_num));
+      }
+
       auto start = fc::time_point::now();
-      while (auto next = blog.read_block_by_num(head->block_num + 1))
+
+      // keep the thread pool busy preparing the blocks ahead while the current one is applied
+      std::deque<replay_block> read_ahead;
+      uint64_t read_ahead_size = 0;
+      uint32_t next_num = head->block_num + 1;
+      std::promise<block_state_ptr> head_state;
+      head_state.set_value(head);
+      std::shared_future<block_state_ptr> prev_state = head_state.get_future().share();
+
+      while (true)
       {
-         replay_push_block(next, controller::block_status::irreversible);
-         if (next->block_num() % 100 == 0)
+         while (read_ahead.size() < std::max(conf.replay_read_ahead_blocks, 1u) && read_ahead_size < conf.replay_read_ahead_size)
          {
-            std::cerr << std::setw(10) << next->block_num() << " of " << blog_head->block_num() << "\r";
+            auto b = blog.read_block_by_num(next_num);
+            if (!b)
+               break;
+            ++next_num;
+            read_ahead.emplace_back(prepare_replay_block(b, prev_state));
+            prev_state = read_ahead.back().state;
+            read_ahead_size += read_ahead.back().size;
+         }
+         if (read_ahead.empty())
+            break;
+
+         replay_block next = std::move(read_ahead.front());
+         read_ahead.pop_front();
+         read_ahead_size -= next.size;
+
+         replay_push_block(next.block, controller::block_status::irreversible, &next);
+         if (next.block->block_num() % 100 == 0)
+         {
+            std::cerr << std::setw(10) << next.block->block_num() << " of " << blog_head->block_num() << "\r";
             if (shutdown())
                break;
          }
@@ -391,6 +617,14 @@ struct controller_impl
            ("n", head->block_num - start_block_num)("duration", (end - start).count() / 1000000)("mspb", ((end - start).count() / 1000.0) / (head->block_num - start_block_num)));
       replaying = false;
       replay_head_time.reset();
+      trusted_replay_block_num = 0;
+   }
+
+   /// the pending block is replayed from the block log at or below the trusted replay checkpoint
+   bool in_trusted_replay() const
+   {
+      return pending && !in_trx_requiring_checks && pending->_block_status == controller::block_status::irreversible &&
+             pending->_pending_block_state->block_num <= trusted_replay_block_num;
    }
 
    void init(std::function<bool()> shutdown, const snapshot_reader_ptr &snapshot)
@@ -440,6 +674,9 @@ struct controller_impl
          }
       }
 
+      sync_slot_index();
+      sync_blockroot_merkle_index();
+
       if (shutdown())
          return;
 
@@ -510,6 +747,7 @@ struct controller_impl
       // Rewind the database to the last irreversible block
       db.with_write_lock([&] {
          db.undo_all();
+         authorization.clear_cache();
          /*
          FC_ASSERT(db.revision() == self.head_block_num(),
                    "Chainbase revision does not match head block num",
@@ -799,6 +1037,9 @@ struct controller_impl
          }
 
          emit(self.accepted_block, pending->_pending_block_state);
+
+         // only code the block committed is compiled ahead, a failed setcode costs the sender nothing
+         wasmif.compile_deployed(db, *thread_pool);
       }
       catch (...)
       {
@@ -914,7 +1155,7 @@ struct controller_impl
       {
          maybe_session undo_session;
          if (!self.skip_db_sessions())
-            undo_session = maybe_session(db);
+            undo_session = maybe_session(db, authorization);
 
          auto gtrx = generated_transaction(gto);
 
@@ -1230,7 +1471,7 @@ struct controller_impl
          SNAX_ASSERT(db.revision() == head->block_num, database_exception, "db revision is not on par with head block",
                      ("db.revision()", db.revision())("controller_head_block", head->block_num)("fork_db_head_block", fork_db.head()->block_num));
 
-         pending.emplace(maybe_session(db));
+         pending.emplace(maybe_session(db, authorization));
       }
       else
       {
@@ -1310,33 +1551,62 @@ struct controller_impl
       static_cast<signed_block_header &>(*p->block) = p->header;
    } /// sign_block
 
+   /**
+    *  Blocks logged before the blockroot merkle index existed carry the blockroot_merkle of every 64th block in an
+    *  extension. Neither the block id nor the producer signature covers the extensions, so the one accepted has to
+    *  hold exactly the blockroot_merkle the block's state derives from the head; no other extension is supported.
+    */
+   void validate_block_extensions(const signed_block &b)
+   {
+      if (b.block_extensions.empty())
+         return;
+
+      SNAX_ASSERT(b.block_extensions.size() == 1 && b.block_extensions.front().first == config::legacy_blockroot_merkle_extension,
+                  block_validate_exception, "no supported extensions");
+      SNAX_ASSERT(b.block_num() % 64 == 0, block_validate_exception,
+                  "blockroot merkle extension on a block not a multiple of 64", ("block_num", b.block_num()));
+
+      auto merkle = head->blockroot_merkle;
+      merkle.append(head->id);
+      SNAX_ASSERT(b.block_extensions.front().second == fc::raw::pack(merkle), block_validate_exception,
+                  "blockroot merkle extension doesn't match the chain", ("block_num", b.block_num()));
+   }
+
    void apply_block(const signed_block_ptr &b, controller::block_status s)
    {
       try
       {
          try
          {
-            SNAX_ASSERT(b->block_extensions.size() == 0, block_validate_exception, "no supported extensions");
+            validate_block_extensions(*b);
             auto producer_block_id = b->id();
             start_block(b->timestamp, b->confirmed, s, producer_block_id);
 
             std::vector<transaction_metadata_ptr> packed_transactions;
             packed_transactions.reserve(b->transactions.size());
-            for (const auto &receipt : b->transactions)
+            if (replay_transactions && replay_transactions->first == b)
             {
-               if (receipt.trx.contains<packed_transaction>())
+               for (auto &trx : replay_transactions->second)
+                  packed_transactions.emplace_back(trx.get());
+            }
+            else
+            {
+               for (const auto &receipt : b->transactions)
                {
-                  auto &pt = receipt.trx.get<packed_transaction>();
-                  auto mtrx = std::make_shared<transaction_metadata>(pt);
-                  if (!self.skip_auth_check())
+                  if (receipt.trx.contains<packed_transaction>())
                   {
-                     std::weak_ptr<transaction_metadata> mtrx_wp = mtrx;
-                     mtrx->signing_keys_future = async_thread_pool([chain_id = this->chain_id, mtrx_wp]() {
-                        auto mtrx = mtrx_wp.lock();
-                        return mtrx ? std::make_pair(chain_id, mtrx->trx.get_signature_keys(chain_id)) : std::make_pair(chain_id, decltype(mtrx->trx.get_signature_keys(chain_id)){});
-                     });
+                     auto &pt = receipt.trx.get<packed_transaction>();
+                     auto mtrx = std::make_shared<transaction_metadata>(pt);
+                     if (!self.skip_auth_check())
+                     {
+                        std::weak_ptr<transaction_metadata> mtrx_wp = mtrx;
+                        mtrx->signing_keys_future = async_thread_pool([chain_id = this->chain_id, mtrx_wp]() {
+                           auto mtrx = mtrx_wp.lock();
+                           return mtrx ? std::make_pair(chain_id, mtrx->trx.get_signature_keys(chain_id)) : std::make_pair(chain_id, decltype(mtrx->trx.get_signature_keys(chain_id)){});
+                        });
+                     }
+                     packed_transactions.emplace_back(std::move(mtrx));
                   }
-                  packed_transactions.emplace_back(std::move(mtrx));
                }
             }
 
@@ -1381,6 +1651,14 @@ struct controller_impl
 
             finalize_block();
 
+            // covered by the id check below as well, checked first to tell a corrupted block log apart
+            SNAX_ASSERT(b->transaction_mroot == pending->_pending_block_state->header.transaction_mroot,
+                        block_validate_exception, "transaction_mroot does not match",
+                        ("producer", b->transaction_mroot)("validator", pending->_pending_block_state->header.transaction_mroot));
+            SNAX_ASSERT(b->action_mroot == pending->_pending_block_state->header.action_mroot,
+                        block_validate_exception, "action_mroot does not match",
+                        ("producer", b->action_mroot)("validator", pending->_pending_block_state->header.action_mroot));
+
             // this implicitly asserts that all header fields (less the signature) are identical
             SNAX_ASSERT(producer_block_id == pending->_pending_block_state->header.id(),
                         block_validate_exception, "Block ID does not match",
@@ -1458,7 +1736,38 @@ struct controller_impl
       FC_LOG_AND_RETHROW()
    }
 
-   void replay_push_block(const signed_block_ptr &b, controller::block_status s)
+   replay_block prepare_replay_block(const signed_block_ptr &b, const std::shared_future<block_state_ptr> &prev_state)
+   {
+      replay_block rb;
+      rb.block = b;
+      rb.size = fc::raw::pack_size(*b);
+
+      // authorization of irreversible blocks is only checked with force-all-checks, and not even then in a trusted replay
+      const bool trusted = b->block_num() <= trusted_replay_block_num;
+      const bool recover_keys = conf.force_all_checks && !trusted;
+      for (const auto &receipt : b->transactions)
+      {
+         if (receipt.trx.contains<packed_transaction>())
+         {
+            const auto *pt = &receipt.trx.get<packed_transaction>();
+            rb.transactions.emplace_back(async_thread_pool([b, pt, recover_keys, chain_id = this->chain_id]() {
+               auto mtrx = std::make_shared<transaction_metadata>(*pt);
+               if (recover_keys)
+                  mtrx->signing_keys = std::make_pair(chain_id, mtrx->trx.get_signature_keys(chain_id));
+               return mtrx;
+            }));
+         }
+      }
+
+      // waits for the state of the previous block, which was queued before this one
+      const bool skip_validate_signee = !conf.force_all_checks || trusted;
+      rb.state = async_thread_pool([b, prev_state, skip_validate_signee]() {
+                    return std::make_shared<block_state>(*prev_state.get(), b, skip_validate_signee);
+                 }).share();
+      return rb;
+   }
+
+   void replay_push_block(const signed_block_ptr &b, controller::block_status s, replay_block *prepared = nullptr)
    {
       self.validate_db_available_size();
       self.validate_reversible_available_size();
@@ -1471,8 +1780,20 @@ struct controller_impl
          SNAX_ASSERT((s == controller::block_status::irreversible || s == controller::block_status::validated),
                      block_validate_exception, "invalid block status for replay");
          emit(self.pre_accepted_block, b);
-         const bool skip_validate_signee = !conf.force_all_checks;
-         auto new_header_state = fork_db.add(b, skip_validate_signee);
+         block_state_ptr new_header_state;
+         if (prepared)
+         {
+            new_header_state = fork_db.add(prepared->state.get(), false);
+            replay_transactions.emplace(b, std::move(prepared->transactions));
+         }
+         else
+         {
+            const bool skip_validate_signee = !conf.force_all_checks;
+            new_header_state = fork_db.add(b, skip_validate_signee);
+         }
+         auto reset_replay_transactions = fc::make_scoped_exit([this]() {
+            replay_transactions.reset();
+         });
 
          emit(self.accepted_block_header, new_header_state);
 
@@ -1529,7 +1850,7 @@ struct controller_impl
                apply_block((*ritr)->block, (*ritr)->validated ? controller::block_status::validated : controller::block_status::complete);
                head = *ritr;
                fork_db.mark_in_current_chain(*ritr, true);
-               (*ritr)->validated = true;
+               fork_db.set_validity(*ritr, true);
             }
             catch (const fc::exception &e)
             {
@@ -2172,6 +2493,47 @@ block_state_ptr controller::fetch_block_state_by_id(block_id_type id) const
    return state;
 }
 
+optional<signed_block_header> controller::fetch_block_header_by_number(uint32_t block_num) const
+{
+   try
+   {
+      auto blk_state = my->fork_db.get_block_in_current_chain_by_num(block_num);
+      if (blk_state)
+      {
+         return blk_state->header;
+      }
+
+      return my->blog.read_block_header_by_num(block_num);
+   }
+   FC_CAPTURE_AND_RETHROW((block_num))
+}
+
+vector<signed_block_header> controller::fetch_block_headers_by_number(uint32_t block_num, uint32_t count) const
+{
+   try
+   {
+      vector<signed_block_header> headers;
+      const auto &log_head = my->blog.head();
+      uint32_t log_head_num = log_head ? log_head->block_num() : 0;
+      if (count > 0 && block_num <= log_head_num)
+      {
+         headers = my->blog.read_block_headers_by_num(block_num, std::min(count, log_head_num - block_num + 1));
+      }
+
+      for (uint32_t n = block_num + headers.size(); n - block_num < count; ++n)
+      {
+         auto blk_state = my->fork_db.get_block_in_current_chain_by_num(n);
+         if (!blk_state)
+         {
+            break;
+         }
+         headers.push_back(blk_state->header);
+      }
+      return headers;
+   }
+   FC_CAPTURE_AND_RETHROW((block_num)(count))
+}
+
 block_state_ptr controller::fetch_block_state_by_number(uint32_t block_num) const
 {
    try
@@ -2182,6 +2544,51 @@ block_state_ptr controller::fetch_block_state_by_number(uint32_t block_num) cons
    FC_CAPTURE_AND_RETHROW((block_num))
 }
 
+optional<uint32_t> controller::fetch_block_num_by_slot(uint32_t slot) const
+{
+   try
+   {
+      if (!my->slot_index.empty() && slot <= my->slot_index.head_slot())
+      {
+         auto block_num = my->slot_index.block_num_for_slot(slot);
+         if (block_num)
+            return block_num;
+         return optional<uint32_t>();
+      }
+
+      // reversible blocks are not indexed yet, walk back the current chain
+      for (auto bs = my->fork_db.head(); bs && bs->header.timestamp.slot >= slot; bs = my->fork_db.get_block(bs->header.previous))
+      {
+         if (bs->header.timestamp.slot == slot)
+            return bs->block_num;
+      }
+      return optional<uint32_t>();
+   }
+   FC_CAPTURE_AND_RETHROW((slot))
+}
+
+optional<incremental_merkle> controller::fetch_blockroot_merkle_by_num(uint32_t block_num) const
+{
+   try
+   {
+      auto merkle = my->blockroot_merkle_index.read_merkle_by_num(block_num);
+      if (merkle)
+         return merkle;
+
+      // reversible blocks are not indexed yet
+      auto blk_state = my->fork_db.get_block_in_current_chain_by_num(block_num);
+      if (blk_state)
+         return blk_state->blockroot_merkle;
+      return optional<incremental_merkle>();
+   }
+   FC_CAPTURE_AND_RETHROW((block_num))
+}
+
+std::shared_ptr<const block_log_reader> controller::get_block_log_reader() const
+{
+   return my->blog.get_reader();
+}
+
 block_id_type controller::get_block_id_for_num(uint32_t block_num) const
 {
    try
@@ -2315,7 +2722,7 @@ bool controller::light_validation_allowed(bool replay_opts_disabled_by_policy) c
 
 bool controller::skip_auth_check() const
 {
-   return light_validation_allowed(my->conf.force_all_checks);
+   return light_validation_allowed(my->conf.force_all_checks) || my->in_trusted_replay();
 }
 
 bool controller::skip_db_sessions(block_status bs) const
@@ -2351,6 +2758,16 @@ chain_id_type controller::get_chain_id() const
    return my->chain_id;
 }
 
+const controller::config &controller::get_config() const
+{
+   return my->conf;
+}
+
+boost::asio::thread_pool &controller::get_thread_pool()
+{
+   return *my->thread_pool;
+}
+
 db_read_mode controller::get_read_mode() const
 {
    return my->read_mode;
@@ -2377,6 +2794,11 @@ wasm_interface &controller::get_wasm_interface()
    return my->wasmif;
 }
 
+const wasm_interface &controller::get_wasm_interface() const
+{
+   return my->wasmif;
+}
+
 const account_object &controller::get_account(account_name name) const
 {
    try
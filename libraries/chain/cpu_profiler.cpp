@@ -0,0 +1,157 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#include <snax/chain/cpu_profiler.hpp>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+namespace snax { namespace chain { namespace cpu_profiler {
+
+   std::atomic<bool> enabled_flag{false};
+
+   namespace detail {
+      struct sample_key_hash {
+         size_t operator()( const sample_key& k )const {
+            size_t seed = static_cast<size_t>( k.kind );
+            boost::hash_combine( seed, k.receiver.value );
+            boost::hash_combine( seed, k.account.value );
+            boost::hash_combine( seed, k.action.value );
+            boost::hash_combine( seed, k.function );
+            return seed;
+         }
+      };
+
+      /// written by one thread only, the atomics let snapshots read it while it is updated
+      struct histogram {
+         std::atomic<uint64_t> count{0};
+         std::atomic<uint64_t> total_ns{0};
+         std::atomic<uint64_t> max_ns{0};
+         std::atomic<uint64_t> buckets[bucket_count];
+
+         histogram() {
+            for( auto& b : buckets )
+               b.store( 0, std::memory_order_relaxed );
+         }
+
+         static void add( std::atomic<uint64_t>& a, uint64_t v ) {
+            a.store( a.load( std::memory_order_relaxed ) + v, std::memory_order_relaxed );
+         }
+      };
+
+      /**
+       * The histograms of one thread. Its thread looks up and updates them without locking; the mutex
+       * is only taken to add or clear histograms, which is when a snapshot could be walking the map.
+       */
+      struct thread_histograms {
+         std::mutex                                                     mtx;
+         std::unordered_map<sample_key, histogram, sample_key_hash>     histograms;
+         uint64_t                                                       generation = 0;
+      };
+
+      std::atomic<uint64_t>                              generation{0};
+      std::mutex                                         threads_mtx;
+      vector<std::shared_ptr<thread_histograms>>         threads;    ///< kept after their thread exits
+
+      thread_histograms& this_thread() {
+         thread_local std::shared_ptr<thread_histograms> local;
+         if( !local ) {
+            local = std::make_shared<thread_histograms>();
+            local->generation = generation.load();
+            std::lock_guard<std::mutex> g( threads_mtx );
+            threads.push_back( local );
+         }
+         return *local;
+      }
+
+      const char* kind_name( sample_kind kind ) {
+         switch( kind ) {
+            case sample_kind::transaction:   return "transaction";
+            case sample_kind::action:        return "action";
+            case sample_kind::host_function: return "host_function";
+            case sample_kind::db:            return "db";
+         }
+         return "unknown";
+      }
+   }
+
+   void set_enabled( bool enable ) {
+      enabled_flag.store( enable );
+   }
+
+   void record( const sample_key& key, uint64_t ns ) {
+      auto& t = detail::this_thread();
+
+      auto gen = detail::generation.load( std::memory_order_relaxed );
+      if( BOOST_UNLIKELY( t.generation != gen ) ) {
+         std::lock_guard<std::mutex> g( t.mtx );
+         t.histograms.clear();
+         t.generation = gen;
+      }
+
+      auto itr = t.histograms.find( key );
+      if( BOOST_UNLIKELY( itr == t.histograms.end() ) ) {
+         std::lock_guard<std::mutex> g( t.mtx );
+         itr = t.histograms.emplace( std::piecewise_construct, std::forward_as_tuple( key ), std::forward_as_tuple() ).first;
+      }
+
+      auto& h = itr->second;
+      uint32_t bucket = ns ? 63 - __builtin_clzll( ns ) : 0;
+      detail::histogram::add( h.buckets[std::min( bucket, bucket_count - 1 )], 1 );
+      detail::histogram::add( h.count, 1 );
+      detail::histogram::add( h.total_ns, ns );
+      if( ns > h.max_ns.load( std::memory_order_relaxed ) )
+         h.max_ns.store( ns, std::memory_order_relaxed );
+   }
+
+   vector<histogram_entry> snapshot() {
+      vector<std::shared_ptr<detail::thread_histograms>> threads;
+      {
+         std::lock_guard<std::mutex> g( detail::threads_mtx );
+         threads = detail::threads;
+      }
+
+      const auto gen = detail::generation.load();
+      std::unordered_map<sample_key, histogram_entry, detail::sample_key_hash> merged;
+      for( const auto& t : threads ) {
+         std::lock_guard<std::mutex> g( t->mtx );
+         if( t->generation != gen )
+            continue;   // samples from before the last reset
+         for( const auto& i : t->histograms ) {
+            auto& e = merged[i.first];
+            if( e.buckets.empty() ) {
+               e.kind = detail::kind_name( i.first.kind );
+               e.receiver = i.first.receiver;
+               e.account = i.first.account;
+               e.action = i.first.action;
+               if( i.first.function )
+                  e.function = i.first.function;
+               e.buckets.resize( bucket_count );
+            }
+            const auto& h = i.second;
+            e.count += h.count.load( std::memory_order_relaxed );
+            e.total_ns += h.total_ns.load( std::memory_order_relaxed );
+            e.max_ns = std::max( e.max_ns, h.max_ns.load( std::memory_order_relaxed ) );
+            for( uint32_t b = 0; b < bucket_count; ++b )
+               e.buckets[b] += h.buckets[b].load( std::memory_order_relaxed );
+         }
+      }
+
+      vector<histogram_entry> result;
+      result.reserve( merged.size() );
+      for( auto& i : merged )
+         result.push_back( std::move( i.second ) );
+      std::sort( result.begin(), result.end(), []( const histogram_entry& a, const histogram_entry& b ) {
+         return a.total_ns > b.total_ns;
+      });
+      return result;
+   }
+
+   void reset() {
+      ++detail::generation;
+   }
+
+} } } /// snax::chain::cpu_profiler
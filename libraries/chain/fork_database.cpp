@@ -1,51 +1,379 @@
 #include <snax/chain/fork_database.hpp>
 #include <snax/chain/exceptions.hpp>
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/mem_fun.hpp>
-#include <boost/multi_index/composite_key.hpp>
 #include <fc/io/fstream.hpp>
 #include <fstream>
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
 
 namespace snax { namespace chain {
-   using boost::multi_index_container;
-   using namespace boost::multi_index;
-
-
-   struct by_block_id;
-   struct by_block_num;
-   struct by_lib_block_num;
-   struct by_prev;
-   typedef multi_index_container<
-      block_state_ptr,
-      indexed_by<
-         hashed_unique< tag<by_block_id>, member<block_header_state, block_id_type, &block_header_state::id>, std::hash<block_id_type>>,
-         ordered_non_unique< tag<by_prev>, const_mem_fun<block_header_state, const block_id_type&, &block_header_state::prev> >,
-         ordered_non_unique< tag<by_block_num>,
-            composite_key< block_state,
-               member<block_header_state,uint32_t,&block_header_state::block_num>,
-               member<block_state,bool,&block_state::in_current_chain>
-            >,
-            composite_key_compare< std::less<uint32_t>, std::greater<bool> >
-         >,
-         ordered_non_unique< tag<by_lib_block_num>,
-            composite_key< block_header_state,
-                member<block_header_state,uint32_t,&block_header_state::dpos_irreversible_blocknum>,
-                member<block_header_state,uint32_t,&block_header_state::bft_irreversible_blocknum>,
-                member<block_header_state,uint32_t,&block_header_state::block_num>
-            >,
-            composite_key_compare< std::greater<uint32_t>, std::greater<uint32_t>, std::greater<uint32_t> >
-         >
-      >
-   > fork_multi_index_type;
 
+   const uint32_t fork_database::magic_number = 0x30510FDB;
+
+   /**
+    * History:
+    * Version 1: append only log of the block states added and the changes made to them since the
+    *            file was last rewritten, ended by the head block id when the fork database is closed.
+    *            Files without the magic number are the complete dump written before, they are still read.
+    */
+   const uint32_t fork_database::supported_version = 1;
+
+   namespace detail {
+      const uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+      enum class fork_db_record : uint8_t {
+         state,         ///< block_state
+         remove,        ///< block_id_type
+         flags,         ///< block_id_type, validated, in_current_chain, bft_irreversible_blocknum
+         confirmation,  ///< header_confirmation
+         head           ///< block_id_type, the last record of a cleanly closed file
+      };
+
+      /**
+       * A block state in the arena. The links and the keys the fork database orders blocks by are
+       * kept here so walking the graph or picking the head doesn't touch the block states themselves.
+       */
+      struct fork_node {
+         block_state_ptr   state;
+         uint32_t          prev = npos;           ///< slot of the previous block, npos if it is not in the fork database
+         uint32_t          first_child = npos;
+         uint32_t          next_sibling = npos;
+         uint32_t          block_num = 0;
+         uint32_t          dpos_irreversible_blocknum = 0;
+         uint32_t          bft_irreversible_blocknum = 0;
+         bool              in_current_chain = false;
+         uint64_t          seq = 0;               ///< insertion order, the first of equally good heads wins
+      };
+   }
+
+   using detail::npos;
+   using detail::fork_db_record;
 
    struct fork_database_impl {
-      fork_multi_index_type index;
-      block_state_ptr       head;
-      fc::path              datadir;
+      vector<detail::fork_node>                    nodes;        ///< arena, slots of removed blocks are reused
+      vector<uint32_t>                             free_slots;
+      std::unordered_map<block_id_type, uint32_t>  slot_by_id;
+      std::deque<vector<uint32_t>>                 slots_by_num; ///< slots of each block number from first_num on, in insertion order
+      uint32_t                                     first_num = 0;
+      uint64_t                                     next_seq = 0;
+      uint32_t                                     best = npos;  ///< npos when it has to be searched for
+      block_state_ptr                              head;
+      fc::path                                     datadir;
+
+      std::ofstream                                log;
+      bool                                         logging = false;
+      uint64_t                                     logged_states = 0;  ///< state records in forkdb.dat, live or not
+
+      size_t size()const { return slot_by_id.size(); }
+
+      uint32_t find( const block_id_type& id )const {
+         auto itr = slot_by_id.find( id );
+         return itr == slot_by_id.end() ? npos : itr->second;
+      }
+
+      vector<uint32_t>* slots_at( uint32_t num ) {
+         if( num < first_num || num - first_num >= slots_by_num.size() )
+            return nullptr;
+         return &slots_by_num[num - first_num];
+      }
+
+      /// the first block at the lowest block number, preferring the one in the current chain
+      uint32_t oldest()const {
+         if( slots_by_num.empty() )
+            return npos;
+         const auto& slots = slots_by_num.front();
+         for( auto slot : slots ) {
+            if( nodes[slot].in_current_chain )
+               return slot;
+         }
+         return slots.front();
+      }
+
+      /// highest irreversible block numbers first, then the highest block number
+      bool better( uint32_t a, uint32_t b )const {
+         const auto& x = nodes[a];
+         const auto& y = nodes[b];
+         auto kx = std::tie( x.dpos_irreversible_blocknum, x.bft_irreversible_blocknum, x.block_num );
+         auto ky = std::tie( y.dpos_irreversible_blocknum, y.bft_irreversible_blocknum, y.block_num );
+         return kx > ky || ( kx == ky && x.seq < y.seq );
+      }
+
+      /// the keys of a block only ever improve, so the best block stays the best when its own keys change
+      void consider_best( uint32_t slot ) {
+         if( best != npos && slot != best && better( slot, best ) )
+            best = slot;
+      }
+
+      block_state_ptr best_state() {
+         if( best == npos ) {
+            for( const auto& i : slot_by_id ) {
+               if( best == npos || better( i.second, best ) )
+                  best = i.second;
+            }
+         }
+         return best == npos ? block_state_ptr() : nodes[best].state;
+      }
+
+      uint32_t insert( block_state_ptr s ) {
+         SNAX_ASSERT( s->id == s->header.id(), fork_database_exception,
+                     "block state id (${id}) is different from block state header id (${hid})", ("id", string(s->id))("hid", string(s->header.id())) );
+         SNAX_ASSERT( slot_by_id.find( s->id ) == slot_by_id.end(), fork_database_exception, "unable to insert block state, duplicate state detected" );
+
+         uint32_t slot;
+         if( free_slots.empty() ) {
+            slot = nodes.size();
+            nodes.emplace_back();
+         } else {
+            slot = free_slots.back();
+            free_slots.pop_back();
+         }
+
+         auto& n = nodes[slot];
+         n.block_num = s->block_num;
+         n.dpos_irreversible_blocknum = s->dpos_irreversible_blocknum;
+         n.bft_irreversible_blocknum = s->bft_irreversible_blocknum;
+         n.in_current_chain = s->in_current_chain;
+         n.seq = next_seq++;
+         n.first_child = npos;
+         n.prev = find( s->header.previous );
+         if( n.prev != npos ) {
+            n.next_sibling = nodes[n.prev].first_child;
+            nodes[n.prev].first_child = slot;
+         } else {
+            n.next_sibling = npos;
+         }
+         n.state = std::move( s );
+
+         slot_by_id.emplace( n.state->id, slot );
+         if( slots_by_num.empty() ) {
+            first_num = n.block_num;
+         } else {
+            for( ; first_num > n.block_num; --first_num )
+               slots_by_num.emplace_front();
+         }
+         if( n.block_num - first_num >= slots_by_num.size() )
+            slots_by_num.resize( n.block_num - first_num + 1 );
+         slots_by_num[n.block_num - first_num].push_back( slot );
+
+         if( slot_by_id.size() == 1 )
+            best = slot;
+         else
+            consider_best( slot );
+
+         append_state( *n.state );
+         return slot;
+      }
+
+      /// the children of the erased block stay in the fork database without a previous block
+      void erase( uint32_t slot ) {
+         auto& n = nodes[slot];
+         if( n.prev != npos ) {
+            auto* link = &nodes[n.prev].first_child;
+            while( *link != slot )
+               link = &nodes[*link].next_sibling;
+            *link = n.next_sibling;
+         }
+         for( auto child = n.first_child; child != npos; child = nodes[child].next_sibling )
+            nodes[child].prev = npos;
+
+         auto& slots = *slots_at( n.block_num );
+         slots.erase( std::find( slots.begin(), slots.end(), slot ) );
+         while( !slots_by_num.empty() && slots_by_num.front().empty() ) {
+            slots_by_num.pop_front();
+            ++first_num;
+         }
+         while( !slots_by_num.empty() && slots_by_num.back().empty() )
+            slots_by_num.pop_back();
+
+         append_id( fork_db_record::remove, n.state->id );
+         slot_by_id.erase( n.state->id );
+         n.state.reset();
+         n.prev = n.first_child = n.next_sibling = npos;
+         free_slots.push_back( slot );
+         if( best == slot )
+            best = npos;
+      }
+
+      /// erase the block and every block built on it
+      void erase_tree( uint32_t slot ) {
+         vector<uint32_t> queue{slot};
+         for( size_t i = 0; i < queue.size(); ++i ) {
+            for( auto child = nodes[queue[i]].first_child; child != npos; child = nodes[child].next_sibling )
+               queue.push_back( child );
+         }
+         for( auto s : queue )
+            erase( s );
+      }
+
+      void set_flags( uint32_t slot ) {
+         auto& n = nodes[slot];
+         const auto& s = *n.state;
+         n.in_current_chain = s.in_current_chain;
+         n.bft_irreversible_blocknum = s.bft_irreversible_blocknum;
+         consider_best( slot );
+         if( logging ) {
+            pack_type( fork_db_record::flags );
+            fc::raw::pack( log, s.id );
+            fc::raw::pack( log, s.validated );
+            fc::raw::pack( log, s.in_current_chain );
+            fc::raw::pack( log, s.bft_irreversible_blocknum );
+         }
+      }
+
+      void pack_type( fork_db_record type ) {
+         fc::raw::pack( log, static_cast<uint8_t>(type) );
+      }
+
+      void append_state( const block_state& s ) {
+         if( !logging ) return;
+         pack_type( fork_db_record::state );
+         fc::raw::pack( log, s );
+         // rewrite the file once most of it describes blocks that are gone, writes stay linear in the blocks added
+         if( ++logged_states > 2 * size() + 256 )
+            rewrite();
+      }
+
+      void append_id( fork_db_record type, const block_id_type& id ) {
+         if( !logging ) return;
+         pack_type( type );
+         fc::raw::pack( log, id );
+      }
+
+      void append_confirmation( const header_confirmation& c ) {
+         if( !logging ) return;
+         pack_type( fork_db_record::confirmation );
+         fc::raw::pack( log, c );
+      }
+
+      /// replace forkdb.dat with just the live block states, parents before their children
+      void rewrite() {
+         auto fork_db_dat = datadir / config::forkdb_filename;
+         auto tmp = datadir / ( string( config::forkdb_filename ) + ".tmp" );
+         if( log.is_open() )
+            log.close();
+         {
+            std::ofstream out( tmp.generic_string().c_str(), std::ios::out | std::ios::binary | std::ofstream::trunc );
+            fc::raw::pack( out, fork_database::magic_number );
+            fc::raw::pack( out, fork_database::supported_version );
+            for( const auto& slots : slots_by_num ) {
+               for( auto slot : slots ) {
+                  fc::raw::pack( out, static_cast<uint8_t>(fork_db_record::state) );
+                  fc::raw::pack( out, *nodes[slot].state );
+               }
+            }
+            out.flush();
+            SNAX_ASSERT( out.good(), fork_database_exception, "unable to write ${f}", ("f", tmp.generic_string()) );
+         }
+         fc::rename( tmp, fork_db_dat );
+         log.open( fork_db_dat.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::app );
+         logged_states = size();
+         logging = true;
+      }
+
+      /**
+       * Read forkdb.dat, returns the block states in it and sets head_id, nothing if the file wasn't closed
+       * cleanly or is damaged; like a fork database that was never written then.
+       */
+      vector<block_state_ptr> read( block_id_type& head_id ) {
+         vector<block_state_ptr> states;
+         string content;
+         fc::read_file_contents( datadir / config::forkdb_filename, content );
+
+         fc::datastream<const char*> ds( content.data(), content.size() );
+         uint32_t magic = 0;
+         if( content.size() >= sizeof(magic) )
+            fc::raw::unpack( ds, magic );
+
+         if( magic != fork_database::magic_number ) {
+            ds = fc::datastream<const char*>( content.data(), content.size() );
+            unsigned_int size; fc::raw::unpack( ds, size );
+            for( uint32_t i = 0, n = size.value; i < n; ++i ) {
+               auto s = std::make_shared<block_state>();
+               fc::raw::unpack( ds, *s );
+               states.push_back( std::move( s ) );
+            }
+            fc::raw::unpack( ds, head_id );
+            return states;
+         }
+
+         uint32_t version = 0;
+         fc::raw::unpack( ds, version );
+         if( version != fork_database::supported_version ) {
+            wlog( "fork database file has unsupported version ${v}, discarding it", ("v", version) );
+            return {};
+         }
+
+         std::unordered_map<block_id_type, size_t> index;
+         bool closed = false;
+         while( ds.remaining() ) {
+            if( closed ) {
+               wlog( "fork database file continues after its head block, discarding it" );
+               return {};
+            }
+            uint8_t type = 0;
+            fc::raw::unpack( ds, type );
+            switch( static_cast<fork_db_record>(type) ) {
+               case fork_db_record::state: {
+                  auto s = std::make_shared<block_state>();
+                  fc::raw::unpack( ds, *s );
+                  index[s->id] = states.size();
+                  states.push_back( std::move( s ) );
+                  break;
+               }
+               case fork_db_record::remove: {
+                  block_id_type id;
+                  fc::raw::unpack( ds, id );
+                  auto itr = index.find( id );
+                  if( itr != index.end() ) {
+                     states[itr->second].reset();
+                     index.erase( itr );
+                  }
+                  break;
+               }
+               case fork_db_record::flags: {
+                  block_id_type id;
+                  bool validated = false, in_current_chain = false;
+                  uint32_t bft_irreversible_blocknum = 0;
+                  fc::raw::unpack( ds, id );
+                  fc::raw::unpack( ds, validated );
+                  fc::raw::unpack( ds, in_current_chain );
+                  fc::raw::unpack( ds, bft_irreversible_blocknum );
+                  auto itr = index.find( id );
+                  if( itr != index.end() ) {
+                     auto& s = *states[itr->second];
+                     s.validated = validated;
+                     s.in_current_chain = in_current_chain;
+                     s.bft_irreversible_blocknum = bft_irreversible_blocknum;
+                  }
+                  break;
+               }
+               case fork_db_record::confirmation: {
+                  header_confirmation c;
+                  fc::raw::unpack( ds, c );
+                  auto itr = index.find( c.block_id );
+                  if( itr != index.end() )
+                     states[itr->second]->add_confirmation( c );
+                  break;
+               }
+               case fork_db_record::head:
+                  fc::raw::unpack( ds, head_id );
+                  closed = true;
+                  break;
+               default:
+                  wlog( "unknown record in fork database file, discarding it" );
+                  return {};
+            }
+         }
+
+         if( !closed ) {
+            wlog( "fork database was not closed cleanly, discarding it" );
+            return {};
+         }
+         states.erase( std::remove( states.begin(), states.end(), block_state_ptr() ), states.end() );
+         return states;
+      }
    };
 
 
@@ -57,51 +385,60 @@ namespace snax { namespace chain {
 
       auto fork_db_dat = my->datadir / config::forkdb_filename;
       if( fc::exists( fork_db_dat ) ) {
-         string content;
-         fc::read_file_contents( fork_db_dat, content );
-
-         fc::datastream<const char*> ds( content.data(), content.size() );
-         unsigned_int size; fc::raw::unpack( ds, size );
-         for( uint32_t i = 0, n = size.value; i < n; ++i ) {
-            block_state s;
-            fc::raw::unpack( ds, s );
-            set( std::make_shared<block_state>( move( s ) ) );
-         }
+         vector<block_state_ptr> states;
          block_id_type head_id;
-         fc::raw::unpack( ds, head_id );
+         try {
+            states = my->read( head_id );
+         } catch( const fc::exception& e ) {
+            wlog( "unable to read fork database file, discarding it: ${e}", ("e", e.to_detail_string()) );
+            states.clear();
+         }
 
-         my->head = get_block( head_id );
+         // previous blocks first so every block is linked to the one it builds on
+         std::stable_sort( states.begin(), states.end(), []( const block_state_ptr& a, const block_state_ptr& b ) {
+            return a->block_num < b->block_num;
+         });
+         for( auto& s : states )
+            set( std::move( s ) );
 
-         fc::remove( fork_db_dat );
+         my->head = get_block( head_id );
       }
+
+      // everything from here on is appended, a file that is not closed is discarded on the next start
+      my->rewrite();
    }
 
    void fork_database::close() {
-      if( my->index.size() == 0 ) return;
+      if( !my->logging ) return;
 
       auto fork_db_dat = my->datadir / config::forkdb_filename;
-      std::ofstream out( fork_db_dat.generic_string().c_str(), std::ios::out | std::ios::binary | std::ofstream::trunc );
-      uint32_t num_blocks_in_fork_db = my->index.size();
-      fc::raw::pack( out, unsigned_int{num_blocks_in_fork_db} );
-      for( const auto& s : my->index ) {
-         fc::raw::pack( out, *s );
+      if( my->size() == 0 ) {
+         my->log.close();
+         my->logging = false;
+         fc::remove( fork_db_dat );
+         return;
       }
-      if( my->head )
-         fc::raw::pack( out, my->head->id );
-      else
-         fc::raw::pack( out, block_id_type() );
+
+      my->append_id( fork_db_record::head, my->head ? my->head->id : block_id_type() );
+      my->log.close();
+      my->logging = false;
 
       /// we don't normally indicate the head block as irreversible
       /// we cannot normally prune the lib if it is the head block because
       /// the next block needs to build off of the head block. We are exiting
       /// now so we can prune this block as irreversible before exiting.
+      /// The file is already closed, it keeps this block for the next start.
       auto lib    = my->head->dpos_irreversible_blocknum;
-      auto oldest = *my->index.get<by_block_num>().begin();
+      auto oldest = my->nodes[my->oldest()].state;
       if( oldest->block_num <= lib ) {
          prune( oldest );
       }
 
-      my->index.clear();
+      my->slot_by_id.clear();
+      my->slots_by_num.clear();
+      my->nodes.clear();
+      my->free_slots.clear();
+      my->best = npos;
    }
 
    fork_database::~fork_database() {
@@ -109,13 +446,10 @@ namespace snax { namespace chain {
    }
 
    void fork_database::set( block_state_ptr s ) {
-      auto result = my->index.insert( s );
-      SNAX_ASSERT( s->id == s->header.id(), fork_database_exception,
-                  "block state id (${id}) is different from block state header id (${hid})", ("id", string(s->id))("hid", string(s->header.id())) );
+      my->insert( s );
 
          //FC_ASSERT( s->block_num == s->header.block_num() );
 
-      SNAX_ASSERT( result.second, fork_database_exception, "unable to insert block state, duplicate state detected" );
       if( !my->head ) {
          my->head =  s;
       } else if( my->head->block_num < s->block_num ) {
@@ -128,21 +462,21 @@ namespace snax { namespace chain {
       SNAX_ASSERT( my->head, fork_db_block_not_found, "no head block set" );
 
       if( !skip_validate_previous ) {
-         auto prior = my->index.find( n->block->previous );
-         SNAX_ASSERT( prior != my->index.end(), unlinkable_block_exception,
+         SNAX_ASSERT( my->find( n->block->previous ) != npos, unlinkable_block_exception,
                      "unlinkable block", ("id", n->block->id())("previous", n->block->previous) );
       }
 
-      auto inserted = my->index.insert(n);
-      SNAX_ASSERT( inserted.second, fork_database_exception, "duplicate block added?" );
+      SNAX_ASSERT( my->find( n->id ) == npos, fork_database_exception, "duplicate block added?" );
+      my->insert( n );
 
-      my->head = *my->index.get<by_lib_block_num>().begin();
+      my->head = my->best_state();
 
       auto lib    = my->head->dpos_irreversible_blocknum;
-      auto oldest = *my->index.get<by_block_num>().begin();
+      auto oldest = my->oldest();
 
-      if( oldest->block_num < lib ) {
-         prune( oldest );
+      if( my->nodes[oldest].block_num < lib ) {
+         // a copy, pruning empties the slot
+         prune( block_state_ptr( my->nodes[oldest].state ) );
       }
 
       return n;
@@ -152,14 +486,12 @@ namespace snax { namespace chain {
       SNAX_ASSERT( b, fork_database_exception, "attempt to add null block" );
       SNAX_ASSERT( my->head, fork_db_block_not_found, "no head block set" );
 
-      const auto& by_id_idx = my->index.get<by_block_id>();
-      auto existing = by_id_idx.find( b->id() );
-      SNAX_ASSERT( existing == by_id_idx.end(), fork_database_exception, "we already know about this block" );
+      SNAX_ASSERT( my->find( b->id() ) == npos, fork_database_exception, "we already know about this block" );
 
-      auto prior = by_id_idx.find( b->previous );
-      SNAX_ASSERT( prior != by_id_idx.end(), unlinkable_block_exception, "unlinkable block", ("id", string(b->id()))("previous", string(b->previous)) );
+      auto prior = my->find( b->previous );
+      SNAX_ASSERT( prior != npos, unlinkable_block_exception, "unlinkable block", ("id", string(b->id()))("previous", string(b->previous)) );
 
-      auto result = std::make_shared<block_state>( **prior, move(b), skip_validate_signee );
+      auto result = std::make_shared<block_state>( *my->nodes[prior].state, move(b), skip_validate_signee );
       SNAX_ASSERT( result, fork_database_exception , "fail to add new block state" );
       return add(result, true);
    }
@@ -173,60 +505,50 @@ namespace snax { namespace chain {
    pair< branch_type, branch_type >  fork_database::fetch_branch_from( const block_id_type& first,
                                                                        const block_id_type& second )const {
       pair<branch_type,branch_type> result;
-      auto first_branch = get_block(first);
-      auto second_branch = get_block(second);
+      const auto& nodes = my->nodes;
+      auto first_branch = my->find(first);
+      auto second_branch = my->find(second);
+      SNAX_ASSERT( first_branch != npos, fork_db_block_not_found, "block ${id} does not exist", ("id", string(first)) );
+      SNAX_ASSERT( second_branch != npos, fork_db_block_not_found, "block ${id} does not exist", ("id", string(second)) );
+
+      // follow the arena links, only the blocks returned are copied
+      auto step = [&]( uint32_t slot ) {
+         auto prev = nodes[slot].prev;
+         SNAX_ASSERT( prev != npos, fork_db_block_not_found, "block ${id} does not exist", ("id", string(nodes[slot].state->header.previous)) );
+         return prev;
+      };
 
-      while( first_branch->block_num > second_branch->block_num )
+      while( nodes[first_branch].block_num > nodes[second_branch].block_num )
       {
-         result.first.push_back(first_branch);
-         first_branch = get_block( first_branch->header.previous );
-         SNAX_ASSERT( first_branch, fork_db_block_not_found, "block ${id} does not exist", ("id", string(first_branch->header.previous)) );
+         result.first.push_back( nodes[first_branch].state );
+         first_branch = step( first_branch );
       }
 
-      while( second_branch->block_num > first_branch->block_num )
+      while( nodes[second_branch].block_num > nodes[first_branch].block_num )
       {
-         result.second.push_back( second_branch );
-         second_branch = get_block( second_branch->header.previous );
-         SNAX_ASSERT( second_branch, fork_db_block_not_found, "block ${id} does not exist", ("id", string(second_branch->header.previous)) );
+         result.second.push_back( nodes[second_branch].state );
+         second_branch = step( second_branch );
       }
 
-      while( first_branch->header.previous != second_branch->header.previous )
+      while( nodes[first_branch].state->header.previous != nodes[second_branch].state->header.previous )
       {
-         result.first.push_back(first_branch);
-         result.second.push_back(second_branch);
-         first_branch = get_block( first_branch->header.previous );
-         second_branch = get_block( second_branch->header.previous );
-         SNAX_ASSERT( first_branch && second_branch, fork_db_block_not_found,
-                     "either block ${fid} or ${sid} does not exist",
-                     ("fid", string(first_branch->header.previous))("sid", string(second_branch->header.previous)) );
+         result.first.push_back( nodes[first_branch].state );
+         result.second.push_back( nodes[second_branch].state );
+         first_branch = step( first_branch );
+         second_branch = step( second_branch );
       }
 
-      if( first_branch && second_branch )
-      {
-         result.first.push_back(first_branch);
-         result.second.push_back(second_branch);
-      }
+      result.first.push_back( nodes[first_branch].state );
+      result.second.push_back( nodes[second_branch].state );
       return result;
    } /// fetch_branch_from
 
    /// remove all of the invalid forks built of this id including this id
    void fork_database::remove( const block_id_type& id ) {
-      vector<block_id_type> remove_queue{id};
-
-      for( uint32_t i = 0; i < remove_queue.size(); ++i ) {
-         auto itr = my->index.find( remove_queue[i] );
-         if( itr != my->index.end() )
-            my->index.erase(itr);
-
-         auto& previdx = my->index.get<by_prev>();
-         auto  previtr = previdx.lower_bound(remove_queue[i]);
-         while( previtr != previdx.end() && (*previtr)->header.previous == remove_queue[i] ) {
-            remove_queue.push_back( (*previtr)->id );
-            ++previtr;
-         }
-      }
-      //wdump((my->index.size()));
-      my->head = *my->index.get<by_lib_block_num>().begin();
+      auto slot = my->find( id );
+      if( slot != npos )
+         my->erase_tree( slot );
+      my->head = my->best_state();
    }
 
    void fork_database::set_validity( const block_state_ptr& h, bool valid ) {
@@ -235,6 +557,9 @@ namespace snax { namespace chain {
       } else {
          /// remove older than irreversible and mark block as valid
          h->validated = true;
+         auto slot = my->find( h->id );
+         if( slot != npos )
+            my->set_flags( slot );
       }
    }
 
@@ -242,69 +567,72 @@ namespace snax { namespace chain {
       if( h->in_current_chain == in_current_chain )
          return;
 
-      auto& by_id_idx = my->index.get<by_block_id>();
-      auto itr = by_id_idx.find( h->id );
-      SNAX_ASSERT( itr != by_id_idx.end(), fork_db_block_not_found, "could not find block in fork database" );
+      auto slot = my->find( h->id );
+      SNAX_ASSERT( slot != npos, fork_db_block_not_found, "could not find block in fork database" );
 
-      by_id_idx.modify( itr, [&]( auto& bsp ) { // Need to modify this way rather than directly so that Boost MultiIndex can re-sort
-         bsp->in_current_chain = in_current_chain;
-      });
+      my->nodes[slot].state->in_current_chain = in_current_chain;
+      my->set_flags( slot );
    }
 
    void fork_database::prune( const block_state_ptr& h ) {
       try {
           auto num = h->block_num;
 
-          auto& by_bn = my->index.get<by_block_num>();
-          auto bni = by_bn.begin();
-          while( bni != by_bn.end() && (*bni)->block_num < num ) {
-             prune( *bni );
-             bni = by_bn.begin();
-          }
-
-          auto itr = my->index.find( h->id );
-          if( itr != my->index.end() ) {
-             irreversible(*itr);
-             my->index.erase(itr);
+          // the blocks left at an irreversible block number are on dead forks, so is what builds on them
+          auto remove_forks = [&]( uint32_t bn ) {
+             bool removed = false;
+             for( auto* slots = my->slots_at( bn ); slots && !slots->empty(); slots = my->slots_at( bn ) ) {
+                my->erase_tree( slots->front() );
+                removed = true;
+             }
+             if( removed )
+                my->head = my->best_state();
+          };
+
+          auto prune_slot = [&]( uint32_t slot ) {
+             auto bn = my->nodes[slot].block_num;
+             irreversible( my->nodes[slot].state );
+             my->erase( slot );
+             remove_forks( bn );
+          };
+
+          while( !my->slots_by_num.empty() && my->first_num < num ) {
+             prune_slot( my->oldest() );
           }
 
-          auto& numidx = my->index.get<by_block_num>();
-          auto nitr = numidx.lower_bound( num );
-          while( nitr != numidx.end() && (*nitr)->block_num == num ) {
-             auto itr_to_remove = nitr;
-             ++nitr;
-             auto id = (*itr_to_remove)->id;
-             remove( id );
-          }
+          auto slot = my->find( h->id );
+          if( slot != npos )
+             prune_slot( slot );
+          else
+             remove_forks( num );
       } catch (...) {
           wlog("Failed to prune object: ${object}", ("object", h));
       }
    }
 
    block_state_ptr   fork_database::get_block(const block_id_type& id)const {
-      auto itr = my->index.find( id );
-      if( itr != my->index.end() )
-         return *itr;
+      auto slot = my->find( id );
+      if( slot != npos )
+         return my->nodes[slot].state;
       return block_state_ptr();
    }
 
    block_state_ptr   fork_database::get_block_in_current_chain_by_num( uint32_t n )const {
-      const auto& numidx = my->index.get<by_block_num>();
-      auto nitr = numidx.lower_bound( n );
-      // following asserts removed so null can be returned
-      //FC_ASSERT( nitr != numidx.end() && (*nitr)->block_num == n,
-      //           "could not find block in fork database with block number ${block_num}", ("block_num", n) );
-      //FC_ASSERT( (*nitr)->in_current_chain == true,
-      //           "block (with block number ${block_num}) found in fork database is not in the current chain", ("block_num", n) );
-      if( nitr == numidx.end() || (*nitr)->block_num != n || (*nitr)->in_current_chain != true )
-         return block_state_ptr();
-      return *nitr;
+      const auto* slots = my->slots_at( n );
+      if( slots ) {
+         for( auto slot : *slots ) {
+            if( my->nodes[slot].in_current_chain )
+               return my->nodes[slot].state;
+         }
+      }
+      return block_state_ptr();
    }
 
    void fork_database::add( const header_confirmation& c ) {
       auto b = get_block( c.block_id );
       SNAX_ASSERT( b, fork_db_block_not_found, "unable to find block id ${id}", ("id",c.block_id));
       b->add_confirmation( c );
+      my->append_confirmation( c );
 
       if( b->bft_irreversible_blocknum < b->block_num &&
          b->confirmations.size() >= ((b->active_schedule.producers.size() * 2) / 3 + 1) ) {
@@ -320,42 +648,26 @@ namespace snax { namespace chain {
     *  This will require a search over all forks
     */
    void fork_database::set_bft_irreversible( block_id_type id ) {
-      auto& idx = my->index.get<by_block_id>();
-      auto itr = idx.find(id);
-      uint32_t block_num = (*itr)->block_num;
-      idx.modify( itr, [&]( auto& bsp ) {
-           bsp->bft_irreversible_blocknum = bsp->block_num;
-      });
+      auto slot = my->find( id );
+      SNAX_ASSERT( slot != npos, fork_db_block_not_found, "unable to find block id ${id}", ("id", id) );
+      auto& nodes = my->nodes;
+      uint32_t block_num = nodes[slot].block_num;
+      nodes[slot].state->bft_irreversible_blocknum = block_num;
+      my->set_flags( slot );
 
       /** to prevent stack-overflow, we perform a bredth-first traversal of the
-       * fork database. At each stage we iterate over the leafs from the prior stage
-       * and find all nodes that link their previous. If we update the bft lib then we
-       * add it to a queue for the next layer.  This lambda takes one layer and returns
-       * all block ids that need to be iterated over for next layer.
+       * fork database over the child links of the arena. Blocks whose bft lib is
+       * updated are queued so the blocks built on them are visited next.
        */
-      auto update = [&]( const vector<block_id_type>& in ) {
-         vector<block_id_type> updated;
-
-         for( const auto& i : in ) {
-            auto& pidx = my->index.get<by_prev>();
-            auto pitr  = pidx.lower_bound( i );
-            auto epitr = pidx.upper_bound( i );
-            while( pitr != epitr ) {
-               pidx.modify( pitr, [&]( auto& bsp ) {
-                 if( bsp->bft_irreversible_blocknum < block_num ) {
-                    bsp->bft_irreversible_blocknum = block_num;
-                    updated.push_back( bsp->id );
-                 }
-               });
-               ++pitr;
+      vector<uint32_t> queue{slot};
+      for( size_t i = 0; i < queue.size(); ++i ) {
+         for( auto child = nodes[queue[i]].first_child; child != npos; child = nodes[child].next_sibling ) {
+            if( nodes[child].bft_irreversible_blocknum < block_num ) {
+               nodes[child].state->bft_irreversible_blocknum = block_num;
+               my->set_flags( child );
+               queue.push_back( child );
             }
          }
-         return updated;
-      };
-
-      vector<block_id_type> queue{id};
-      while( queue.size() ) {
-         queue = update( queue );
       }
    }
 
@@ -10,6 +10,9 @@
 
 #include <utility>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 namespace snax { namespace chain {
 
@@ -115,12 +118,41 @@ namespace snax { namespace chain {
                                                       fc::microseconds provided_delay = fc::microseconds(0)
                                                     )const;
 
+         /**
+          *  Incremented whenever a permission or a permission link is created, modified or removed, and whenever
+          *  such a change is undone. While it and the chain configuration stay the same, an authorization check
+          *  gives the same result.
+          */
+         uint64_t revision()const { return _revision; }
+
+         /// to be called by the native linkauth and unlinkauth handlers after changing a link of `account` to `code`
+         void     permission_link_changed( account_name account, account_name code );
+
+         /**
+          *  To be called after an undo session is undone, with the revision at the time the session started.
+          *  Drops the cached authorities and links if permissions or links changed within the session.
+          */
+         void     undone( uint64_t session_revision );
+
+         /// to be called after undoing changes of unknown sessions, e.g. popping a block
+         void     clear_cache();
 
          static std::function<void()> _noop_checktime;
 
       private:
          const controller&    _control;
          chainbase::database& _db;
+         uint64_t             _revision = 0;
+
+         using link_key = std::tuple<account_name, account_name, action_name>;
+
+         /// authorities and links as of the current revision, locked since the const checks may run on any thread
+         mutable std::mutex                                                   _cache_mutex;
+         mutable map<permission_level, std::shared_ptr<const authority>>      _authority_cache;
+         mutable map<link_key, optional<permission_name>>                     _link_cache;
+
+         void                             permission_changed( const permission_level& level );
+         std::shared_ptr<const authority> get_cached_authority( const permission_level& level )const;
 
          void             check_updateauth_authorization( const updateauth& update, const vector<permission_level>& auths )const;
          void             check_deleteauth_authorization( const deleteauth& del, const vector<permission_level>& auths )const;
@@ -10,6 +10,7 @@
 namespace snax { namespace chain {
 
    namespace detail { class block_log_impl; }
+   class block_log_reader;
 
    /* The block log is an external append only log of the blocks with a header. Blocks should only
     * be written to the log after they irreverisble as the log is append only. The log is a doubly
@@ -34,11 +35,17 @@ namespace snax { namespace chain {
     *
     * The main file is the only file that needs to persist. The index file can be reconstructed during a
     * linear scan of the main file.
+    *
+    * A segmented log moves the blocks in blocks.log to a completed segment once it holds `segment_blocks`
+    * blocks and continues with an empty blocks.log. A segment is a block log of its own, named
+    * blocks-<first>-<last>.log with its index next to it, and is never written again. Only the newest
+    * `retained_segments` segments are kept, older ones are deleted with their blocks. Blocks are read
+    * across segments, recovering and reindexing only ever touch a single segment.
     */
 
    class block_log {
       public:
-         block_log(const fc::path& data_dir);
+         block_log(const fc::path& data_dir, uint32_t segment_blocks = 0, uint32_t retained_segments = 0);
          block_log(block_log&& other);
          ~block_log();
 
@@ -53,12 +60,35 @@ namespace snax { namespace chain {
          }
 
          /**
-          * Return offset of block in file, or block_log::npos if it does not exist.
+          * Decode only the signed_block_header prefix of the block at the given position,
+          * skipping the transactions and extensions that follow it.
+          */
+         signed_block_header read_block_header(uint64_t file_pos)const;
+         optional<signed_block_header> read_block_header_by_num(uint32_t block_num)const;
+
+         /**
+          * Return the headers of up to `count` consecutive blocks starting at `block_num`, stopping
+          * at the head of the log. Positions are read from the index in one go.
+          */
+         vector<signed_block_header> read_block_headers_by_num(uint32_t block_num, uint32_t count)const;
+
+         /**
+          * Return offset of block in blocks.log, or block_log::npos if it is not in that file.
           */
          uint64_t get_block_pos(uint32_t block_num) const;
          signed_block_ptr        read_head()const;
          const signed_block_ptr& head()const;
-         uint32_t                first_block_num() const;
+         uint32_t                first_block_num() const;   ///< of the oldest retained segment
+
+         /**
+          * Block ranges of the completed segments, oldest first; blocks.log continues after the last one.
+          */
+         vector<std::pair<uint32_t, uint32_t>> segment_ranges() const;
+
+         /**
+          * Reader of the blocks appended so far that other threads may use while this log is written.
+          */
+         std::shared_ptr<const block_log_reader> get_reader() const;
 
          static const uint64_t npos = std::numeric_limits<uint64_t>::max();
 
@@ -69,9 +99,19 @@ namespace snax { namespace chain {
 
          static genesis_state extract_genesis_state( const fc::path& data_dir );
 
+         /**
+          * Write the index of the log in `block_file` to `index_file`. The log is split into ranges at
+          * block boundaries found from the position words, each range is walked back along them on one
+          * of `thread_count` threads (0 for one per core) and the results are stitched together.
+          */
+         static void construct_index( const fc::path& block_file, const fc::path& index_file, uint32_t thread_count = 0 );
+
       private:
          void open(const fc::path& data_dir);
          void construct_index();
+         void roll_segment();
+         void reset_active( const genesis_state& gs, const signed_block_ptr& first_block, uint32_t first_block_num );
+         signed_block_ptr read_active_head()const;
 
          std::unique_ptr<detail::block_log_impl> my;
    };
@@ -0,0 +1,85 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+#include <fc/filesystem.hpp>
+#include <snax/chain/block.hpp>
+#include <mutex>
+
+namespace snax { namespace chain {
+
+   namespace detail { struct block_log_mapping; struct block_log_published; }
+
+   /**
+    * Read only view of blocks.log which any number of threads may use at once.
+    *
+    * blocks.log and blocks.index are memory mapped and blocks are decoded straight from the mapping,
+    * with their positions taken from the index. The block_log writing the files publishes its new head
+    * after every append; readers never look past the published head. The files are mapped with room
+    * beyond their size at the time, which the blocks appended later fill in, so they are only mapped
+    * anew once a block lies past that reserve. A mapping is released when the last reader using it is
+    * done, so a remap never pulls memory from under a concurrent read.
+    *
+    * Every reset() starts a new generation of the files. A read works on the published state it loaded
+    * and only uses a mapping of that generation, so a read still under way when the writer replaces the
+    * files finishes on the old ones, which stay mapped. Mappings are only made under a mutex which
+    * reset() takes as well, and not for a generation that has ended.
+    *
+    * Decoding happens outside of any lock, but the published state and the current mapping are
+    * exchanged through the atomic shared_ptr functions, which libstdc++ implements with a small pool
+    * of mutexes; a read takes one of them briefly. Of a segmented log only the blocks still in
+    * blocks.log are served.
+    */
+   class block_log_reader {
+      public:
+         explicit block_log_reader(const fc::path& data_dir);
+         ~block_log_reader();
+
+         signed_block_ptr              read_block_by_num(uint32_t block_num)const;
+         optional<signed_block_header> read_block_header_by_num(uint32_t block_num)const;
+
+         /**
+          * Return offset of block in file, or block_log::npos if it is not published.
+          */
+         uint64_t get_block_pos(uint32_t block_num)const;
+
+         uint32_t first_block_num()const;
+         uint32_t head_block_num()const;   ///< 0 while no block is published
+
+         /**
+          * Called by the writer once the blocks up to `head_block_num` are flushed to the files, blocks.log
+          * being `log_size` bytes long then.
+          */
+         void publish(uint32_t first_block_num, uint32_t head_block_num, uint64_t log_size);
+
+         /**
+          * Called by the writer before it renames, removes or replaces the files. Reads under way finish on
+          * the files as they were; nothing is served again until the next publish.
+          */
+         void reset();
+
+      private:
+         using published_ptr = std::shared_ptr<const detail::block_log_published>;
+         using mapping_ptr = std::shared_ptr<const detail::block_log_mapping>;
+
+         /// the mapping holding block_num in the state it returns, nullptr if block_num isn't published
+         std::pair<mapping_ptr, published_ptr> mapping_for(uint32_t block_num)const;
+         /// nullptr if the generation of `state` has ended
+         mapping_ptr remap(const detail::block_log_published& state, uint32_t head_block_num)const;
+
+         template<typename T>
+         bool unpack_block(uint32_t block_num, T& value)const;
+
+         fc::path                 block_file;
+         fc::path                 index_file;
+
+         mutable std::mutex       remap_mutex;
+         uint64_t                 generation = 0;   ///< guarded by remap_mutex
+
+         /// only accessed through std::atomic_load / std::atomic_store
+         published_ptr            published;
+         mutable mapping_ptr      current;
+   };
+
+} }
@@ -0,0 +1,56 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+#include <fc/filesystem.hpp>
+#include <snax/chain/types.hpp>
+
+namespace snax { namespace chain {
+
+   namespace detail { class block_slot_index_impl; }
+
+   /* The block slot index is a memory mapped file next to blocks.log that maps a block timestamp
+    * slot to the number of the irreversible block produced in it. It holds one 4 byte entry for
+    * every slot from the first indexed block on, missed slots hold 0.
+    *
+    * +--------+-----------------------+---------------------------+-----+----------------------+
+    * | Header | Block in first slot   | Block in first slot + 1   | ... | Block in head slot   |
+    * +--------+-----------------------+---------------------------+-----+----------------------+
+    *
+    * The index is only a cache of the block timestamps in the block log and can be reconstructed
+    * during a linear scan of the block headers.
+    */
+
+   class block_slot_index {
+      public:
+         block_slot_index(const fc::path& data_dir);
+         block_slot_index(block_slot_index&& other);
+         ~block_slot_index();
+
+         /**
+          * Record that `block_num` was produced in `slot`, slots must be strictly increasing.
+          */
+         void append(uint32_t slot, uint32_t block_num);
+         void flush();
+         void reset();
+
+         /**
+          * Return the number of the block produced in `slot`, or 0 if the slot was missed or is not indexed.
+          */
+         uint32_t block_num_for_slot(uint32_t slot)const;
+
+         bool                    empty()const;
+         uint32_t                first_slot()const;
+         uint32_t                head_slot()const;
+         uint32_t                head_block_num()const;
+
+         static const uint32_t   supported_version;
+
+      private:
+         void open(const fc::path& data_dir);
+
+         std::unique_ptr<detail::block_slot_index_impl> my;
+   };
+
+} }
@@ -0,0 +1,78 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+#include <fc/filesystem.hpp>
+#include <snax/chain/types.hpp>
+#include <snax/chain/incremental_merkle.hpp>
+
+namespace snax { namespace chain {
+
+   namespace detail { class blockroot_merkle_log_impl; }
+
+   /* The blockroot merkle log is an append only, memory mapped index of the blockroot_merkle
+    * (the incremental merkle of all previous block ids) of irreversible blocks. It lives next
+    * to blocks.log and consists of two files:
+    *
+    * blockroot_merkle.index: a small header followed by one fixed size checkpoint slot every
+    * `stride` blocks, starting at the first indexed block.
+    *
+    * +--------+-------------------+--------------------------+-----+
+    * | Header | Merkle of first   | Merkle of first + stride | ... |
+    * +--------+-------------------+--------------------------+-----+
+    *
+    * blockroot_merkle.ids: the id of every indexed block.
+    *
+    * +------------------+----------------------+-----+---------------+
+    * | Id of first      | Id of first + 1      | ... | Id of head    |
+    * +------------------+----------------------+-----+---------------+
+    *
+    * The blockroot_merkle of any indexed block is found by reading the nearest checkpoint at or
+    * below it and appending at most stride - 1 contiguous ids, so a lookup costs O(1) I/O
+    * regardless of the chain height. Both files can be reconstructed during a linear scan of
+    * the block log.
+    */
+
+   class blockroot_merkle_log {
+      public:
+         blockroot_merkle_log(const fc::path& data_dir, uint32_t stride);
+         blockroot_merkle_log(blockroot_merkle_log&& other);
+         ~blockroot_merkle_log();
+
+         /**
+          * Append the block `block_num` whose blockroot_merkle (the merkle of the ids of all blocks
+          * before it) is `merkle`. Blocks must be appended in order; the first block appended to
+          * an empty log becomes its first block.
+          */
+         void append(uint32_t block_num, const block_id_type& id, const incremental_merkle& merkle);
+         void flush();
+
+         /**
+          * Drop all entries, the next append starts a new log.
+          */
+         void reset();
+
+         /**
+          * Return the blockroot_merkle of the given block, or an empty optional if it is not indexed.
+          */
+         optional<incremental_merkle> read_merkle_by_num(uint32_t block_num)const;
+         optional<block_id_type>      read_id_by_num(uint32_t block_num)const;
+
+         bool                    empty()const;
+         uint32_t                first_block_num()const;
+         uint32_t                head_block_num()const;
+         uint32_t                stride()const;
+
+         /// enough active nodes for a tree of 2^32 leaves
+         static const uint32_t   max_active_nodes = 33;
+
+         static const uint32_t   supported_version;
+
+      private:
+         void open(const fc::path& data_dir);
+
+         std::unique_ptr<detail::blockroot_merkle_log_impl> my;
+   };
+
+} }
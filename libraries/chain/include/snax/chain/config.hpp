@@ -20,6 +20,7 @@ const static auto default_reversible_guard_size = 2*1024*1024ll;/// 1MB * 340 bl
 
 const static auto default_state_dir_name     = "state";
 const static auto forkdb_filename            = "forkdb.dat";
+const static auto code_cache_dir_name        = "code_cache";
 const static auto default_state_size            = 1*1024*1024*1024ll;
 const static auto default_state_guard_size      =    128*1024*1024ll;
 
@@ -86,6 +87,10 @@ const static uint32_t   default_max_inline_action_size         = 4 * 1024;   //
 const static uint16_t   default_max_inline_action_depth        = 4;
 const static uint16_t   default_max_auth_depth                 = 6;
 const static uint16_t   default_controller_thread_pool_size    = 2;
+const static uint32_t   default_replay_read_ahead_blocks       = 1024;
+const static uint64_t   default_replay_read_ahead_size         = 64*1024*1024; ///< packed size of the blocks read ahead on replay
+const static uint32_t   default_blockroot_merkle_stride        = 64; ///< blocks between blockroot merkle checkpoints
+const static uint16_t   legacy_blockroot_merkle_extension      = 0xF; ///< block extension older block logs carry the blockroot merkle of every 64th block in
 
 const static uint32_t   min_net_usage_delta_between_base_and_max_for_trx  = 10*1024;
 // Should be large enough to allow recovery from badly set blockchain parameters without a hard fork
@@ -99,8 +104,10 @@ const static uint32_t   overhead_per_account_ram_bytes     = 2*1024; ///< overhe
 const static uint32_t   setcode_ram_bytes_multiplier       = 10;     ///< multiplier on contract size to account for multiple copies and cached compilation
 
 const static uint32_t   hashing_checktime_block_size       = 10*1024;  /// call checktime from hashing intrinsic once per this number of bytes
+const static uint32_t   max_cached_authorities             = 64*1024;  ///< authorization_manager drops its cached authorities or links on reaching this many
 
 const static snax::chain::wasm_interface::vm_type default_wasm_runtime = snax::chain::wasm_interface::vm_type::wabt;
+const static uint64_t   default_wasm_cache_size            = 512*1024*1024ll; ///< bytes of instantiated contract modules kept before evicting the least recently used
 const static uint32_t   default_abi_serializer_max_time_ms = 15*1000; ///< default deadline for abi serialization methods
 
 /**
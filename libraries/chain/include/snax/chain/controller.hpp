@@ -12,6 +12,13 @@ namespace chainbase
 {
 class database;
 }
+namespace boost
+{
+namespace asio
+{
+class thread_pool;
+}
+}
 
 namespace snax
 {
@@ -19,6 +26,7 @@ namespace chain
 {
 
 class authorization_manager;
+class block_log_reader;
 
 namespace resource_limits
 {
@@ -66,20 +74,30 @@ public:
       flat_set<pair<account_name, action_name>> action_blacklist;
       flat_set<public_key_type> key_blacklist;
       path blocks_dir = chain::config::default_blocks_dir_name;
+      uint32_t blocks_log_segment_size = 0;      ///< blocks per block log segment, 0 to not segment the log
+      uint32_t blocks_log_retained_segments = 0; ///< completed segments kept, 0 to keep all
+      uint32_t blockroot_merkle_stride = chain::config::default_blockroot_merkle_stride;
       path state_dir = chain::config::default_state_dir_name;
       uint64_t state_size = chain::config::default_state_size;
       uint64_t state_guard_size = chain::config::default_state_guard_size;
       uint64_t reversible_cache_size = chain::config::default_reversible_cache_size;
       uint64_t reversible_guard_size = chain::config::default_reversible_guard_size;
       uint16_t thread_pool_size = chain::config::default_controller_thread_pool_size;
+      uint32_t replay_read_ahead_blocks = chain::config::default_replay_read_ahead_blocks;
+      uint64_t replay_read_ahead_size = chain::config::default_replay_read_ahead_size;
       bool read_only = false;
       bool force_all_checks = false;
+      bool trusted_replay = false;                       ///< skip key recovery and authorization below the highest checkpoint in the block log
+      flat_map<uint32_t, block_id_type> checkpoints;
       bool disable_replay_opts = false;
       bool contracts_console = false;
+      bool persistent_code_cache = false;                ///< keep injected contract code in the code cache directory of state_dir
       bool allow_ram_billing_in_notify = false;
 
       genesis_state genesis;
       wasm_interface::vm_type wasm_runtime = chain::config::default_wasm_runtime;
+      uint64_t wasm_cache_size = chain::config::default_wasm_cache_size;
+      flat_set<account_name> wasm_cache_pinned_accounts = {N(snax), N(snax.token), N(platform)}; ///< their contracts are never evicted
 
       db_read_mode read_mode = db_read_mode::SPECULATIVE;
       validation_mode block_validation_mode = validation_mode::FULL;
@@ -192,11 +210,38 @@ public:
    signed_block_ptr fetch_block_by_number(uint32_t block_num) const;
    signed_block_ptr fetch_block_by_id(block_id_type id) const;
 
+   /**
+    * Headers only variants of fetch_block_by_number, irreversible blocks are decoded from the
+    * block log without their transactions. The range variant returns the headers of up to
+    * `count` consecutive blocks, stopping at the first block that is not available.
+    */
+   optional<signed_block_header> fetch_block_header_by_number(uint32_t block_num) const;
+   vector<signed_block_header> fetch_block_headers_by_number(uint32_t block_num, uint32_t count) const;
+
    block_state_ptr fetch_block_state_by_number(uint32_t block_num) const;
    block_state_ptr fetch_block_state_by_id(block_id_type id) const;
 
    block_id_type get_block_id_for_num(uint32_t block_num) const;
 
+   /**
+    * Return the number of the block produced in the given timestamp slot on the current chain,
+    * irreversible blocks are found with a single lookup in the block slot index.
+    */
+   optional<uint32_t> fetch_block_num_by_slot(uint32_t slot) const;
+
+   /**
+    * Return the blockroot_merkle (the incremental merkle of the ids of all blocks before it) of a block
+    * on the current chain, irreversible blocks are looked up in the checkpoint index next to the block
+    * log without reading any block.
+    */
+   optional<incremental_merkle> fetch_blockroot_merkle_by_num(uint32_t block_num) const;
+
+   /**
+    * Reader of the irreversible blocks in the block log which, unlike the fetch_* calls, may be used
+    * from any thread while the chain keeps appending to the log.
+    */
+   std::shared_ptr<const block_log_reader> get_block_log_reader() const;
+
    sha256 calculate_integrity_hash() const;
    void write_snapshot(const snapshot_writer_ptr &snapshot) const;
 
@@ -233,6 +278,11 @@ public:
 
    chain_id_type get_chain_id() const;
 
+   const config &get_config() const;
+
+   /// pool of config::thread_pool_size threads, for work that doesn't touch chain state
+   boost::asio::thread_pool &get_thread_pool();
+
    db_read_mode get_read_mode() const;
    validation_mode get_validation_mode() const;
 
@@ -259,6 +309,7 @@ public:
 
    const apply_handler *find_apply_handler(account_name contract, scope_name scope, action_name act) const;
    wasm_interface &get_wasm_interface();
+   const wasm_interface &get_wasm_interface() const;
 
    optional<abi_serializer> get_abi_serializer(account_name n, const fc::microseconds &max_serialization_time) const
    {
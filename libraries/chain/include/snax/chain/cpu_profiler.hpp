@@ -0,0 +1,100 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+#include <snax/chain/types.hpp>
+#include <boost/config.hpp>
+#include <atomic>
+#include <chrono>
+
+namespace snax { namespace chain { namespace cpu_profiler {
+
+   /**
+    * Optional wall clock profiling of transactions, action dispatch, WASM host function calls and
+    * db_*_i64 calls. Each thread aggregates its samples into log2 histograms of its own, updated
+    * without locking; a snapshot merges the histograms of all threads. While profiling is disabled
+    * a profile_scope costs one relaxed atomic load.
+    */
+
+   enum class sample_kind : uint8_t {
+      transaction,     ///< whole transaction, keyed by its first action
+      action,          ///< native and WASM handlers of one action on one receiver
+      host_function,   ///< one host function called by a contract
+      db               ///< one db_*_i64 call of a contract
+   };
+
+   struct sample_key {
+      sample_kind    kind = sample_kind::action;
+      account_name   receiver;
+      account_name   account;
+      action_name    action;
+      const char*    function = nullptr;  ///< host and db functions only, a string with static storage
+
+      friend bool operator == ( const sample_key& a, const sample_key& b ) {
+         return a.kind == b.kind && a.receiver == b.receiver && a.account == b.account
+             && a.action == b.action && a.function == b.function;
+      }
+   };
+
+   struct histogram_entry {
+      string            kind;
+      account_name      receiver;
+      account_name      account;
+      action_name       action;
+      string            function;
+      uint64_t          count = 0;
+      uint64_t          total_ns = 0;
+      uint64_t          max_ns = 0;
+      vector<uint64_t>  buckets;   ///< buckets[i] counts the samples taking [2^i, 2^(i+1)) ns, buckets[0] also those under 1 ns
+   };
+
+   /// samples of 2^(bucket_count-1) ns and longer, about 2 seconds, all go to the last bucket
+   const uint32_t bucket_count = 32;
+
+   extern std::atomic<bool> enabled_flag;
+
+   inline bool enabled() { return enabled_flag.load( std::memory_order_relaxed ); }
+   void set_enabled( bool enable );
+
+   /// only called by the thread taking the sample
+   void record( const sample_key& key, uint64_t ns );
+
+   /// the histograms of all threads merged, most total time first
+   vector<histogram_entry> snapshot();
+
+   /// drop all samples taken so far, each thread clears its histograms with its next sample
+   void reset();
+
+   class profile_scope {
+      public:
+         profile_scope( sample_kind kind, account_name receiver, account_name account = account_name(),
+                        action_name action = action_name(), const char* function = nullptr ) {
+            if( BOOST_UNLIKELY( enabled() ) ) {
+               key.kind = kind;
+               key.receiver = receiver;
+               key.account = account;
+               key.action = action;
+               key.function = function;
+               active = true;
+               start = std::chrono::steady_clock::now();
+            }
+         }
+
+         ~profile_scope() {
+            if( BOOST_UNLIKELY( active ) )
+               record( key, std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count() );
+         }
+
+         profile_scope( const profile_scope& ) = delete;
+         profile_scope& operator=( const profile_scope& ) = delete;
+
+      private:
+         sample_key                               key;
+         bool                                     active = false;
+         std::chrono::steady_clock::time_point    start;
+   };
+
+} } } /// snax::chain::cpu_profiler
+
+FC_REFLECT( snax::chain::cpu_profiler::histogram_entry, (kind)(receiver)(account)(action)(function)(count)(total_ns)(max_ns)(buckets) )
@@ -18,9 +18,14 @@ namespace snax { namespace chain {
     * database tracks the longest chain and the last irreversible block number. All
     * blocks older than the last irreversible block are freed after emitting the
     * irreversible signal.
+    *
+    * Block states live in an arena linked by slot, and every change is appended to
+    * forkdb.dat as it happens so closing only has to write the head block id.
     */
    class fork_database {
       public:
+         static const uint32_t magic_number;
+         static const uint32_t supported_version;
 
          fork_database( const fc::path& data_dir );
          ~fork_database();
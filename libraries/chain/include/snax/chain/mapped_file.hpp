@@ -0,0 +1,57 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+#include <fc/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace snax { namespace chain { namespace detail {
+
+   /**
+    * A read/write mapping of a whole file which grows the file in fixed chunks
+    * and remaps it when a write would land past the current end. Pointers into
+    * the mapping are invalidated by reserve().
+    */
+   class mapped_file {
+      public:
+         void open( const fc::path& p ) {
+            file = p;
+            if( !fc::exists( file ) )
+               std::ofstream( file.generic_string().c_str(), std::ios::out | std::ios::binary );
+            if( fc::file_size( file ) < grow_size )
+               boost::filesystem::resize_file( file, grow_size );
+            map();
+         }
+
+         char* reserve( uint64_t size ) {
+            if( size > region.get_size() ) {
+               region.flush();
+               region = boost::interprocess::mapped_region();
+               boost::filesystem::resize_file( file, ((size + grow_size - 1) / grow_size) * grow_size );
+               map();
+            }
+            return data();
+         }
+
+         char*    data()const { return static_cast<char*>( region.get_address() ); }
+         uint64_t size()const { return region.get_size(); }
+         void     flush() { region.flush(); }
+
+      private:
+         void map() {
+            mapping = boost::interprocess::file_mapping( file.generic_string().c_str(), boost::interprocess::read_write );
+            region  = boost::interprocess::mapped_region( mapping, boost::interprocess::read_write );
+         }
+
+         static const uint64_t grow_size = 1024*1024;
+
+         fc::path                           file;
+         boost::interprocess::file_mapping  mapping;
+         boost::interprocess::mapped_region region;
+   };
+
+} } } /// snax::chain::detail
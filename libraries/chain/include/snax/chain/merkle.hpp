@@ -19,4 +19,27 @@ namespace snax { namespace chain {
     */
    digest_type merkle( vector<digest_type> ids );
 
+   /**
+    *  A merkle tree over a fixed set of digests which keeps every layer, so that the root and
+    *  any number of inclusion paths can be read without rehashing. The root matches merkle().
+    */
+   class merkle_tree {
+      public:
+         merkle_tree() = default;
+         explicit merkle_tree( vector<digest_type> leaves );
+
+         digest_type root()const;
+         size_t      size()const { return _layers.empty() ? 0 : _layers.front().size(); }
+
+         /**
+          *  Inclusion path of the leaf at `index` as used by the ibc contracts: the leaf pair the
+          *  leaf belongs to, the canonical sibling of each inner node below the root, then the root.
+          *  A single leaf tree yields only the leaf. Empty if `index` is out of range.
+          */
+         vector<digest_type> get_path( uint32_t index )const;
+
+      private:
+         vector<vector<digest_type>> _layers;
+   };
+
 } } /// snax::chain
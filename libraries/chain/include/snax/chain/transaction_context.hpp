@@ -28,6 +28,7 @@ namespace snax { namespace chain {
                               const signed_transaction& t,
                               const transaction_id_type& trx_id,
                               fc::time_point start = fc::time_point::now() );
+         ~transaction_context();
 
          void init_for_implicit_trx( uint64_t initial_net_usage = 0 );
 
@@ -81,6 +82,7 @@ namespace snax { namespace chain {
          const signed_transaction&     trx;
          transaction_id_type           id;
          optional<chainbase::database::session>  undo_session;
+         uint64_t                      undo_session_auth_revision = 0; ///< authorization revision when undo_session started
          transaction_trace_ptr         trace;
          fc::time_point                start;
 
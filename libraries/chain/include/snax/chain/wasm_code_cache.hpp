@@ -0,0 +1,49 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+#include <snax/chain/types.hpp>
+#include <fc/filesystem.hpp>
+
+namespace snax { namespace chain {
+
+   /**
+    * On disk cache of contract code after the SNAX injections, keyed by the hash of the code as
+    * deployed. Each entry holds the injected WASM and the initial memory image parsed from it, so a
+    * restarted node instantiates a contract without parsing, injecting and reserializing it again.
+    *
+    * Every file carries the code hash it was written for, the cache version and a checksum of its
+    * contents; a file that doesn't match is removed and treated as missing.
+    */
+   class wasm_code_cache {
+      public:
+         struct entry {
+            std::vector<uint8_t>   code;
+            std::vector<uint8_t>   initial_memory;
+         };
+
+         /// an empty dir disables the cache
+         explicit wasm_code_cache( const fc::path& dir );
+
+         bool enabled()const { return !dir.empty(); }
+
+         optional<entry> get( const digest_type& code_id )const;
+
+         /// failing to write an entry is logged and otherwise ignored, the entry is just missing next time
+         void put( const digest_type& code_id, const entry& e )const;
+
+         void remove( const digest_type& code_id )const;
+
+         static const uint32_t magic_number;
+         static const uint32_t supported_version;
+
+      private:
+         fc::path file_of( const digest_type& code_id )const;
+
+         fc::path dir;
+   };
+
+} } /// snax::chain
+
+FC_REFLECT( snax::chain::wasm_code_cache::entry, (code)(initial_memory) )
@@ -0,0 +1,71 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+#include <snax/chain/types.hpp>
+#include <snax/chain/webassembly/runtime_interface.hpp>
+#include <list>
+
+namespace snax { namespace chain {
+
+   struct wasm_cache_stats {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t evictions = 0;
+      uint64_t entries = 0;
+      uint64_t pinned_entries = 0;
+      uint64_t memory_size = 0;      ///< approximate bytes held by the cached modules
+      uint64_t max_memory_size = 0;
+   };
+
+   /**
+    * The instantiated modules of contracts, keyed by code hash. Once the modules hold more than
+    * max_memory_size bytes, the least recently used ones are evicted until they fit again. The
+    * code of the pinned accounts is never evicted while they run it, so the system contracts
+    * don't have to be compiled again after a burst of other contracts; pinned modules still count
+    * against the size.
+    *
+    * A module is only evicted to make room for another one, never the one just added, so it is
+    * never destroyed while it could be running.
+    */
+   class wasm_instantiation_cache {
+      public:
+         wasm_instantiation_cache( uint64_t max_memory_size, const flat_set<account_name>& pinned_accounts );
+
+         /// the module of code_id run by receiver, nullptr if it isn't cached
+         wasm_instantiated_module_interface* get( const digest_type& code_id, account_name receiver );
+
+         wasm_instantiated_module_interface& add( const digest_type& code_id, account_name receiver,
+                                                  std::unique_ptr<wasm_instantiated_module_interface> module );
+
+         /// adds a module no one has run yet as the least recently used one, but only if it fits without evicting
+         /// another module; returns whether it was added
+         bool add_unused( const digest_type& code_id, std::unique_ptr<wasm_instantiated_module_interface> module );
+
+         bool contains( const digest_type& code_id )const { return entries.count( code_id ) > 0; }
+
+         const wasm_cache_stats& stats()const { return _stats; }
+
+      private:
+         struct entry {
+            std::unique_ptr<wasm_instantiated_module_interface>   module;
+            uint64_t                                              size = 0;
+            uint32_t                                              pins = 0;   ///< number of pinned accounts running this code
+            std::list<digest_type>::iterator                      lru_pos;
+         };
+
+         void touch( entry& e );
+         void pin( const digest_type& code_id, entry& e, account_name receiver );
+         void evict_for( uint64_t size );
+
+         flat_set<account_name>                 pinned_accounts;
+         map<account_name, digest_type>         pinned_code;
+         map<digest_type, entry>                entries;
+         std::list<digest_type>                 lru;        ///< most recently used first
+         wasm_cache_stats                       _stats;
+   };
+
+} } /// snax::chain
+
+FC_REFLECT( snax::chain::wasm_cache_stats, (hits)(misses)(evictions)(entries)(pinned_entries)(memory_size)(max_memory_size) )
@@ -1,14 +1,19 @@
 #pragma once
 #include <snax/chain/types.hpp>
 #include <snax/chain/exceptions.hpp>
+#include <fc/filesystem.hpp>
 #include "Runtime/Linker.h"
 #include "Runtime/Runtime.h"
 
+namespace boost { namespace asio { class thread_pool; } }
+namespace chainbase { class database; }
+
 namespace snax { namespace chain {
 
    class apply_context;
    class wasm_runtime_interface;
    class controller;
+   struct wasm_cache_stats;
 
    struct wasm_exit {
       int32_t code = 0;
@@ -56,7 +61,9 @@ namespace snax { namespace chain {
             wabt
          };
 
-         wasm_interface(vm_type vm);
+         /// injected contract code is kept in code_cache_dir across restarts, an empty path keeps it in memory only.
+         /// Instantiated modules are evicted beyond max_cache_size bytes, except those of the pinned accounts
+         wasm_interface(vm_type vm, const fc::path& code_cache_dir, uint64_t max_cache_size, const flat_set<account_name>& pinned_accounts);
          ~wasm_interface();
 
          //validates code -- does a WASM validation pass and checks the wasm against SNAX specific constraints
@@ -65,9 +72,21 @@ namespace snax { namespace chain {
          //Calls apply or error on a given code
          void apply(const digest_type& code_id, const shared_string& code, apply_context& context);
 
+         //Injects and instantiates code on the pool ahead of its first call. If that hasn't started by then, apply does it itself
+         void compile_ahead(const digest_type& code_id, const bytes& code, boost::asio::thread_pool& pool);
+
+         //Records that setcode set code_id as the code of account. Nothing is compiled until the block is accepted
+         void code_deployed(account_name account, const digest_type& code_id);
+
+         //Compiles ahead the code recorded by code_deployed that is still the account's code in db, so setcodes that
+         //were undone along with their transaction or block cost nothing
+         void compile_deployed(const chainbase::database& db, boost::asio::thread_pool& pool);
+
          //Immediately exits currently running wasm. UB is called when no wasm running
          void exit();
 
+         const wasm_cache_stats& get_cache_stats()const;
+
       private:
          unique_ptr<struct wasm_interface_impl> my;
          friend class snax::chain::webassembly::common::intrinsics_accessor;
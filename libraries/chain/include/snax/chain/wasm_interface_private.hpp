@@ -5,9 +5,16 @@
 #include <snax/chain/webassembly/wabt.hpp>
 #include <snax/chain/webassembly/runtime_interface.hpp>
 #include <snax/chain/wasm_snax_injection.hpp>
+#include <snax/chain/wasm_code_cache.hpp>
+#include <snax/chain/wasm_instantiation_cache.hpp>
 #include <snax/chain/transaction_context.hpp>
 #include <snax/chain/exceptions.hpp>
 #include <fc/scoped_exit.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <atomic>
+#include <future>
+#include <mutex>
 
 #include "IR/Module.h"
 #include "Runtime/Intrinsics.h"
@@ -23,7 +30,8 @@ using namespace Runtime;
 namespace snax { namespace chain {
 
    struct wasm_interface_impl {
-      wasm_interface_impl(wasm_interface::vm_type vm) {
+      wasm_interface_impl(wasm_interface::vm_type vm, const fc::path& code_cache_dir, uint64_t max_cache_size, const flat_set<account_name>& pinned_accounts)
+      : code_cache(code_cache_dir), instantiation_cache(max_cache_size, pinned_accounts) {
          if(vm == wasm_interface::vm_type::wavm)
             runtime_interface = std::make_unique<webassembly::wavm::wavm_runtime>();
          else if(vm == wasm_interface::vm_type::wabt)
@@ -50,50 +58,141 @@ namespace snax { namespace chain {
          return mem_image;
       }
 
-      std::unique_ptr<wasm_instantiated_module_interface>& get_instantiated_module( const digest_type& code_id,
-                                                                                    const shared_string& code,
-                                                                                    transaction_context& trx_context )
+      wasm_code_cache::entry inject(const char* code, size_t code_size) {
+         // the injectors keep their state in statics
+         static std::mutex injection_mutex;
+         std::lock_guard<std::mutex> lock(injection_mutex);
+
+         IR::Module module;
+         try {
+            Serialization::MemoryInputStream stream((const U8*)code, code_size);
+            WASM::serialize(stream, module);
+            module.userSections.clear();
+         } catch(const Serialization::FatalSerializationException& e) {
+            SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         } catch(const IR::ValidationException& e) {
+            SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         }
+
+         wasm_injections::wasm_binary_injection injector(module);
+         injector.inject();
+
+         wasm_code_cache::entry injected;
+         try {
+            Serialization::ArrayOutputStream outstream;
+            WASM::serialize(outstream, module);
+            injected.code = outstream.getBytes();
+         } catch(const Serialization::FatalSerializationException& e) {
+            SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         } catch(const IR::ValidationException& e) {
+            SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         }
+         injected.initial_memory = parse_initial_memory(module);
+         return injected;
+      }
+
+      std::unique_ptr<wasm_instantiated_module_interface> instantiate(const digest_type& code_id, const char* code, size_t code_size) {
+         auto cached = code_cache.get(code_id);
+         if(!cached) {
+            cached = inject(code, code_size);
+            code_cache.put(code_id, *cached);
+         }
+         return runtime_interface->instantiate_module((const char*)cached->code.data(), cached->code.size(), std::move(cached->initial_memory));
+      }
+
+      /// moves the modules compiled ahead into instantiation_cache, so they count against its size and are
+      /// evicted with the rest even if their code is never called. One that doesn't fit without evicting a
+      /// module in use is dropped
+      void collect_compiled() {
+         for(auto itr = compiling.begin(); itr != compiling.end(); ) {
+            auto& job = *itr->second;
+            if(job.module.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+               ++itr;
+               continue;
+            }
+            std::unique_ptr<wasm_instantiated_module_interface> module;
+            try {
+               module = job.module.get();
+            } catch(...) {
+               // compiled again when the code is called, so the error surfaces in that transaction
+            }
+            if(module)
+               instantiation_cache.add_unused(itr->first, std::move(module));
+            itr = compiling.erase(itr);
+         }
+      }
+
+      void compile_ahead(const digest_type& code_id, const bytes& code, boost::asio::thread_pool& pool) {
+         collect_compiled();
+         if(instantiation_cache.contains(code_id) || compiling.count(code_id))
+            return;
+
+         auto job = std::make_shared<compile_job>();
+         auto task = std::make_shared<std::packaged_task<std::unique_ptr<wasm_instantiated_module_interface>()>>(
+            [this, job, code_id, code]() -> std::unique_ptr<wasm_instantiated_module_interface> {
+               if(job->claimed.exchange(true))
+                  return nullptr;
+               return instantiate(code_id, code.data(), code.size());
+            });
+         job->module = task->get_future();
+         compiling.emplace(code_id, std::move(job));
+         boost::asio::post(pool, [task]() { (*task)(); });
+      }
+
+      wasm_instantiated_module_interface& get_instantiated_module( const digest_type& code_id,
+                                                                   const shared_string& code,
+                                                                   account_name receiver,
+                                                                   transaction_context& trx_context )
       {
-         auto it = instantiation_cache.find(code_id);
-         if(it == instantiation_cache.end()) {
+         if(!compiling.empty())
+            collect_compiled();
+         auto cached = instantiation_cache.get(code_id, receiver);
+         if(!cached) {
             auto timer_pause = fc::make_scoped_exit([&](){
                trx_context.resume_billing_timer();
             });
             trx_context.pause_billing_timer();
-            IR::Module module;
-            try {
-               Serialization::MemoryInputStream stream((const U8*)code.data(), code.size());
-               WASM::serialize(stream, module);
-               module.userSections.clear();
-            } catch(const Serialization::FatalSerializationException& e) {
-               SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
-            } catch(const IR::ValidationException& e) {
-               SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
-            }
-
-            wasm_injections::wasm_binary_injection injector(module);
-            injector.inject();
 
-            std::vector<U8> bytes;
-            try {
-               Serialization::ArrayOutputStream outstream;
-               WASM::serialize(outstream, module);
-               bytes = outstream.getBytes();
-            } catch(const Serialization::FatalSerializationException& e) {
-               SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
-            } catch(const IR::ValidationException& e) {
-               SNAX_ASSERT(false, wasm_serialization_error, e.message.c_str());
+            std::unique_ptr<wasm_instantiated_module_interface> module;
+            auto job = compiling.find(code_id);
+            if(job != compiling.end()) {
+               // wait for a compilation already under way, one that hasn't started yet is done right here instead
+               if(job->second->claimed.exchange(true)) {
+                  try {
+                     module = job->second->module.get();
+                  } catch(...) {
+                     // compiled again below, so the error surfaces in this transaction
+                  }
+               }
+               compiling.erase(job);
             }
-            it = instantiation_cache.emplace(code_id, runtime_interface->instantiate_module((const char*)bytes.data(), bytes.size(), parse_initial_memory(module))).first;
+            if(!module)
+               module = instantiate(code_id, code.data(), code.size());
+            cached = &instantiation_cache.add(code_id, receiver, std::move(module));
          }
-         return it->second;
+         return *cached;
       }
 
+      /// compilation of a module on the thread pool, claimed by either the task or get_instantiated_module, whichever comes first.
+      /// Finished ones are moved into instantiation_cache by collect_compiled
+      struct compile_job {
+         std::atomic<bool>                                                   claimed{false};
+         std::future<std::unique_ptr<wasm_instantiated_module_interface>>    module;
+      };
+
       std::unique_ptr<wasm_runtime_interface> runtime_interface;
-      map<digest_type, std::unique_ptr<wasm_instantiated_module_interface>> instantiation_cache;
+      wasm_code_cache code_cache;
+      wasm_instantiation_cache instantiation_cache;
+      map<digest_type, std::shared_ptr<compile_job>> compiling;
+      map<account_name, digest_type> deployed;   ///< code set since the last accepted block, compiled ahead once it is committed
    };
 
+#define _REGISTER_INTRINSIC_NAME(CLS, MOD, METHOD, NAME, SIG)\
+   static const char* _INTRINSIC_NAME(__intrinsic_name, __COUNTER__) =\
+      snax::chain::intrinsic_name<SIG, &CLS::METHOD>::value = MOD "." NAME;\
+
 #define _REGISTER_INTRINSIC_EXPLICIT(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)\
+   _REGISTER_INTRINSIC_NAME(CLS, MOD, METHOD, NAME, SIG)\
    _REGISTER_WAVM_INTRINSIC(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)\
    _REGISTER_WABT_INTRINSIC(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)
 
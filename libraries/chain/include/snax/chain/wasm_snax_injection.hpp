@@ -9,8 +9,6 @@
 #include <functional>
 #include <vector>
 #include <map>
-#include <stack>
-#include <queue>
 #include <unordered_set>
 #include "IR/Module.h"
 #include "IR/Operators.h"
@@ -156,102 +154,112 @@ namespace snax { namespace chain { namespace wasm_injections {
       }
    };
 
-   struct instruction_counter {
-      static constexpr bool kills = false;
-      static constexpr bool post = false;
-      static void init() { 
-         icnt=0; 
-         tcnt=0; 
-         bcnt=0; 
-         while ( !fcnts.empty() )
-            fcnts.pop();
-      }
-      static void accept( wasm_ops::instr* inst, wasm_ops::visitor_arg& arg ) {
-         icnt++;
-         tcnt++;
-      }
-      static uint32_t icnt; /* instructions so far */
-      static uint32_t tcnt; /* total instructions */
-      static uint32_t bcnt; /* total instructions from block types */
-      static std::queue<uint32_t> fcnts; 
-   };
+   /**
+    * Execution is metered instead of calling checktime on every loop iteration and every call. Each
+    * function body and each loop body is a region; on entering a region its instruction count, which is
+    * known statically, is taken from a budget kept in an injected global, and checktime is only called
+    * once the budget runs out, then the budget is refilled. Code within a region runs at most once per
+    * entry, so checktime is still called at least every instructions_per_checktime instructions plus the
+    * size of one region. Calls to host functions are still followed by checktime.
+    *
+    * A region's count is only known at its end, so its entry sequence is emitted with a placeholder
+    * that is patched then, counting and emitting happen in the same pass.
+    */
+   struct checktime_injection {
+      static constexpr uint32_t instructions_per_checktime = 10000;
 
-   struct checktime_block_type {
-      static constexpr bool kills = false;
-      static constexpr bool post = false;
-#define CLEAR(x) \
-      while( !x.empty() ) \
-         x.pop()
-
-      static void init() { 
-         CLEAR(block_stack);
-         CLEAR(type_stack);
-         CLEAR(orderings);
-         CLEAR(bcnt_tables);
+      static void init() {
+         chktm_idx = 0;
+         budget_idx = -1;
       }
-#undef CLEAR
-      static void accept( wasm_ops::instr* inst, wasm_ops::visitor_arg& arg ) {
-         instruction_counter::icnt = 0;
-         block_stack.push(arg.start_index);
-         orderings.back().push_back(arg.start_index);
-         bcnt_tables.back().emplace(arg.start_index, 0);
-         type_stack.push(inst->get_code() == wasm_ops::loop_code);
+
+      static void add_budget( Module& module ) {
+         module.globals.defs.push_back({{ValueType::i32, true}, {(I32) instructions_per_checktime}});
+         budget_idx = module.globals.size()-1;
       }
 
-      static std::stack<size_t>                   block_stack;
-      static std::stack<size_t>                   type_stack; /* this might capture more than if a block is a loop in the future */
-      static std::queue<std::vector<size_t>>      orderings;  /* record the order in which we found the blocks */
-      static std::queue<std::map<size_t, size_t>> bcnt_tables; /* table for each blocks instruction count */
+      static int32_t chktm_idx;
+      static int32_t budget_idx;
    };
 
-   struct checktime_end {
-      static constexpr bool kills = false;
-      static constexpr bool post = false;
-      static void init() {}
-      static void accept( wasm_ops::instr* inst, wasm_ops::visitor_arg& arg ) {
-         if ( checktime_block_type::type_stack.empty() ) 
-            return;
-         if ( !checktime_block_type::type_stack.top() ) { // empty or is not a loop
-            checktime_block_type::block_stack.pop();
-            checktime_block_type::type_stack.pop();
-            return;
+   class checktime_metering {
+      public:
+         explicit checktime_metering( wasm_ops::instruction_stream& code )
+         :code(code) {
+            chktm.field = injector_utils::injected_index_mapping.find(checktime_injection::chktm_idx)->second;
+            get_budget.field = checktime_injection::budget_idx;
+            set_budget.field = checktime_injection::budget_idx;
+            open_region();
          }
-         size_t inst_idx = checktime_block_type::block_stack.top();
-         checktime_block_type::bcnt_tables.back()[inst_idx] = instruction_counter::icnt;
-         instruction_counter::bcnt += instruction_counter::icnt;
-         instruction_counter::icnt = 0;
-         checktime_block_type::block_stack.pop();
-         checktime_block_type::type_stack.pop();
-      }
-   };
 
-   struct checktime_function_end {
-      static constexpr bool kills = false;
-      static constexpr bool post = false;
-      static void init() { fcnt = 0; }
-      static void accept( wasm_ops::instr* inst, wasm_ops::visitor_arg& arg ) {
-         fcnt = instruction_counter::tcnt - instruction_counter::bcnt;
-      }
-      static size_t fcnt;
-   };
+         /// to be called after inst was added to the code
+         void account( wasm_ops::instr* inst ) {
+            ++regions.back().cost;
+            switch( inst->get_code() ) {
+               case wasm_ops::block_code:
+               case wasm_ops::if__code:
+                  blocks.push_back(false);
+                  break;
+               case wasm_ops::loop_code:
+                  blocks.push_back(true);
+                  open_region();
+                  break;
+               case wasm_ops::end_code:
+                  // the end of the function body closes no block
+                  if( blocks.empty() || blocks.back() )
+                     close_region();
+                  if( !blocks.empty() )
+                     blocks.pop_back();
+                  break;
+            }
+         }
 
-   struct checktime_injection {
-      static constexpr bool kills = false;
-      static constexpr bool post = true;
-      static void init() {
-         idx = 0;
-         chktm_idx = 0;
-      }
-      static void accept( wasm_ops::instr* inst, wasm_ops::visitor_arg& arg ) {
-         auto mapped_index = injector_utils::injected_index_mapping.find(chktm_idx);
+      private:
+         struct region {
+            size_t   cost_pos = 0;
+            uint32_t cost = 0;
+         };
+
+         void open_region() {
+            wasm_ops::op_types<>::i32_const_t const_inst;
+            wasm_ops::op_types<>::i32_sub_t   sub_inst;
+            wasm_ops::op_types<>::i32_lt_s_t  lt_inst;
+            wasm_ops::op_types<>::if__t       if_inst;
+            wasm_ops::op_types<>::end_t       end_inst;
+
+            // budget -= cost
+            get_budget.pack(&code);
+            const_inst.field = 0;
+            const_inst.pack(&code);
+            regions.push_back({code.get_index() - sizeof(uint32_t), 0});
+            sub_inst.pack(&code);
+            set_budget.pack(&code);
+
+            // if( budget < 0 ) { checktime(); budget = instructions_per_checktime; }
+            get_budget.pack(&code);
+            const_inst.pack(&code);
+            lt_inst.pack(&code);
+            if_inst.pack(&code);
+            chktm.pack(&code);
+            const_inst.field = checktime_injection::instructions_per_checktime;
+            const_inst.pack(&code);
+            set_budget.pack(&code);
+            end_inst.pack(&code);
+         }
 
-         wasm_ops::op_types<>::call_t chktm; 
-         chktm.field = mapped_index->second;
-         chktm.pack(arg.new_code);
-      }
+         void close_region() {
+            const auto& r = regions.back();
+            for( size_t i = 0; i < sizeof(uint32_t); ++i )
+               code.data[r.cost_pos + i] = U8(r.cost >> (8 * i));
+            regions.pop_back();
+         }
 
-      static int32_t idx;
-      static int32_t chktm_idx;
+         wasm_ops::instruction_stream&        code;
+         wasm_ops::op_types<>::call_t         chktm;
+         wasm_ops::op_types<>::get_global_t   get_budget;
+         wasm_ops::op_types<>::set_global_t   set_budget;
+         std::vector<region>                  regions;
+         std::vector<bool>                    blocks;    ///< the open blocks, true for loops
    };
 
    struct fix_call_index {
@@ -322,8 +330,12 @@ namespace snax { namespace chain { namespace wasm_injections {
          INSERT_INJECTED(end_inst);
 
          /* print the correct call type */
+         // the entry of a function in the module is metered, but host functions can take arbitrarily long
+         // and a table may hold them too, so those calls are still followed by checktime
+         bool calls_host = true;
          if ( inst->get_code() == wasm_ops::call_code ) {
             wasm_ops::op_types<>::call_t* call_inst = reinterpret_cast<wasm_ops::op_types<>::call_t*>(inst);
+            calls_host = call_inst->field < arg.module->functions.imports.size() - injector_utils::registered_injected.size();
             call_inst->pack(arg.new_code);
          }
          else {
@@ -336,7 +348,8 @@ namespace snax { namespace chain { namespace wasm_injections {
          INSERT_INJECTED(const_inst);
          INSERT_INJECTED(add_inst);
          INSERT_INJECTED(set_global_inst);
-         INSERT_INJECTED(call_checktime);
+         if ( calls_host )
+            INSERT_INJECTED(call_checktime);
 
 #undef INSERT_INJECTED
       }
@@ -759,7 +772,6 @@ namespace snax { namespace chain { namespace wasm_injections {
 
 
    struct post_op_injectors : wasm_ops::op_types<pass_injector> {
-      using loop_t   = wasm_ops::loop        <checktime_injection>;
       using call_t   = wasm_ops::call        <fix_call_index>;
    };
 
@@ -795,6 +807,7 @@ namespace snax { namespace chain { namespace wasm_injections {
             _module_injectors.inject( *_module );
             // inject checktime first
             injector_utils::add_import<ResultType::none>( *_module, u8"checktime", checktime_injection::chktm_idx );
+            checktime_injection::add_budget( *_module );
 
             for ( auto& fd : _module->functions.defs ) {
                wasm_ops::SNAX_OperatorDecoderStream<pre_op_injectors> pre_decoder(fd.code);
@@ -818,9 +831,7 @@ namespace snax { namespace chain { namespace wasm_injections {
                wasm_ops::SNAX_OperatorDecoderStream<post_op_injectors> post_decoder(fd.code);
                wasm_ops::instruction_stream post_code(fd.code.size()*2);
 
-               wasm_ops::op_types<>::call_t chktm; 
-               chktm.field = injector_utils::injected_index_mapping.find(checktime_injection::chktm_idx)->second;
-               chktm.pack(&post_code);
+               checktime_metering metering( post_code );
 
                while ( post_decoder ) {
                   auto op = post_decoder.decodeOp();
@@ -833,6 +844,7 @@ namespace snax { namespace chain { namespace wasm_injections {
                      if (!(op->is_kill()))
                         op->pack(&post_code);
                   }
+                  metering.account(op);
                }
                fd.code = post_code.get();
             }
@@ -2,6 +2,7 @@
 
 #include <snax/chain/wasm_interface.hpp>
 #include <snax/chain/wasm_snax_constraints.hpp>
+#include <snax/chain/cpu_profiler.hpp>
 
 #define SNAX_INJECTED_MODULE_NAME "snax_injection"
 
@@ -12,6 +13,18 @@ namespace snax { namespace chain {
    class apply_context;
    class transaction_context;
 
+   /**
+    * The name an intrinsic is registered under, set at its registration so the invoker of the method
+    * can attribute profiling samples to it.
+    */
+   template<typename MethodSig, MethodSig Method>
+   struct intrinsic_name {
+      static const char* value;
+   };
+
+   template<typename MethodSig, MethodSig Method>
+   const char* intrinsic_name<MethodSig, Method>::value = "";
+
    template<typename T>
    struct class_from_wasm {
       /**
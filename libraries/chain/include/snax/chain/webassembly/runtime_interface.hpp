@@ -10,6 +10,9 @@ class wasm_instantiated_module_interface {
    public:
       virtual void apply(apply_context& context) = 0;
 
+      //approximate bytes of memory held by the instantiated module: its compiled code and initial memory image
+      virtual size_t memory_size() const = 0;
+
       virtual ~wasm_instantiated_module_interface();
 };
 
@@ -655,6 +655,8 @@ struct intrinsic_function_invoker {
 
    template<MethodSig Method>
    static Ret wrapper(wabt_apply_instance_vars& vars, Params... params, const TypedValues&, int) {
+      cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::host_function, vars.ctx.receiver,
+                                        account_name(), action_name(), intrinsic_name<MethodSig, Method>::value );
       class_from_wasm<Cls>::value(vars.ctx).checktime();
       return (class_from_wasm<Cls>::value(vars.ctx).*Method)(params...);
    }
@@ -671,6 +673,8 @@ struct intrinsic_function_invoker<void, MethodSig, Cls, Params...> {
 
    template<MethodSig Method>
    static void_type wrapper(wabt_apply_instance_vars& vars, Params... params, const TypedValues& args, int offset) {
+      cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::host_function, vars.ctx.receiver,
+                                        account_name(), action_name(), intrinsic_name<MethodSig, Method>::value );
       class_from_wasm<Cls>::value(vars.ctx).checktime();
       (class_from_wasm<Cls>::value(vars.ctx).*Method)(params...);
       return void_type();
@@ -640,6 +640,8 @@ struct intrinsic_function_invoker {
 
    template<MethodSig Method>
    static Ret wrapper(running_instance_context& ctx, Params... params) {
+      cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::host_function, ctx.apply_ctx->receiver,
+                                        account_name(), action_name(), intrinsic_name<MethodSig, Method>::value );
       class_from_wasm<Cls>::value(*ctx.apply_ctx).checktime();
       return (class_from_wasm<Cls>::value(*ctx.apply_ctx).*Method)(params...);
    }
@@ -659,6 +661,8 @@ struct intrinsic_function_invoker<WasmSig, void, MethodSig, Cls, Params...> {
 
    template<MethodSig Method>
    static void_type wrapper(running_instance_context& ctx, Params... params) {
+      cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::host_function, ctx.apply_ctx->receiver,
+                                        account_name(), action_name(), intrinsic_name<MethodSig, Method>::value );
       class_from_wasm<Cls>::value(*ctx.apply_ctx).checktime();
       (class_from_wasm<Cls>::value(*ctx.apply_ctx).*Method)(params...);
       return void_type();
@@ -49,4 +49,56 @@ digest_type merkle(vector<digest_type> ids) {
    return ids.front();
 }
 
+merkle_tree::merkle_tree( vector<digest_type> leaves ) {
+   _layers.emplace_back( std::move(leaves) );
+   while( _layers.back().size() > 1 ) {
+      const auto& below = _layers.back();
+      vector<digest_type> layer;
+      layer.reserve( (below.size() + 1) / 2 );
+      for( size_t i = 0; i < below.size(); i += 2 ) {
+         // an odd layer duplicates its last node
+         const auto& right = i + 1 < below.size() ? below[i + 1] : below[i];
+         layer.emplace_back( digest_type::hash(make_canonical_pair(below[i], right)) );
+      }
+      _layers.emplace_back( std::move(layer) );
+   }
+}
+
+digest_type merkle_tree::root()const {
+   if( size() == 0 ) { return digest_type(); }
+   return _layers.back().front();
+}
+
+vector<digest_type> merkle_tree::get_path( uint32_t index )const {
+   vector<digest_type> result;
+   if( index >= size() ) { return result; }
+
+   const auto& leaves = _layers.front();
+   if( leaves.size() == 1 ) {
+      result.push_back( leaves.front() );
+      return result;
+   }
+
+   result.reserve( _layers.size() + 1 );
+
+   // the leaf pair
+   uint32_t left = index & ~1u;
+   result.push_back( leaves[left] );
+   result.push_back( left + 1 < leaves.size() ? leaves[left + 1] : leaves[left] );
+
+   // siblings of the inner nodes, the last layer is the root
+   for( size_t l = 1; l + 1 < _layers.size(); ++l ) {
+      const auto& layer = _layers[l];
+      index /= 2;
+      if( index % 2 == 0 ) {
+         result.push_back( make_canonical_right( index + 1 < layer.size() ? layer[index + 1] : layer[index] ) );
+      } else {
+         result.push_back( make_canonical_left( layer[index - 1] ) );
+      }
+   }
+
+   result.push_back( root() );
+   return result;
+}
+
 } } // snax::chain
@@ -168,6 +168,9 @@ void apply_snax_setcode(apply_context& context) {
 
    });
 
+   if( code_size > 0 )
+      context.control.get_wasm_interface().code_deployed( act.account, code_id );
+
    const auto& account_sequence = db.get<account_sequence_object, by_name>(act.account);
    db.modify( account_sequence, [&]( auto& aso ) {
       aso.code_sequence += 1;
@@ -333,6 +336,7 @@ void apply_snax_linkauth(apply_context& context) {
 
       auto link_key = boost::make_tuple(requirement.account, requirement.code, requirement.type);
       auto link = db.find<permission_link_object, by_action_name>(link_key);
+      context.control.get_mutable_authorization_manager().permission_link_changed( requirement.account, requirement.code );
 
       if( link ) {
          SNAX_ASSERT(link->required_permission != requirement.requirement, action_validate_exception,
@@ -368,6 +372,7 @@ void apply_snax_unlinkauth(apply_context& context) {
    auto link_key = boost::make_tuple(unlink.account, unlink.code, unlink.type);
    auto link = db.find<permission_link_object, by_action_name>(link_key);
    SNAX_ASSERT(link != nullptr, action_validate_exception, "Attempting to unlink authority, but no link found");
+   context.control.get_mutable_authorization_manager().permission_link_changed( unlink.account, unlink.code );
    context.add_ram_usage(
       link->account,
       -(int64_t)(config::billable_size_v<permission_link_object>)
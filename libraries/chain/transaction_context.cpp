@@ -6,6 +6,7 @@
 #include <snax/chain/generated_transaction_object.hpp>
 #include <snax/chain/transaction_object.hpp>
 #include <snax/chain/global_property_object.hpp>
+#include <snax/chain/cpu_profiler.hpp>
 
 #pragma push_macro("N")
 #undef N
@@ -160,6 +161,7 @@ namespace bacc = boost::accumulators;
    {
       if (!c.skip_db_sessions()) {
          undo_session = c.mutable_db().start_undo_session(true);
+         undo_session_auth_revision = c.get_authorization_manager().revision();
       }
       trace->id = id;
       trace->block_num = c.pending_block_state()->block_num;
@@ -332,6 +334,11 @@ namespace bacc = boost::accumulators;
    void transaction_context::exec() {
       SNAX_ASSERT( is_initialized, transaction_exception, "must first initialize" );
 
+      // transactions are told apart by their first action
+      const action* first = trx.actions.empty() ? nullptr : &trx.actions.front();
+      cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::transaction, account_name(),
+                                        first ? first->account : account_name(), first ? first->name : action_name() );
+
       if( apply_context_free ) {
          for( const auto& act : trx.context_free_actions ) {
             trace->action_traces.emplace_back();
@@ -404,12 +411,23 @@ namespace bacc = boost::accumulators;
                                 block_timestamp_type(control.pending_block_time()).slot ); // Should never fail
    }
 
+   transaction_context::~transaction_context() {
+      undo(); // what the session would do on destruction, also letting the authorization cache know
+   }
+
    void transaction_context::squash() {
-      if (undo_session) undo_session->squash();
+      if (undo_session) {
+         undo_session->squash();
+         undo_session.reset();
+      }
    }
 
    void transaction_context::undo() {
-      if (undo_session) undo_session->undo();
+      if (undo_session) {
+         undo_session->undo();
+         undo_session.reset();
+         control.get_mutable_authorization_manager().undone( undo_session_auth_revision );
+      }
    }
 
    void transaction_context::check_net_usage()const {
@@ -0,0 +1,102 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#include <snax/chain/wasm_code_cache.hpp>
+#include <snax/chain/exceptions.hpp>
+#include <fc/io/fstream.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <fstream>
+
+namespace snax { namespace chain {
+
+   const uint32_t wasm_code_cache::magic_number = 0x30C0DEC0;
+
+   /**
+    * History:
+    * Version 1: code id, sha256 of the packed entry, packed entry
+    * Version 2: same layout, checktime is metered per loop and function body instead of called on each
+    *
+    * Bump the version whenever wasm_snax_injection changes the code it emits, entries injected by an
+    * older node must not be run.
+    */
+   const uint32_t wasm_code_cache::supported_version = 2;
+
+   wasm_code_cache::wasm_code_cache( const fc::path& dir )
+   :dir(dir) {
+      if( enabled() && !fc::is_directory( dir ) )
+         fc::create_directories( dir );
+   }
+
+   fc::path wasm_code_cache::file_of( const digest_type& code_id )const {
+      return dir / ( code_id.str() + ".wasm" );
+   }
+
+   optional<wasm_code_cache::entry> wasm_code_cache::get( const digest_type& code_id )const {
+      if( !enabled() )
+         return optional<entry>();
+
+      auto file = file_of( code_id );
+      if( !fc::exists( file ) )
+         return optional<entry>();
+
+      try {
+         string content;
+         fc::read_file_contents( file, content );
+         fc::datastream<const char*> ds( content.data(), content.size() );
+
+         uint32_t magic = 0, version = 0;
+         digest_type id, checksum;
+         fc::raw::unpack( ds, magic );
+         fc::raw::unpack( ds, version );
+         fc::raw::unpack( ds, id );
+         fc::raw::unpack( ds, checksum );
+         if( magic == magic_number && version == supported_version && id == code_id
+             && checksum == fc::sha256::hash( ds.pos(), ds.remaining() ) ) {
+            entry e;
+            fc::raw::unpack( ds, e );
+            return e;
+         }
+         ilog( "discarding code cache entry ${f} written by a different version or damaged", ("f", file.generic_string()) );
+      } catch( const fc::exception& e ) {
+         wlog( "discarding unreadable code cache entry ${f}: ${e}", ("f", file.generic_string())("e", e.to_string()) );
+      }
+      remove( code_id );
+      return optional<entry>();
+   }
+
+   void wasm_code_cache::put( const digest_type& code_id, const entry& e )const {
+      if( !enabled() )
+         return;
+
+      auto file = file_of( code_id );
+      auto tmp = dir / ( code_id.str() + ".tmp" );
+      try {
+         auto packed = fc::raw::pack( e );
+         {
+            std::ofstream out( tmp.generic_string().c_str(), std::ios::out | std::ios::binary | std::ofstream::trunc );
+            fc::raw::pack( out, magic_number );
+            fc::raw::pack( out, supported_version );
+            fc::raw::pack( out, code_id );
+            fc::raw::pack( out, fc::sha256::hash( packed.data(), packed.size() ) );
+            out.write( packed.data(), packed.size() );
+            out.flush();
+            SNAX_ASSERT( out.good(), wasm_exception, "unable to write ${f}", ("f", tmp.generic_string()) );
+         }
+         // readers only ever see a complete file
+         fc::rename( tmp, file );
+      } catch( const fc::exception& ex ) {
+         wlog( "unable to add ${id} to the code cache: ${e}", ("id", code_id)("e", ex.to_string()) );
+         fc::remove( tmp );
+      } catch( const std::exception& ex ) {
+         wlog( "unable to add ${id} to the code cache: ${e}", ("id", code_id)("e", ex.what()) );
+         fc::remove( tmp );
+      }
+   }
+
+   void wasm_code_cache::remove( const digest_type& code_id )const {
+      if( enabled() )
+         fc::remove( file_of( code_id ) );
+   }
+
+} } /// snax::chain
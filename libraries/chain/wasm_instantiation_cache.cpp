@@ -0,0 +1,94 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#include <snax/chain/wasm_instantiation_cache.hpp>
+
+namespace snax { namespace chain {
+
+   wasm_instantiation_cache::wasm_instantiation_cache( uint64_t max_memory_size, const flat_set<account_name>& pinned_accounts )
+   :pinned_accounts(pinned_accounts) {
+      _stats.max_memory_size = max_memory_size;
+   }
+
+   wasm_instantiated_module_interface* wasm_instantiation_cache::get( const digest_type& code_id, account_name receiver ) {
+      auto itr = entries.find( code_id );
+      if( itr == entries.end() ) {
+         ++_stats.misses;
+         return nullptr;
+      }
+      ++_stats.hits;
+      touch( itr->second );
+      pin( code_id, itr->second, receiver );
+      return itr->second.module.get();
+   }
+
+   wasm_instantiated_module_interface& wasm_instantiation_cache::add( const digest_type& code_id, account_name receiver,
+                                                                     std::unique_ptr<wasm_instantiated_module_interface> module ) {
+      auto size = module->memory_size();
+      evict_for( size );
+
+      auto& e = entries[code_id];
+      e.module = std::move( module );
+      e.size = size;
+      lru.push_front( code_id );
+      e.lru_pos = lru.begin();
+      _stats.memory_size += size;
+      _stats.entries = entries.size();
+      pin( code_id, e, receiver );
+      return *e.module;
+   }
+
+   bool wasm_instantiation_cache::add_unused( const digest_type& code_id,
+                                              std::unique_ptr<wasm_instantiated_module_interface> module ) {
+      auto size = module->memory_size();
+      if( contains( code_id ) || _stats.memory_size + size > _stats.max_memory_size )
+         return false;
+
+      auto& e = entries[code_id];
+      e.module = std::move( module );
+      e.size = size;
+      e.lru_pos = lru.insert( lru.end(), code_id );
+      _stats.memory_size += size;
+      _stats.entries = entries.size();
+      return true;
+   }
+
+   void wasm_instantiation_cache::touch( entry& e ) {
+      lru.splice( lru.begin(), lru, e.lru_pos );
+   }
+
+   void wasm_instantiation_cache::pin( const digest_type& code_id, entry& e, account_name receiver ) {
+      if( !pinned_accounts.count( receiver ) )
+         return;
+
+      auto itr = pinned_code.find( receiver );
+      if( itr != pinned_code.end() ) {
+         if( itr->second == code_id )
+            return;
+         // the account runs new code now, its old code may be evicted again
+         auto old = entries.find( itr->second );
+         if( old != entries.end() && --old->second.pins == 0 )
+            --_stats.pinned_entries;
+      }
+      pinned_code[receiver] = code_id;
+      if( e.pins++ == 0 )
+         ++_stats.pinned_entries;
+   }
+
+   void wasm_instantiation_cache::evict_for( uint64_t size ) {
+      auto pos = lru.end();
+      while( _stats.memory_size + size > _stats.max_memory_size && pos != lru.begin() ) {
+         --pos;
+         auto itr = entries.find( *pos );
+         if( itr->second.pins )
+            continue;
+         _stats.memory_size -= itr->second.size;
+         ++_stats.evictions;
+         pos = lru.erase( pos );
+         entries.erase( itr );
+      }
+      _stats.entries = entries.size();
+   }
+
+} } /// snax::chain
@@ -28,7 +28,8 @@ namespace snax { namespace chain {
    using namespace webassembly;
    using namespace webassembly::common;
 
-   wasm_interface::wasm_interface(vm_type vm) : my( new wasm_interface_impl(vm) ) {}
+   wasm_interface::wasm_interface(vm_type vm, const fc::path& code_cache_dir, uint64_t max_cache_size, const flat_set<account_name>& pinned_accounts)
+   : my( new wasm_interface_impl(vm, code_cache_dir, max_cache_size, pinned_accounts) ) {}
 
    wasm_interface::~wasm_interface() {}
 
@@ -55,7 +56,28 @@ namespace snax { namespace chain {
 	 }
 
    void wasm_interface::apply( const digest_type& code_id, const shared_string& code, apply_context& context ) {
-      my->get_instantiated_module(code_id, code, context.trx_context)->apply(context);
+      my->get_instantiated_module(code_id, code, context.receiver, context.trx_context).apply(context);
+   }
+
+   void wasm_interface::compile_ahead( const digest_type& code_id, const bytes& code, boost::asio::thread_pool& pool ) {
+      my->compile_ahead(code_id, code, pool);
+   }
+
+   void wasm_interface::code_deployed( account_name account, const digest_type& code_id ) {
+      my->deployed[account] = code_id;
+   }
+
+   void wasm_interface::compile_deployed( const chainbase::database& db, boost::asio::thread_pool& pool ) {
+      for( const auto& d : my->deployed ) {
+         const auto* account = db.find<account_object, by_name>( d.first );
+         if( account && account->code_version == d.second && account->code.size() > 0 )
+            my->compile_ahead( d.second, bytes( account->code.begin(), account->code.end() ), pool );
+      }
+      my->deployed.clear();
+   }
+
+   const wasm_cache_stats& wasm_interface::get_cache_stats()const {
+      return my->instantiation_cache.stats();
    }
 
    void wasm_interface::exit() {
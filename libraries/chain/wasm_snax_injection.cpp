@@ -36,17 +36,7 @@ void max_memory_injection_visitor::inject( Module& m ) {
 void max_memory_injection_visitor::initializer() {}
 
 int32_t  call_depth_check_and_insert_checktime::global_idx = -1;
-uint32_t instruction_counter::icnt = 0;
-uint32_t instruction_counter::tcnt = 0;
-uint32_t instruction_counter::bcnt = 0;
-std::queue<uint32_t> instruction_counter::fcnts;
-
-int32_t  checktime_injection::idx = 0;
 int32_t  checktime_injection::chktm_idx = 0;
-std::stack<size_t>                   checktime_block_type::block_stack;
-std::stack<size_t>                   checktime_block_type::type_stack;
-std::queue<std::vector<size_t>>      checktime_block_type::orderings;
-std::queue<std::map<size_t, size_t>> checktime_block_type::bcnt_tables;
-size_t  checktime_function_end::fcnt = 0;
+int32_t  checktime_injection::budget_idx = -1;
 
 }}} // namespace snax, chain, injectors
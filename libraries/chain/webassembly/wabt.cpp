@@ -18,8 +18,8 @@ namespace wasm_constraints = snax::chain::wasm_constraints;
 
 class wabt_instantiated_module : public wasm_instantiated_module_interface {
    public:
-      wabt_instantiated_module(std::unique_ptr<interp::Environment> e, std::vector<uint8_t> initial_mem, interp::DefinedModule* mod) :
-         _env(move(e)), _instatiated_module(mod), _initial_memory(initial_mem),
+      wabt_instantiated_module(std::unique_ptr<interp::Environment> e, std::vector<uint8_t> initial_mem, interp::DefinedModule* mod, size_t code_size) :
+         _env(move(e)), _instatiated_module(mod), _initial_memory(initial_mem), _code_size(code_size),
          _executor(_env.get(), nullptr, Thread::Options(64*1024,
                                                         wasm_constraints::maximum_call_depth+2))
       {
@@ -41,13 +41,17 @@ class wabt_instantiated_module : public wasm_instantiated_module_interface {
          wabt_apply_instance_vars this_run_vars{nullptr, context};
          static_wabt_vars = &this_run_vars;
 
-         //reset memory to inital size & copy back in initial data
+         //reset memory to inital size & copy back in initial data. the memory is a vector owned by the
+         // interpreter so it can't be mapped copy-on-write, but each byte is written only once: zeroing
+         // skips the initial data and the bytes the resize adds, which the vector zeroes already
          if(_env->GetMemoryCount()) {
             Memory* memory = this_run_vars.memory = _env->GetMemory(0);
+            size_t used_size = memory->data.size();
             memory->page_limits = _initial_memory_configuration;
             memory->data.resize(_initial_memory_configuration.initial * WABT_PAGE_SIZE);
-            memset(memory->data.data(), 0, memory->data.size());
             memcpy(memory->data.data(), _initial_memory.data(), _initial_memory.size());
+            if(used_size > _initial_memory.size())
+               memset(memory->data.data() + _initial_memory.size(), 0, std::min(used_size, memory->data.size()) - _initial_memory.size());
          }
 
          _params[0].set_i64(uint64_t(context.receiver));
@@ -61,10 +65,17 @@ class wabt_instantiated_module : public wasm_instantiated_module_interface {
          SNAX_ASSERT( res.result == interp::Result::Ok, wasm_execution_error, "wabt execution failure (${s})", ("s", ResultToString(res.result)) );
       }
 
+      //the WASM the module was read from stands in for the size of the interpreter's code
+      size_t memory_size() const override {
+         size_t linear_memory = _env->GetMemoryCount() ? _env->GetMemory(0)->data.size() : 0;
+         return _code_size + _initial_memory.size() + linear_memory;
+      }
+
    private:
       std::unique_ptr<interp::Environment>              _env;
       DefinedModule*                                    _instatiated_module;  //this is owned by the Environment
       std::vector<uint8_t>                              _initial_memory;
+      size_t                                            _code_size;
       TypedValues                                       _params{3, TypedValue(Type::I64)};
       std::vector<std::pair<Global*, TypedValue>>       _initial_globals;
       Limits                                            _initial_memory_configuration;
@@ -93,7 +104,7 @@ std::unique_ptr<wasm_instantiated_module_interface> wabt_runtime::instantiate_mo
    wabt::Result res = ReadBinaryInterp(env.get(), code_bytes, code_size, read_binary_options, &errors, &instantiated_module);
    SNAX_ASSERT( Succeeded(res), wasm_execution_error, "Error building wabt interp: ${e}", ("e", wabt::FormatErrorsToString(errors, Location::Type::Binary)) );
    
-   return std::make_unique<wabt_instantiated_module>(std::move(env), initial_memory, instantiated_module);
+   return std::make_unique<wabt_instantiated_module>(std::move(env), initial_memory, instantiated_module, code_size);
 }
 
 void wabt_runtime::immediately_exit_currently_running_module() {
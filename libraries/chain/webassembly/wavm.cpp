@@ -23,11 +23,32 @@ running_instance_context the_running_instance_context;
 
 class wavm_instantiated_module : public wasm_instantiated_module_interface {
    public:
-      wavm_instantiated_module(ModuleInstance* instance, std::unique_ptr<Module> module, std::vector<uint8_t> initial_mem) :
+      wavm_instantiated_module(ModuleInstance* instance, std::unique_ptr<Module> module, std::vector<uint8_t> initial_mem, size_t code_size) :
          _initial_memory(initial_mem),
          _instance(instance),
-         _module(std::move(module))
-      {}
+         _module(std::move(module)),
+         _code_size(code_size)
+      {
+         //where the platform supports it the initial memory is mapped copy-on-write for each call, so
+         // a call only pays for the pages it touches; otherwise it's copied in full. A few pages are
+         // copied about as fast as they are mapped, so those don't take up one of the images
+         if(_initial_memory.size() > (min_image_pages << Platform::getPageSizeLog2()))
+            _initial_memory_image = Platform::createPageImage(_initial_memory.data(), _initial_memory.size());
+         if(_initial_memory_image)
+            _initial_memory = std::vector<uint8_t>();
+      }
+
+      ~wavm_instantiated_module() {
+         Runtime::deleteModuleInstance(_instance);
+         if(_initial_memory_image)
+            Platform::destroyPageImage(_initial_memory_image);
+      }
+
+      //the WASM the module was instantiated from stands in for the size of the IR kept in _module
+      size_t memory_size() const override {
+         size_t image_size = _initial_memory_image ? Platform::getPageImageNumPages(_initial_memory_image) << Platform::getPageSizeLog2() : 0;
+         return Runtime::getModuleImageSize(_instance) + image_size + _initial_memory.size() + _code_size;
+      }
 
       void apply(apply_context& context) override {
          vector<Value> args = {Value(uint64_t(context.receiver)),
@@ -50,12 +71,14 @@ class wavm_instantiated_module : public wasm_instantiated_module_interface {
             // that didn't declare "memory", getDefaultMemory() won't see it
             MemoryInstance* default_mem = getDefaultMemory(_instance);
             if(default_mem) {
-               //reset memory resizes the sandbox'ed memory to the module's init memory size and then
-               // (effectively) memzeros it all
-               resetMemory(default_mem, _module->memories.defs[0].type);
-
-               char* memstart = &memoryRef<char>(getDefaultMemory(_instance), 0);
-               memcpy(memstart, _initial_memory.data(), _initial_memory.size());
+               //reset memory resizes the sandbox'ed memory to the module's init memory size, maps the
+               // initial memory image over its start and (effectively) memzeros the rest
+               resetMemory(default_mem, _module->memories.defs[0].type, _initial_memory_image);
+
+               if(!_initial_memory.empty()) {
+                  char* memstart = &memoryRef<char>(getDefaultMemory(_instance), 0);
+                  memcpy(memstart, _initial_memory.data(), _initial_memory.size());
+               }
             }
 
             the_running_instance_context.memory = default_mem;
@@ -74,11 +97,15 @@ class wavm_instantiated_module : public wasm_instantiated_module_interface {
       }
 
 
+      static constexpr size_t  min_image_pages = 4;
+
       std::vector<uint8_t>     _initial_memory;
+      Platform::PageImage*     _initial_memory_image = nullptr;
       //naked pointer because ModuleInstance is opaque
-      //_instance is deleted via WAVM's object garbage collection when wavm_rutime is deleted
+      //_instance is deleted along with the objects it defines when this module is destroyed
       ModuleInstance*          _instance;
       std::unique_ptr<Module>  _module;
+      size_t                   _code_size;
 };
 
 
@@ -124,7 +151,7 @@ std::unique_ptr<wasm_instantiated_module_interface> wavm_runtime::instantiate_mo
    ModuleInstance *instance = instantiateModule(*module, std::move(link_result.resolvedImports));
    SNAX_ASSERT(instance != nullptr, wasm_exception, "Fail to Instantiate WAVM Module");
 
-   return std::make_unique<wavm_instantiated_module>(instance, std::move(module), initial_memory);
+   return std::make_unique<wavm_instantiated_module>(instance, std::move(module), initial_memory, code_size);
 }
 
 void wavm_runtime::immediately_exit_currently_running_module() {
@@ -94,6 +94,29 @@ namespace Platform
 	// baseVirtualAddress must be a multiple of the preferred page size.
 	PLATFORM_API void freeVirtualPages(U8* baseVirtualAddress,Uptr numPages);
 
+	// A read-only snapshot of memory contents that can be mapped copy-on-write to virtual pages.
+	struct PageImage;
+
+	// Creates an image of numBytes bytes copied from data, padded with zeros to a whole number of pages.
+	// Returns nullptr if the image could not be created, too many images exist already or the platform doesn't support images; the caller has to copy the contents itself then.
+	PLATFORM_API PageImage* createPageImage(const U8* data,Uptr numBytes);
+
+	// Destroys an image. Pages it is still mapped to keep their contents.
+	PLATFORM_API void destroyPageImage(PageImage* image);
+
+	// Returns the number of pages in an image.
+	PLATFORM_API Uptr getPageImageNumPages(PageImage* image);
+
+	// Maps an image copy-on-write to the virtual pages starting at baseVirtualAddress, replacing their contents and committing them with read-write access.
+	// A page is only copied when it is first written to.
+	// baseVirtualAddress must be a multiple of the preferred page size.
+	// Return true if successful, or false if the image could not be mapped.
+	PLATFORM_API bool mapPageImage(U8* baseVirtualAddress,PageImage* image);
+
+	// Replaces virtual pages an image was mapped to with decommitted pages, as if they had never been committed.
+	// baseVirtualAddress must be a multiple of the preferred page size.
+	PLATFORM_API void unmapPageImage(U8* baseVirtualAddress,Uptr numPages);
+
 	//
 	// Call stack and exceptions
 	//
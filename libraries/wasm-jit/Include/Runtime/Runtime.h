@@ -10,6 +10,7 @@
 
 // Declare IR::Module to avoid including the definition.
 namespace IR { struct Module; }
+namespace Platform { struct PageImage; }
 
 namespace Runtime
 {
@@ -205,6 +206,13 @@ namespace Runtime
 	// Instantiates a module, bindings its imports to the specified objects. May throw InstantiationException.
 	RUNTIME_API ModuleInstance* instantiateModule(const IR::Module& module,ImportBindings&& imports);
 
+	// Deletes a module instance along with its machine code and the functions, tables and globals it defines.
+	// Unlike freeUnreferencedObjects it doesn't look for other references to them; there must be none left.
+	RUNTIME_API void deleteModuleInstance(ModuleInstance* moduleInstance);
+
+	// Gets the number of bytes of memory holding the machine code and data of a ModuleInstance.
+	RUNTIME_API Uptr getModuleImageSize(ModuleInstance* moduleInstance);
+
 	// Gets the default table/memory for a ModuleInstance.
 	RUNTIME_API MemoryInstance* getDefaultMemory(ModuleInstance* moduleInstance);
 	RUNTIME_API uint64_t getDefaultMemorySize(ModuleInstance* moduleInstance);
@@ -212,7 +220,10 @@ namespace Runtime
 
 	RUNTIME_API void runInstanceStartFunc(ModuleInstance* moduleInstance);
 	RUNTIME_API void resetGlobalInstances(ModuleInstance* moduleInstance);
-	RUNTIME_API void resetMemory(MemoryInstance* memory, IR::MemoryType& newMemoryType);
+
+	// Resets a memory to the minimum size of newMemoryType, with image (if not null) mapped copy-on-write to its first pages and zeros after it.
+	// Only the pages written to since the last reset are copied or zeroed again.
+	RUNTIME_API void resetMemory(MemoryInstance* memory, IR::MemoryType& newMemoryType, Platform::PageImage* image = nullptr);
 
 	// Gets an object exported by a ModuleInstance by name.
 	RUNTIME_API ObjectInstance* getInstanceExport(ModuleInstance* moduleInstance,const std::string& name);
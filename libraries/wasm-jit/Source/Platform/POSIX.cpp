@@ -7,12 +7,14 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 
 #include <errno.h>
 #include <signal.h>
 #include <setjmp.h>
 #include <sys/resource.h>
 #include <string.h>
+#include <atomic>
 #include <iostream>
 #include <string>
 
@@ -107,6 +109,64 @@ namespace Platform
 		if(munmap(baseVirtualAddress,numPages << getPageSizeLog2())) { Errors::fatal("munmap failed"); }
 	}
 
+	struct PageImage
+	{
+		int fd;
+		Uptr numPages;
+	};
+
+	// Each image holds a file descriptor, so only this many exist at once; further images aren't created and their contents are copied instead.
+	static const Uptr maxPageImages = 256;
+	static std::atomic<Uptr> numPageImages{0};
+
+	PageImage* createPageImage(const U8* data,Uptr numBytes)
+	{
+		#ifdef SYS_memfd_create
+			const Uptr pageSizeLog2 = getPageSizeLog2();
+			const Uptr numPages = (numBytes + (Uptr(1) << pageSizeLog2) - 1) >> pageSizeLog2;
+			const Uptr numPageBytes = numPages << pageSizeLog2;
+			if(!numPages) { return nullptr; }
+			if(numPageImages.fetch_add(1) >= maxPageImages) { --numPageImages; return nullptr; }
+
+			// An anonymous file, so the image lives in the page cache and private mappings of it are copy-on-write.
+			int fd = (int)syscall(SYS_memfd_create,"wavm_page_image",1u/*MFD_CLOEXEC*/);
+			if(fd < 0) { --numPageImages; return nullptr; }
+			if(ftruncate(fd,numPageBytes)) { close(fd); --numPageImages; return nullptr; }
+
+			void* contents = mmap(nullptr,numPageBytes,PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+			if(contents == MAP_FAILED) { close(fd); --numPageImages; return nullptr; }
+			memcpy(contents,data,numBytes);
+			munmap(contents,numPageBytes);
+
+			return new PageImage {fd,numPages};
+		#else
+			return nullptr;
+		#endif
+	}
+
+	void destroyPageImage(PageImage* image)
+	{
+		close(image->fd);
+		delete image;
+		--numPageImages;
+	}
+
+	Uptr getPageImageNumPages(PageImage* image) { return image->numPages; }
+
+	bool mapPageImage(U8* baseVirtualAddress,PageImage* image)
+	{
+		errorUnless(isPageAligned(baseVirtualAddress));
+		auto result = mmap(baseVirtualAddress,image->numPages << getPageSizeLog2(),PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_FIXED,image->fd,0);
+		return result == baseVirtualAddress;
+	}
+
+	void unmapPageImage(U8* baseVirtualAddress,Uptr numPages)
+	{
+		errorUnless(isPageAligned(baseVirtualAddress));
+		auto result = mmap(baseVirtualAddress,numPages << getPageSizeLog2(),PROT_NONE,MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,-1,0);
+		if(result != baseVirtualAddress) { Errors::fatal("mmap failed"); }
+	}
+
 	bool describeInstructionPointer(Uptr ip,std::string& outDescription)
 	{
 		#if defined __linux__ || defined __FreeBSD__
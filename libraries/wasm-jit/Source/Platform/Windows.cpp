@@ -85,6 +85,15 @@ namespace Platform
 		if(baseVirtualAddress && !result) { Errors::fatal("VirtualFree(MEM_RELEASE) failed"); }
 	}
 
+	// Copy-on-write images aren't implemented on Windows, memories are reset by copying.
+	struct PageImage {};
+
+	PageImage* createPageImage(const U8* data,Uptr numBytes) { return nullptr; }
+	void destroyPageImage(PageImage* image) { delete image; }
+	Uptr getPageImageNumPages(PageImage* image) { return 0; }
+	bool mapPageImage(U8* baseVirtualAddress,PageImage* image) { return false; }
+	void unmapPageImage(U8* baseVirtualAddress,Uptr numPages) { decommitVirtualPages(baseVirtualAddress,numPages); }
+
 	// The interface to the DbgHelp DLL
 	struct DbgHelp
 	{
@@ -29,6 +29,9 @@ namespace LLVMJIT
 {
 	llvm::LLVMContext context;
 	llvm::TargetMachine* targetMachine = nullptr;
+
+	// Modules may be compiled on any thread; the context and target machine are only used with this held.
+	Platform::Mutex* contextMutex = Platform::createMutex();
 	llvm::Type* llvmResultTypes[(Uptr)ResultType::num];
 
 	llvm::Type* llvmI8Type;
@@ -57,6 +60,7 @@ namespace LLVMJIT
 	std::map<Uptr,struct JITSymbol*> addressToSymbolMap;
 
 	// A map from function types to function indices in the invoke thunk unit.
+	Platform::Mutex* invokeThunkMapMutex = Platform::createMutex();
 	std::map<const FunctionType*,struct JITSymbol*> invokeThunkTypeToSymbolMap;
 
 	// Information about a JIT symbol, used to map instruction pointers to descriptive names.
@@ -169,6 +173,7 @@ namespace LLVMJIT
 		}
 
 		U8* getImageBaseAddress() const { return imageBaseAddress; }
+		Uptr getNumImageBytes() const { return numAllocatedImagePages << Platform::getPageSizeLog2(); }
 
 	private:
 		struct Section
@@ -242,6 +247,9 @@ namespace LLVMJIT
 
 		virtual void notifySymbolLoaded(const char* name,Uptr baseAddress,Uptr numBytes,std::map<U32,U32>&& offsetToOpIndexMap) = 0;
 
+	protected:
+		Uptr getUnitImageBytes() const { return memoryManager.getNumImageBytes(); }
+
 	private:
 		
 		// Functor that receives notifications when an object produced by the JIT is loaded.
@@ -294,6 +302,8 @@ namespace LLVMJIT
 		std::vector<JITSymbol*> functionDefSymbols;
 
 		JITModule(ModuleInstance* inModuleInstance): moduleInstance(inModuleInstance) {}
+
+		Uptr getNumImageBytes() const override { return getUnitImageBytes(); }
 		~JITModule() override
 		{
 			// Delete the module's symbols, and remove them from the global address-to-symbol map.
@@ -612,6 +622,8 @@ namespace LLVMJIT
 
 	void instantiateModule(const IR::Module& module,ModuleInstance* moduleInstance)
 	{
+		Platform::Lock contextLock(contextMutex);
+
 		// Emit LLVM IR for the module.
 		auto llvmModule = emitModule(module,moduleInstance);
 
@@ -686,9 +698,20 @@ namespace LLVMJIT
 
 	InvokeFunctionPointer getInvokeThunk(const FunctionType* functionType)
 	{
-		// Reuse cached invoke thunks for the same function type.
-		auto mapIt = invokeThunkTypeToSymbolMap.find(functionType);
-		if(mapIt != invokeThunkTypeToSymbolMap.end()) { return reinterpret_cast<InvokeFunctionPointer>(mapIt->second->baseAddress); }
+		// Reuse cached invoke thunks for the same function type. The map lock is only held briefly, so calls
+		// don't wait for a module being compiled on another thread unless they need a new thunk.
+		{
+			Platform::Lock invokeThunkMapLock(invokeThunkMapMutex);
+			auto mapIt = invokeThunkTypeToSymbolMap.find(functionType);
+			if(mapIt != invokeThunkTypeToSymbolMap.end()) { return reinterpret_cast<InvokeFunctionPointer>(mapIt->second->baseAddress); }
+		}
+
+		Platform::Lock contextLock(contextMutex);
+		{
+			Platform::Lock invokeThunkMapLock(invokeThunkMapMutex);
+			auto mapIt = invokeThunkTypeToSymbolMap.find(functionType);
+			if(mapIt != invokeThunkTypeToSymbolMap.end()) { return reinterpret_cast<InvokeFunctionPointer>(mapIt->second->baseAddress); }
+		}
 
 		auto llvmModule = new llvm::Module("",context);
 		auto llvmFunctionType = llvm::FunctionType::get(
@@ -737,7 +760,10 @@ namespace LLVMJIT
 		jitUnit->compile(llvmModule);
 
 		WAVM_ASSERT_THROW(jitUnit->symbol);
-		invokeThunkTypeToSymbolMap[functionType] = jitUnit->symbol;
+		{
+			Platform::Lock invokeThunkMapLock(invokeThunkMapMutex);
+			invokeThunkTypeToSymbolMap[functionType] = jitUnit->symbol;
+		}
 
 		{
 			Platform::Lock addressToSymbolMapLock(addressToSymbolMapMutex);
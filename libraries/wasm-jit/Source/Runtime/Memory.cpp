@@ -3,6 +3,8 @@
 #include "Platform/Platform.h"
 #include "RuntimePrivate.h"
 
+#include <algorithm>
+
 namespace Runtime
 {
 	// Global lists of memories; used to query whether an address is reserved by one of them.
@@ -88,15 +90,47 @@ namespace Runtime
 		return Uptr(memory->type.size.max);
 	}
 
-	void resetMemory(MemoryInstance* memory, MemoryType& newMemoryType) {
-		memory->type.size.min = 1;
-		if(shrinkMemory(memory, memory->numPages - 1) == -1)
-			causeException(Exception::Cause::outOfMemory);
-		memset(memory->baseAddress, 0, 1<<IR::numBytesPerPageLog2);
+	void resetMemory(MemoryInstance* memory, MemoryType& newMemoryType, Platform::PageImage* image) {
+		const Uptr pageSizeLog2 = Platform::getPageSizeLog2();
+		const Uptr numPlatformPages = memory->numPages << getPlatformPagesPerWebAssemblyPageLog2();
+		const Uptr newNumPlatformPages = newMemoryType.size.min << getPlatformPagesPerWebAssemblyPageLog2();
+		const Uptr numImagePlatformPages = image ? Platform::getPageImageNumPages(image) : 0;
+		WAVM_ASSERT_THROW(numImagePlatformPages <= newNumPlatformPages);
+
+		// The pages the last image was mapped to that the new one doesn't cover become plain anonymous pages again.
+		if(memory->numImagePlatformPages > numImagePlatformPages)
+		{
+			Platform::unmapPageImage(memory->baseAddress + (numImagePlatformPages << pageSizeLog2),memory->numImagePlatformPages - numImagePlatformPages);
+		}
+
+		// Decommit the rest; this only costs time for pages that were actually written to, the others read back as zeros.
+		const Uptr firstAnonymousPage = std::max(numImagePlatformPages,memory->numImagePlatformPages);
+		if(numPlatformPages > firstAnonymousPage)
+		{
+			Platform::decommitVirtualPages(memory->baseAddress + (firstAnonymousPage << pageSizeLog2),numPlatformPages - firstAnonymousPage);
+		}
+
+		// Mapping the image again drops the pages it had copied on write.
+		memory->numPages = 0;
+		memory->numImagePlatformPages = 0;
+		if(numImagePlatformPages > 0)
+		{
+			if(!Platform::mapPageImage(memory->baseAddress,image))
+			{
+				Platform::unmapPageImage(memory->baseAddress,numImagePlatformPages);
+				causeException(Exception::Cause::outOfMemory);
+			}
+			memory->numImagePlatformPages = numImagePlatformPages;
+		}
+
 		memory->type = newMemoryType;
-		if(growMemory(memory, memory->type.size.min - 1) == -1)
+		if(newNumPlatformPages > numImagePlatformPages
+		&& !Platform::commitVirtualPages(memory->baseAddress + (numImagePlatformPages << pageSizeLog2),newNumPlatformPages - numImagePlatformPages))
+		{
 			causeException(Exception::Cause::outOfMemory);
-   }
+		}
+		memory->numPages = newMemoryType.size.min;
+	}
 
 	Iptr growMemory(MemoryInstance* memory,Uptr numNewPages)
 	{
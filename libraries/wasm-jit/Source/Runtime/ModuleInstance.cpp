@@ -7,6 +7,8 @@
 
 namespace Runtime
 {
+	// Held while instantiating a module, which may happen on any thread.
+	Platform::Mutex* moduleInstancesMutex = Platform::createMutex();
 	std::vector<ModuleInstance*> moduleInstances;
 	
 	Value evaluateInitializer(ModuleInstance* moduleInstance,InitializerExpression expression)
@@ -32,6 +34,8 @@ namespace Runtime
 
 	ModuleInstance* instantiateModule(const IR::Module& module,ImportBindings&& imports)
 	{
+		Platform::Lock moduleInstancesLock(moduleInstancesMutex);
+
 		ModuleInstance* moduleInstance = new ModuleInstance(
 			std::move(imports.functions),
 			std::move(imports.tables),
@@ -181,6 +185,29 @@ namespace Runtime
 		delete jitModule;
 	}
 
+	void deleteModuleInstance(ModuleInstance* moduleInstance)
+	{
+		Platform::Lock moduleInstancesLock(moduleInstancesMutex);
+		for(Uptr moduleIndex = 0;moduleIndex < moduleInstances.size();++moduleIndex)
+		{
+			if(moduleInstances[moduleIndex] == moduleInstance) { moduleInstances.erase(moduleInstances.begin() + moduleIndex); break; }
+		}
+
+		// Delete the machine code first, the objects below are referenced by it. Imported objects and the memory,
+		// which is shared by all module instances, are left alone.
+		delete moduleInstance->jitModule;
+		moduleInstance->jitModule = nullptr;
+		for(auto function : moduleInstance->functionDefs) { delete function; }
+		for(Uptr tableIndex = moduleInstance->numTableImports;tableIndex < moduleInstance->tables.size();++tableIndex) { delete moduleInstance->tables[tableIndex]; }
+		for(Uptr globalIndex = moduleInstance->numGlobalImports;globalIndex < moduleInstance->globals.size();++globalIndex) { delete moduleInstance->globals[globalIndex]; }
+		delete moduleInstance;
+	}
+
+	Uptr getModuleImageSize(ModuleInstance* moduleInstance)
+	{
+		return moduleInstance->jitModule ? moduleInstance->jitModule->getNumImageBytes() : 0;
+	}
+
 	MemoryInstance* getDefaultMemory(ModuleInstance* moduleInstance) { return moduleInstance->defaultMemory; }
 	uint64_t getDefaultMemorySize(ModuleInstance* moduleInstance) { return moduleInstance->defaultMemory->numPages << IR::numBytesPerPageLog2; }
 	TableInstance* getDefaultTable(ModuleInstance* moduleInstance) { return moduleInstance->defaultTable; }
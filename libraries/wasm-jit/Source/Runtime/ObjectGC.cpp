@@ -8,9 +8,10 @@
 
 namespace Runtime
 {
-	// Keep a global list of all objects.
+	// Keep a global list of all objects. Objects may be created by modules instantiated on different threads.
 	struct GCGlobals
 	{
+		Platform::Mutex* mutex;
 		std::set<GCObject*> allObjects;
 
 		static GCGlobals& get()
@@ -20,19 +21,23 @@ namespace Runtime
 		}
 		
 	private:
-		GCGlobals() {}
+		GCGlobals(): mutex(Platform::createMutex()) {}
 	};
 
 	GCObject::GCObject(ObjectKind inKind): ObjectInstance(inKind)
 	{
 		// Add the object to the global array.
-		GCGlobals::get().allObjects.insert(this);
+		GCGlobals& gcGlobals = GCGlobals::get();
+		Platform::Lock lock(gcGlobals.mutex);
+		gcGlobals.allObjects.insert(this);
 	}
 
 	GCObject::~GCObject()
 	{
 		// Remove the object from the global array.
-		GCGlobals::get().allObjects.erase(this);
+		GCGlobals& gcGlobals = GCGlobals::get();
+		Platform::Lock lock(gcGlobals.mutex);
+		gcGlobals.allObjects.erase(this);
 	}
 
 	void freeUnreferencedObjects(std::vector<ObjectInstance*>&& rootObjectReferences)
@@ -114,17 +119,22 @@ namespace Runtime
 		};
 
 		// Iterate over all objects, and delete objects that weren't referenced directly or indirectly by the root set.
-		GCGlobals& gcGlobals = GCGlobals::get();
-		auto objectIt = gcGlobals.allObjects.begin();
-		while(objectIt != gcGlobals.allObjects.end())
+		// The objects are deleted after releasing the lock, since their destructors take it again.
+		std::vector<ObjectInstance*> unreferencedObjects;
 		{
-			if(referencedObjects.count(*objectIt)) { ++objectIt; }
-			else
+			GCGlobals& gcGlobals = GCGlobals::get();
+			Platform::Lock lock(gcGlobals.mutex);
+			auto objectIt = gcGlobals.allObjects.begin();
+			while(objectIt != gcGlobals.allObjects.end())
 			{
-				ObjectInstance* object = *objectIt;
-				objectIt = gcGlobals.allObjects.erase(objectIt);
-				delete object;
+				if(referencedObjects.count(*objectIt)) { ++objectIt; }
+				else
+				{
+					unreferencedObjects.push_back(*objectIt);
+					objectIt = gcGlobals.allObjects.erase(objectIt);
+				}
 			}
 		}
+		for(auto object : unreferencedObjects) { delete object; }
 	}
 }
\ No newline at end of file
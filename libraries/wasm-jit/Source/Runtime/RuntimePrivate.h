@@ -17,6 +17,9 @@ namespace LLVMJIT
 	struct JITModuleBase
 	{
 		virtual ~JITModuleBase() {}
+
+		// The number of bytes of memory allocated for the module's machine code and data.
+		virtual Uptr getNumImageBytes() const = 0;
 	};
 
 	void init();
@@ -88,7 +91,10 @@ namespace Runtime
 		U8* reservedBaseAddress;
 		Uptr reservedNumPlatformPages;
 
-		MemoryInstance(const MemoryType& inType): GCObject(ObjectKind::memory), type(inType), baseAddress(nullptr), numPages(0), endOffset(0), reservedBaseAddress(nullptr), reservedNumPlatformPages(0) {}
+		// The number of platform pages at the start of the memory that resetMemory mapped an image to.
+		Uptr numImagePlatformPages;
+
+		MemoryInstance(const MemoryType& inType): GCObject(ObjectKind::memory), type(inType), baseAddress(nullptr), numPages(0), endOffset(0), reservedBaseAddress(nullptr), reservedNumPlatformPages(0), numImagePlatformPages(0) {}
 		~MemoryInstance() override;
 
       static MemoryInstance* theMemoryInstance;
@@ -123,6 +129,10 @@ namespace Runtime
 
 		Uptr startFunctionIndex = UINTPTR_MAX;
 
+		// The tables and globals after these were defined by the module rather than imported.
+		Uptr numTableImports;
+		Uptr numGlobalImports;
+
 		ModuleInstance(
 			std::vector<FunctionInstance*>&& inFunctionImports,
 			std::vector<TableInstance*>&& inTableImports,
@@ -137,6 +147,8 @@ namespace Runtime
 		, defaultMemory(nullptr)
 		, defaultTable(nullptr)
 		, jitModule(nullptr)
+		, numTableImports(tables.size())
+		, numGlobalImports(globals.size())
 		{}
 
 		~ModuleInstance() override;
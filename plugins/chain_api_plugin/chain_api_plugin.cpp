@@ -99,6 +99,7 @@ void chain_api_plugin::plugin_startup() {
       CHAIN_RO_CALL(get_producers, 200),
       CHAIN_RO_CALL(get_producer_schedule, 200),
       CHAIN_RO_CALL(get_scheduled_transactions, 200),
+      CHAIN_RO_CALL(get_wasm_cache_stats, 200),
       CHAIN_RO_CALL(abi_json_to_bin, 200),
       CHAIN_RO_CALL(abi_bin_to_json, 200),
       CHAIN_RO_CALL(get_required_keys, 200),
@@ -210,8 +210,18 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
    cfg.add_options()
          ("blocks-dir", bpo::value<bfs::path>()->default_value("blocks"),
           "the location of the blocks directory (absolute path or relative to application data dir)")
+         ("blocks-log-segment-size", bpo::value<uint32_t>()->default_value(0),
+          "Number of blocks after which blocks.log is moved to a completed segment and a new one is started, 0 keeps a single block log")
+         ("blocks-log-retained-segments", bpo::value<uint32_t>()->default_value(0),
+          "Number of completed block log segments to keep, older segments are deleted (0 keeps all of them)")
+         ("blockroot-merkle-stride", bpo::value<uint32_t>()->default_value(config::default_blockroot_merkle_stride),
+          "Number of blocks between blockroot merkle checkpoints in the index kept next to blocks.log, 1 stores every block")
          ("checkpoint", bpo::value<vector<string>>()->composing(), "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints.")
          ("wasm-runtime", bpo::value<snax::chain::wasm_interface::vm_type>()->value_name("wavm/wabt"), "Override default WASM runtime")
+         ("wasm-cache-size-mb", bpo::value<uint64_t>()->default_value(config::default_wasm_cache_size / (1024  * 1024)),
+          "Maximum size (in MiB) of the instantiated contracts kept in memory, the least recently used are evicted beyond it")
+         ("wasm-cache-pinned-account", boost::program_options::value<vector<string>>()->composing()->multitoken(),
+          "Account whose contract is never evicted from the instantiated contracts (may specify multiple times, replaces the default of snax, snax.token and platform)")
          ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_ms),
           "Override default maximum ABI serialization time allowed in ms")
          ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024  * 1024)), "Maximum size (in MiB) of the chain state database")
@@ -220,8 +230,14 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          ("reversible-blocks-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_reversible_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the reverseible blocks database drops below this size (in MiB).")
          ("chain-threads", bpo::value<uint16_t>()->default_value(config::default_controller_thread_pool_size),
           "Number of worker threads in controller thread pool")
+         ("replay-read-ahead-blocks", bpo::value<uint32_t>()->default_value(config::default_replay_read_ahead_blocks),
+          "Maximum number of blocks whose transactions and block state are prepared on the controller thread pool ahead of the block being replayed")
+         ("replay-read-ahead-mb", bpo::value<uint64_t>()->default_value(config::default_replay_read_ahead_size / (1024  * 1024)),
+          "Maximum size (in MiB) of the blocks read ahead of the block being replayed")
          ("contracts-console", bpo::bool_switch()->default_value(false),
           "print contract's output to console")
+         ("disable-wasm-code-cache", bpo::bool_switch()->default_value(false),
+          "Don't keep the injected code of contracts in the state directory, every contract is injected again after a restart")
          ("actor-whitelist", boost::program_options::value<vector<string>>()->composing()->multitoken(),
           "Account added to actor whitelist (may specify multiple times)")
          ("actor-blacklist", boost::program_options::value<vector<string>>()->composing()->multitoken(),
@@ -273,6 +289,8 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "recovers reversible block database if that database is in a bad state")
          ("force-all-checks", bpo::bool_switch()->default_value(false),
           "do not skip any checks that can be skipped while replaying irreversible blocks")
+         ("trusted-replay", bpo::bool_switch()->default_value(false),
+          "skip signature recovery and authorization checks, even with force-all-checks, while replaying irreversible blocks up to the highest checkpoint found in the block log, transaction and action merkle roots are still verified")
          ("disable-replay-opts", bpo::bool_switch()->default_value(false),
           "disable optimizations that specifically target replay")
          ("replay-blockchain", bpo::bool_switch()->default_value(false),
@@ -351,6 +369,11 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
 
       LOAD_VALUE_SET( options, "trusted-producer", my->chain_config->trusted_producers );
 
+      if( options.count( "wasm-cache-pinned-account" )) {
+         my->chain_config->wasm_cache_pinned_accounts.clear();
+         LOAD_VALUE_SET( options, "wasm-cache-pinned-account", my->chain_config->wasm_cache_pinned_accounts );
+      }
+
       if( options.count( "action-blacklist" )) {
          const std::vector<std::string>& acts = options["action-blacklist"].as<std::vector<std::string>>();
          auto& list = my->chain_config->action_blacklist;
@@ -404,6 +427,10 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          my->abi_serializer_max_time_ms = fc::microseconds(options.at("abi-serializer-max-time-ms").as<uint32_t>() * 1000);
 
       my->chain_config->blocks_dir = my->blocks_dir;
+      my->chain_config->blocks_log_segment_size = options.at( "blocks-log-segment-size" ).as<uint32_t>();
+      my->chain_config->blocks_log_retained_segments = options.at( "blocks-log-retained-segments" ).as<uint32_t>();
+      my->chain_config->blockroot_merkle_stride = options.at( "blockroot-merkle-stride" ).as<uint32_t>();
+      SNAX_ASSERT( my->chain_config->blockroot_merkle_stride > 0, plugin_config_exception, "blockroot-merkle-stride must be positive" );
       my->chain_config->state_dir = app().data_dir() / config::default_state_dir_name;
       my->chain_config->read_only = my->readonly;
 
@@ -426,12 +453,19 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
                      "chain-threads ${num} must be greater than 0", ("num", my->chain_config->thread_pool_size) );
       }
 
+      my->chain_config->replay_read_ahead_blocks = options.at( "replay-read-ahead-blocks" ).as<uint32_t>();
+      my->chain_config->replay_read_ahead_size = options.at( "replay-read-ahead-mb" ).as<uint64_t>() * 1024 * 1024;
+
       if( my->wasm_runtime )
          my->chain_config->wasm_runtime = *my->wasm_runtime;
+      my->chain_config->wasm_cache_size = options.at( "wasm-cache-size-mb" ).as<uint64_t>() * 1024 * 1024;
 
       my->chain_config->force_all_checks = options.at( "force-all-checks" ).as<bool>();
+      my->chain_config->trusted_replay = options.at( "trusted-replay" ).as<bool>();
+      my->chain_config->checkpoints = my->loaded_checkpoints;
       my->chain_config->disable_replay_opts = options.at( "disable-replay-opts" ).as<bool>();
       my->chain_config->contracts_console = options.at( "contracts-console" ).as<bool>();
+      my->chain_config->persistent_code_cache = !options.at( "disable-wasm-code-cache" ).as<bool>();
       my->chain_config->allow_ram_billing_in_notify = options.at( "disable-ram-billing-notify-checks" ).as<bool>();
 
       if( options.count( "extract-genesis-json" ) || options.at( "print-genesis-json" ).as<bool>()) {
@@ -1383,6 +1417,10 @@ read_only::get_producer_schedule_result read_only::get_producer_schedule( const
    return result;
 }
 
+read_only::get_wasm_cache_stats_results read_only::get_wasm_cache_stats( const read_only::get_wasm_cache_stats_params& ) const {
+   return db.get_wasm_interface().get_cache_stats();
+}
+
 template<typename Api>
 struct resolver_factory {
    static auto make(const Api* api, const fc::microseconds& max_serialization_time) {
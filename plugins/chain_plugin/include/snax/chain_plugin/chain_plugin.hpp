@@ -13,6 +13,7 @@
 #include <snax/chain/resource_limits.hpp>
 #include <snax/chain/transaction.hpp>
 #include <snax/chain/abi_serializer.hpp>
+#include <snax/chain/wasm_instantiation_cache.hpp>
 #include <snax/chain/plugin_interface.hpp>
 #include <snax/chain/types.hpp>
 
@@ -352,6 +353,11 @@ public:
 
    get_producer_schedule_result get_producer_schedule( const get_producer_schedule_params& params )const;
 
+   using get_wasm_cache_stats_params = empty;
+   using get_wasm_cache_stats_results = chain::wasm_cache_stats;
+
+   get_wasm_cache_stats_results get_wasm_cache_stats( const get_wasm_cache_stats_params& )const;
+
    struct get_scheduled_transactions_params {
       bool        json = false;
       string      lower_bound;  /// timestamp OR transaction ID
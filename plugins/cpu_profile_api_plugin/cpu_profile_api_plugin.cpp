@@ -0,0 +1,83 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#include <fc/variant.hpp>
+#include <fc/io/json.hpp>
+#include <snax/cpu_profile_api_plugin/cpu_profile_api_plugin.hpp>
+
+namespace snax {
+
+static appbase::abstract_plugin& _cpu_profile_api_plugin = app().register_plugin<cpu_profile_api_plugin>();
+
+using namespace snax;
+namespace cpu_profiler = chain::cpu_profiler;
+
+#define CALL(api_name, api_handle, call_name, INVOKE, http_response_code) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle](string, string body, url_response_callback cb) mutable { \
+          try { \
+             if (body.empty()) body = "{}"; \
+             INVOKE \
+             cb(http_response_code, fc::json::to_string(result)); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
+#define INVOKE_R_V(api_handle, call_name) \
+     auto result = api_handle->call_name();
+
+#define INVOKE_R_R(api_handle, call_name, in_param) \
+     auto result = api_handle->call_name(fc::json::from_string(body).as<in_param>());
+
+
+void cpu_profile_api_plugin::set_program_options(options_description& cli, options_description& cfg) {
+   cfg.add_options()
+         ("cpu-profile", bpo::bool_switch()->default_value(false),
+          "Collect CPU profiling histograms of transactions, actions, host functions and db calls from startup")
+         ;
+}
+
+void cpu_profile_api_plugin::plugin_initialize(const variables_map& vm) {
+   if( vm["cpu-profile"].as<bool>() )
+      cpu_profiler::set_enabled( true );
+}
+
+void cpu_profile_api_plugin::plugin_startup() {
+   app().get_plugin<http_plugin>().add_api({
+       CALL(cpu_profile, this, get_histograms,
+            INVOKE_R_V(this, get_histograms), 200),
+       CALL(cpu_profile, this, set_enabled,
+            INVOKE_R_R(this, set_enabled, cpu_profile_set_enabled_params), 200),
+       CALL(cpu_profile, this, reset,
+            INVOKE_R_V(this, reset), 200),
+   });
+}
+
+void cpu_profile_api_plugin::plugin_shutdown() {
+   cpu_profiler::set_enabled( false );
+}
+
+cpu_profile_histograms cpu_profile_api_plugin::get_histograms() {
+   cpu_profile_histograms ret;
+   ret.enabled = cpu_profiler::enabled();
+   ret.histograms = cpu_profiler::snapshot();
+   return ret;
+}
+
+chain_apis::empty cpu_profile_api_plugin::set_enabled(const cpu_profile_set_enabled_params& params) {
+   cpu_profiler::set_enabled( params.enabled );
+   return chain_apis::empty();
+}
+
+chain_apis::empty cpu_profile_api_plugin::reset() {
+   cpu_profiler::reset();
+   return chain_apis::empty();
+}
+
+#undef INVOKE_R_R
+#undef INVOKE_R_V
+#undef CALL
+
+}
@@ -0,0 +1,56 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+#pragma once
+
+#include <snax/http_plugin/http_plugin.hpp>
+#include <snax/chain_plugin/chain_plugin.hpp>
+#include <snax/chain/cpu_profiler.hpp>
+
+#include <appbase/application.hpp>
+
+namespace snax {
+
+using namespace appbase;
+
+struct cpu_profile_histograms {
+   bool                                           enabled = false;
+   vector<chain::cpu_profiler::histogram_entry>   histograms;
+};
+
+struct cpu_profile_set_enabled_params {
+   bool enabled = false;
+};
+
+/**
+ * Exposes the CPU profiling histograms of snax::chain::cpu_profiler, collected while profiling is
+ * enabled either with --cpu-profile or through /v1/cpu_profile/set_enabled.
+ */
+class cpu_profile_api_plugin : public plugin<cpu_profile_api_plugin> {
+public:
+   APPBASE_PLUGIN_REQUIRES((http_plugin) (chain_plugin))
+
+   cpu_profile_api_plugin() = default;
+   cpu_profile_api_plugin(const cpu_profile_api_plugin&) = delete;
+   cpu_profile_api_plugin(cpu_profile_api_plugin&&) = delete;
+   cpu_profile_api_plugin& operator=(const cpu_profile_api_plugin&) = delete;
+   cpu_profile_api_plugin& operator=(cpu_profile_api_plugin&&) = delete;
+   virtual ~cpu_profile_api_plugin() override = default;
+
+   virtual void set_program_options(options_description& cli, options_description& cfg) override;
+   void plugin_initialize(const variables_map& vm);
+   void plugin_startup();
+   void plugin_shutdown();
+
+   cpu_profile_histograms get_histograms();
+   chain_apis::empty set_enabled(const cpu_profile_set_enabled_params& params);
+   chain_apis::empty reset();
+
+private:
+};
+
+}
+
+FC_REFLECT( snax::cpu_profile_histograms, (enabled)(histograms) )
+FC_REFLECT( snax::cpu_profile_set_enabled_params, (enabled) )
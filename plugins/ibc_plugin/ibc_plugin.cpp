@@ -6,6 +6,10 @@
 
 #include <snax/ibc_plugin/ibc_plugin.hpp>
 #include <snax/ibc_plugin/protocol.hpp>
+#include <snax/ibc_plugin/message_buffers.hpp>
+#include <snax/ibc_plugin/message_compression.hpp>
+#include <snax/ibc_plugin/ibc_table_mirror.hpp>
+#include <snax/ibc_plugin/windowed_trx_pusher.hpp>
 #include <snax/chain/controller.hpp>
 #include <snax/chain/exceptions.hpp>
 #include <snax/chain/block.hpp>
@@ -26,7 +30,13 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/host_name.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/intrusive/set.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+#include <atomic>
+#include <deque>
 
 using namespace snax::chain::plugin_interface::compat;
 
@@ -65,6 +75,7 @@ namespace snax { namespace ibc {
    const static uint32_t MaxLocalOrigtrxsCache = 100*1000;
    const static uint32_t MaxLocalCashtrxsCache = 100*1000;
    const static uint32_t MaxLocalOldSectionsCache = 5;
+   const static uint32_t MaxBlockTrxsMerkleCache = 16;
 
 
    class connection;
@@ -119,6 +130,121 @@ namespace snax { namespace ibc {
    >
    ibc_section_index;
 
+   /**
+    * What the ibc.chain contract knows about the peer chain's producers where a received section
+    * starts. Empty when the contract doesn't have it, then only the header linkage is checked.
+    */
+   struct section_validation_context {
+      optional<digest_type>                                 pending_schedule_hash;
+      std::map<account_name, std::vector<public_key_type>>  producer_keys;   ///< keys of every schedule the producer is known in
+
+      void add_schedule( const producer_schedule_type& schedule ){
+         for ( const auto& p : schedule.producers ){
+            producer_keys[p.producer_name].push_back( p.block_signing_key );
+         }
+      }
+   };
+
+   /**
+    * A received lwc_section_data_message waiting for its headers to be validated on the controller's
+    * thread pool. Sections are handled in the order they were received, whichever finishes first.
+    */
+   struct pending_section {
+      connection_ptr             conn;
+      lwc_section_data_message   msg;
+      bool                       done = false;
+      bool                       valid = false;
+   };
+   using pending_section_ptr = std::shared_ptr<pending_section>;
+
+   /**
+    * Check that the headers of a section link up and that the schedule changes in it are well formed,
+    * and return the digest every header was signed over. Recovering the signees is left to the caller,
+    * digests are empty while the pending schedule hash is unknown.
+    */
+   vector<digest_type> check_section_headers( const lwc_section_data_message& msg, section_validation_context& ctx ){
+      FC_ASSERT( ! msg.headers.empty(), "section has no headers" );
+
+      vector<digest_type> digests;
+      digests.reserve( msg.headers.size() );
+      incremental_merkle merkle = msg.blockroot_merkle;
+      block_id_type prev_id;
+      uint32_t schedule_version = msg.headers.front().schedule_version;
+
+      for ( const auto& h : msg.headers ){
+         if ( prev_id != block_id_type() ){
+            FC_ASSERT( h.previous == prev_id, "header ${n} doesn't link to the header before it", ("n",h.block_num()) );
+         }
+         FC_ASSERT( h.schedule_version == schedule_version || h.schedule_version == schedule_version + 1,
+                    "header ${n} jumps from schedule version ${o} to ${v}", ("n",h.block_num())("o",schedule_version)("v",h.schedule_version) );
+         schedule_version = h.schedule_version;
+
+         if ( h.new_producers.valid() ){
+            FC_ASSERT( h.new_producers->version == h.schedule_version + 1,
+                       "header ${n} proposes schedule version ${p} while version ${v} is active",
+                       ("n",h.block_num())("p",h.new_producers->version)("v",h.schedule_version) );
+            ctx.pending_schedule_hash = digest_type::hash( *h.new_producers );
+            ctx.add_schedule( *h.new_producers );
+         }
+
+         if ( ctx.pending_schedule_hash.valid() ){
+            // same as block_header_state::sig_digest()
+            auto header_bmroot = digest_type::hash( std::make_pair( h.digest(), merkle.get_root() ) );
+            digests.push_back( digest_type::hash( std::make_pair( header_bmroot, *ctx.pending_schedule_hash ) ) );
+         } else {
+            digests.push_back( digest_type() );
+         }
+
+         prev_id = h.id();
+         merkle.append( prev_id );
+      }
+      return digests;
+   }
+
+   /**
+    * Recover the signee of a header and check it is a key of its producer, runs on the thread pool.
+    */
+   bool verify_section_header_signee( const signed_block_header& h, const digest_type& digest, const section_validation_context& ctx ){
+      if ( digest == digest_type() ){
+         return true;
+      }
+      try {
+         auto signee = fc::crypto::public_key( h.producer_signature, digest, true );
+         if ( ctx.producer_keys.empty() ){
+            return true;
+         }
+         auto itr = ctx.producer_keys.find( h.producer );
+         if ( itr != ctx.producer_keys.end() && std::find( itr->second.begin(), itr->second.end(), signee ) != itr->second.end() ){
+            return true;
+         }
+         elog("header ${n} is signed by ${k}, which is not a key of producer ${p}", ("n",h.block_num())("k",signee)("p",h.producer));
+      } FC_LOG_AND_DROP()
+      return false;
+   }
+
+   struct block_trxs_merkle {
+      block_id_type                             block_id;
+      signed_block_ptr                          block;
+      merkle_tree                               tree;
+      std::map<transaction_id_type,uint32_t>    trx_index;  // position of each packed transaction in block
+   };
+
+   struct by_lru;
+   struct by_block_id;
+
+   typedef multi_index_container<
+         block_trxs_merkle,
+         indexed_by<
+               sequenced< tag< by_lru > >,
+               ordered_unique<
+                     tag< by_block_id >,
+                     member < block_trxs_merkle,
+                           block_id_type,
+                           &block_trxs_merkle::block_id > >
+         >
+   >
+   block_trxs_merkle_index;
+
 
    class ibc_plugin_impl {
    public:
@@ -145,7 +271,6 @@ namespace snax { namespace ibc {
       std::set< connection_ptr >       connections;
       bool                             done = false;
 
-      std::vector<blockroot_merkle_type>     blockroot_merkle_cache;
 
 
       name                                   relay;
@@ -177,10 +302,16 @@ namespace snax { namespace ibc {
       ibc_transaction_index         local_origtrxs;
       ibc_transaction_index         local_cashtrxs;
       ibc_section_index             local_sections;
+      std::deque<pending_section_ptr>  validating_sections;
+      block_trxs_merkle_index       block_trxs_merkles;   ///< most recently used first
       uint32_t                      new_prod_blk_num = 0;
 
       string                        user_agent_name;
       chain_plugin*                 chain_plug = nullptr;
+      send_buffer_pool              send_buffers;   ///< serialized outgoing messages of all connections
+      bool                          compression = true;
+      uint32_t                      push_window = 8;   ///< cash, cashconfirm and rollback transactions kept in flight
+      uint32_t                      max_actions_per_trx = 1;   ///< cash or cashconfirm actions packed into one transaction
       int                           started_sessions = 0;
 
       shared_ptr<tcp::resolver>     resolver;
@@ -223,9 +354,16 @@ namespace snax { namespace ibc {
       void handle_message( connection_ptr c, const ibc_heartbeat_message &msg);
       void handle_message( connection_ptr c, const lwc_init_message &msg);
       void handle_message( connection_ptr c, const lwc_section_request_message &msg);
-      void handle_message( connection_ptr c, const lwc_section_data_message &msg);
+      void handle_message( connection_ptr c, lwc_section_data_message &&msg);
       void handle_message( connection_ptr c, const ibc_trxs_request_message &msg);
-      void handle_message( connection_ptr c, const ibc_trxs_data_message &msg);
+
+      section_validation_context get_section_validation_context( uint32_t first_num );
+      void validate_section( const pending_section_ptr& pending );
+      void process_validated_sections( );
+      void process_section( connection_ptr c, const lwc_section_data_message &msg );
+      void handle_message( connection_ptr c, ibc_trxs_data_message &&msg);
+      void handle_message( connection_ptr c, lwc_section_delta_message &&msg);
+      void handle_message( connection_ptr c, compressed_message &&msg);
 
       lwc_section_type sum_received_lwcls_info( );
       bool is_head_catchup( );
@@ -235,9 +373,10 @@ namespace snax { namespace ibc {
       void ibc_token_contract_checker( ibc_heartbeat_message& msg );
       void start_ibc_heartbeat_timer( );
 
-      incremental_merkle get_brtm_from_cache( uint32_t block_num );
+      optional<incremental_merkle> get_blockroot_merkle( uint32_t block_num );
       uint32_t get_safe_head_tslot( );
 
+      const block_trxs_merkle* get_block_trxs_merkle( uint32_t block_num );
       optional<ibc_trx_rich_info> get_ibc_trx_rich_info( uint32_t block_time_slot, transaction_id_type trx_id, uint64_t table_id );
 
       void check_if_remove_old_data_in_ibc_contracts();
@@ -328,7 +467,16 @@ namespace snax { namespace ibc {
 
    constexpr auto     message_header_size = 4;
 
-   constexpr uint16_t net_version = 1;
+   static_assert( def_send_buffer_size*2 == max_decompressed_message_size, "decompressed messages are limited to the size of a read message" );
+
+   /**
+    * For a while we need to support interop with older versions, the minimum version per feature
+    * 1 - initial
+    * 2 - lwc_section_delta_message and compressed_message
+    */
+   constexpr uint16_t net_version = 2;
+   constexpr uint16_t compression_net_version = 2;
+   constexpr uint32_t min_compressed_message_size = 1024;
 
    struct handshake_initializer {
       static void populate( handshake_message& hello );
@@ -344,6 +492,7 @@ namespace snax { namespace ibc {
       socket_ptr              socket;
 
       fc::message_buffer<1024*1024>    pending_message_buffer;
+      vector<char>                     decode_scratch;   ///< messages straddling buffer chunks are decoded from here
       fc::optional<std::size_t>        outstanding_read_bytes;
 
       struct queued_write {
@@ -358,6 +507,7 @@ namespace snax { namespace ibc {
       int16_t                 sent_handshake_count = 0;
       bool                    connecting = false;
       uint16_t                protocol_version  = 0;
+      bool                    send_compressed = false;   ///< the peer can decode compressed messages and we want to send them
       string                  peer_addr;
       unique_ptr<boost::asio::steady_timer> response_expected;
       go_away_reason          no_retry = no_reason;
@@ -469,10 +619,11 @@ namespace snax { namespace ibc {
       connection_ptr c;
       msgHandler( ibc_plugin_impl &imp, connection_ptr conn) : impl(imp), c(conn) {}
 
+      // the message is decoded for this call only, handlers that keep parts of it take it by rvalue
       template <typename T>
-      void operator()(const T &msg) const
+      void operator()(T &msg) const
       {
-         impl.handle_message( c, msg);
+         impl.handle_message( c, std::move(msg) );
       }
    };
 
@@ -562,6 +713,10 @@ namespace snax { namespace ibc {
       return optional<key_value_object>();
    }
 
+   uint32_t chain_head_block_num(){
+      return app().get_plugin<chain_plugin>().chain().head_block_num();
+   }
+
    // ---- contract exist check ----
    bool account_has_contract( name account ){
       auto ro_api = app().get_plugin<chain_plugin>().get_read_only_api();
@@ -648,17 +803,21 @@ namespace snax { namespace ibc {
       } FC_LOG_AND_DROP()
    }
 
-   optional<signed_transaction> generate_signed_transaction_from_action( action actn ){
+   optional<signed_transaction> generate_signed_transaction_from_actions( const vector<action>& actns ){
       if ( my_impl->relay_private_key == chain::private_key_type() ){
          elog("ibc relay private key not found, can not execute action");
          return optional<signed_transaction>();
       }
       signed_transaction trx;
-      trx.actions.emplace_back( actn );
+      trx.actions = actns;
       set_transaction_headers( trx );
       trx.sign( my_impl->relay_private_key, my_impl->chain_plug->chain().get_chain_id() );
       return trx;
    }
+
+   optional<signed_transaction> generate_signed_transaction_from_action( action actn ){
+      return generate_signed_transaction_from_actions( vector<action>{ actn } );
+   }
    
    void push_action( action actn ) {
       auto trx_opt = generate_signed_transaction_from_action( actn );
@@ -669,7 +828,27 @@ namespace snax { namespace ibc {
       }
    }
 
-   
+   /// a windowed_trx_pusher pushing through the chain plugin with the relay's limits
+   std::shared_ptr<windowed_trx_pusher> make_pusher( const string& batch_name, uint32_t count, uint64_t start_seq_num, uint32_t max_pack,
+                                                     windowed_trx_pusher::failure_mode mode, windowed_trx_pusher::build_func build,
+                                                     windowed_trx_pusher::done_func done = windowed_trx_pusher::done_func() ){
+      auto push = []( const signed_transaction& trx, windowed_trx_pusher::result_func next ){
+         my_impl->chain_plug->get_read_write_api().push_transaction_v2( fc::variant_object(mvo(packed_transaction(trx))),
+            [next]( const fc::static_variant<fc::exception_ptr, chain_apis::read_write::push_transaction_results>& result ){
+               if ( result.contains<fc::exception_ptr>() ){
+                  next( result.get<fc::exception_ptr>(), fc::variant() );
+               } else {
+                  next( fc::exception_ptr(), result.get<chain_apis::read_write::push_transaction_results>().processed );
+               }
+            });
+      };
+      auto config = [](){
+         return my_impl->chain_plug->chain().get_global_properties().configuration;
+      };
+      return std::make_shared<windowed_trx_pusher>( batch_name, count, start_seq_num, my_impl->push_window, max_pack, mode,
+                                                    push, config, build, done );
+   }
+
    // --------------- ibc_chain_contract ---------------
    class ibc_chain_contract {
    public:
@@ -690,6 +869,7 @@ namespace snax { namespace ibc {
       uint32_t                            get_sections_tb_size() const;
       optional<block_header_state_type>   get_chaindb_tb_bhs_by_block_num( uint64_t num ) const;
       block_id_type                       get_chaindb_tb_block_id_by_block_num( uint64_t num ) const;
+      optional<producer_schedule_type>    get_prodsches_tb_schedule_by_id( uint64_t id ) const;
       optional<global_state_ibc_chain>    get_global_singleton() const;
       void                                get_blkrtmkls_tb() ;
 
@@ -820,6 +1000,28 @@ namespace snax { namespace ibc {
       return block_id_type();
    }
 
+   optional<producer_schedule_type> ibc_chain_contract::get_prodsches_tb_schedule_by_id( uint64_t id ) const {
+      chain_apis::read_only::get_table_rows_params par;
+      par.json = true;  // must be true
+      par.code = account;
+      par.scope = account.to_string();
+      par.table = N(prodsches);
+      par.table_key = "id";
+      par.lower_bound = to_string(id);
+      par.upper_bound = to_string(id + 1);
+      par.limit = 1;
+      par.key_type = "i64";
+      par.index_position = "1";
+
+      try {
+         auto result = my_impl->chain_plug->get_read_only_api().get_table_rows( par );
+         if ( result.rows.size() != 0 ){
+            return result.rows[0]["schedule"].as<producer_schedule_type>();
+         }
+      } FC_LOG_AND_DROP()
+      return optional<producer_schedule_type>();
+   }
+
    optional<global_state_ibc_chain> ibc_chain_contract::get_global_singleton() const {
       auto p = get_singleton_kvo( account, account, N(global) );
       if ( p.valid() ){
@@ -904,7 +1106,10 @@ namespace snax { namespace ibc {
    // --------------- ibc_token_contract ---------------
    class ibc_token_contract {
    public:
-      ibc_token_contract( name contract ):account(contract){}
+      ibc_token_contract( name contract )
+      :account(contract),
+       origtrxs_mirror(app().get_plugin<chain_plugin>().chain().db(), chain_head_block_num, contract, N(origtrxs)),
+       cashtrxs_mirror(app().get_plugin<chain_plugin>().chain().db(), chain_head_block_num, contract, N(cashtrxs)){}
       contract_state state = none;
 
       // actions
@@ -926,14 +1131,11 @@ namespace snax { namespace ibc {
 
       transaction_id_type last_origtrx_pushed;  // note: update this even push failed
 
-      // recurse actions
-      void push_cash_recurse( int index, const std::shared_ptr<std::vector<cash_action_params>>& params, uint32_t start_seq_num );
+      // windowed actions
       void push_cash_trxs( const std::vector<ibc_trx_rich_info>& params, uint32_t start_seq_num );
-
-      void push_cashconfirm_recurse( int index, const std::shared_ptr<std::vector<cashconfirm_action_params>>& params );
       void push_cashconfirm_trxs( const std::vector<ibc_trx_rich_info>& params, uint64_t start_seq_num );
 
-      void push_rborrm_recurse( int index, const std::shared_ptr<std::vector<transaction_id_type>>& params, name action_name);
+      void push_rborrm_trxs( const std::vector<transaction_id_type>& params, name action_name );
       void rollback( const std::vector<transaction_id_type> trxs );
       void rmunablerb( const std::vector<transaction_id_type> trxs );
 
@@ -942,10 +1144,34 @@ namespace snax { namespace ibc {
       bool has_contract();
       void get_contract_state();
 
+      // table mirrors
+      void on_accepted_block();
+
+      /// of the latest batch of each kind
+      vector<push_batch_stats> push_stats()const;
+
    private:
       name account;
+
+      ibc_table_mirror<original_trx_info, &original_trx_info::id>   origtrxs_mirror;
+      ibc_table_mirror<cash_trx_info, &cash_trx_info::seq_num>      cashtrxs_mirror;
+
+      // a new batch of a kind is only started once the previous one has finished
+      std::shared_ptr<windowed_trx_pusher>   cash_pusher;
+      std::shared_ptr<windowed_trx_pusher>   cashconfirm_pusher;
+      std::shared_ptr<windowed_trx_pusher>   rborrm_pusher;
    };
 
+   vector<push_batch_stats> ibc_token_contract::push_stats()const {
+      vector<push_batch_stats> result;
+      for ( const auto& pusher : { cash_pusher, cashconfirm_pusher, rborrm_pusher } ){
+         if ( pusher ){
+            result.push_back( pusher->stats() );
+         }
+      }
+      return result;
+   }
+
    optional<memo_info_type> ibc_token_contract::get_memo_info( const string& memo_str ){
 
       memo_info_type info;
@@ -1012,110 +1238,55 @@ namespace snax { namespace ibc {
       state = c_state;
    }
 
+   void ibc_token_contract::on_accepted_block() {
+      origtrxs_mirror.on_accepted_block();
+      cashtrxs_mirror.on_accepted_block();
+   }
+
    range_type ibc_token_contract::get_table_origtrxs_id_range( bool raw ) {
-      auto range = get_table_primary_key_range( account, account, N(origtrxs) );
-      if ( raw ){
+      auto range = origtrxs_mirror.key_range();
+      if ( raw || range == range_type() ){
          return range;
       }
       uint64_t safe_tslot = my_impl->get_safe_head_tslot() + DiffOfTrxBeforeMinDepth;
 
-      chain_apis::read_only::get_table_rows_params par;
-      par.json = true;  // must be true
-      par.code = account;
-      par.scope = account.to_string();
-      par.table = N(origtrxs);
-      par.table_key = "tslot";
-      par.lower_bound = to_string(safe_tslot);
-      par.upper_bound = "";   // to last
-      par.limit = 1;
-      par.key_type = "i64";
-      par.index_position = "2";  // by_slot
-      try {
-         auto result = my_impl->chain_plug->get_read_only_api().get_table_rows( par );
-         if ( result.rows.size() != 0 ){
-            auto info = result.rows.front().as<original_trx_info>();
-            range.second = info.id - 1;
-            if ( range.second < range.first ){
-               return range_type();
-            }
+      auto info = origtrxs_mirror.first_row_from_tslot( safe_tslot );
+      if ( info.valid() ){
+         if ( info->id <= range.first ){
+            return range_type();
          }
-      } FC_LOG_AND_DROP()
-
+         range.second = info->id - 1;
+      }
       return range;
    }
 
    optional<original_trx_info> ibc_token_contract::get_table_origtrxs_trx_info_by_id( uint64_t id ) {
-      chain_apis::read_only::get_table_rows_params par;
-      par.json = true;  // must be true
-      par.code = account;
-      par.scope = account.to_string();
-      par.table = N(origtrxs);
-      par.table_key = "id";
-      par.lower_bound = to_string(id);
-      par.upper_bound = to_string(id + 1);
-      par.limit = 1;
-      par.key_type = "i64";
-      par.index_position = "1";
-
       try {
-         auto result = my_impl->chain_plug->get_read_only_api().get_table_rows( par );
-         if ( result.rows.size() != 0 ){
-            return result.rows.front().as<original_trx_info>();
-         }
+         return origtrxs_mirror.find( id );
       } FC_LOG_AND_DROP()
       return optional<original_trx_info>();
    }
 
    range_type ibc_token_contract::get_table_cashtrxs_seq_num_range( bool raw ) {
-      auto range = get_table_primary_key_range( account, account, N(cashtrxs) );
-      if ( raw ){
+      auto range = cashtrxs_mirror.key_range();
+      if ( raw || range == range_type() ){
          return range;
       }
       uint64_t safe_tslot = my_impl->get_safe_head_tslot() + DiffOfTrxBeforeMinDepth;
 
-      chain_apis::read_only::get_table_rows_params par;
-      par.json = true;  // must be true
-      par.code = account;
-      par.scope = account.to_string();
-      par.table = N(cashtrxs);
-      par.table_key = "tslot";
-      par.lower_bound = to_string(safe_tslot);
-      par.upper_bound = "";   // to last
-      par.limit = 1;
-      par.key_type = "i64";
-      par.index_position = "2";  // by_slot
-      try {
-         auto result = my_impl->chain_plug->get_read_only_api().get_table_rows( par );
-         if ( result.rows.size() != 0 ){
-            auto info = result.rows.front().as<cash_trx_info>();
-            range.second = info.seq_num - 1;
-            if ( range.second < range.first ){
-               return range_type();
-            }
+      auto info = cashtrxs_mirror.first_row_from_tslot( safe_tslot );
+      if ( info.valid() ){
+         if ( info->seq_num <= range.first ){
+            return range_type();
          }
-      } FC_LOG_AND_DROP()
-
+         range.second = info->seq_num - 1;
+      }
       return range;
    }
 
    optional<cash_trx_info> ibc_token_contract::get_table_cashtrxs_trx_info_by_seq_num( uint64_t seq_num ) {
-      chain_apis::read_only::get_table_rows_params par;
-      par.json = true;  // must be true
-      par.code = account;
-      par.scope = account.to_string();
-      par.table = N(cashtrxs);
-      par.table_key = "seq_num";
-      par.lower_bound = to_string(seq_num);
-      par.upper_bound = to_string(seq_num + 1);
-      par.limit = 1;
-      par.key_type = "i64";
-      par.index_position = "1";
-
       try {
-         auto result = my_impl->chain_plug->get_read_only_api().get_table_rows( par );
-         if ( result.rows.size() != 0 ){
-            return result.rows.front().as<cash_trx_info>();
-         }
+         return cashtrxs_mirror.find( seq_num );
       } FC_LOG_AND_DROP()
       return optional<cash_trx_info>();
    }
@@ -1181,55 +1352,6 @@ namespace snax { namespace ibc {
       return optional<cash_action_params>();
    }
 
-   void ibc_token_contract::push_cash_recurse( int index, const std::shared_ptr<std::vector<cash_action_params>>& params, uint32_t start_seq_num  ){
-      auto next = [=](const fc::static_variant<fc::exception_ptr, chain_apis::read_write::push_transaction_results>& result) {
-         uint32_t next_seq_num = start_seq_num;
-         if (result.contains<fc::exception_ptr>()) {
-            try {
-               result.get<fc::exception_ptr>()->dynamic_rethrow_exception();
-            } FC_LOG_AND_DROP()
-            elog("push cash transaction failed, orig_trx_id ${id}, index ${i}",("id", params->at(index).orig_trx_id)("i",index));
-         } else {
-            auto trx_id = result.get<chain_apis::read_write::push_transaction_results>().transaction_id;
-            dlog("pushed cash transaction: ${id}, index ${idx}", ( "id", trx_id )("idx", index));
-            next_seq_num += 1;
-         }
-
-         last_origtrx_pushed = params->at(index).orig_trx_id; // used to push failed cash transactions a certain number of times
-         int next_index = index + 1;
-         if (next_index < params->size()) {
-            push_cash_recurse( next_index, params, next_seq_num );
-         } else {
-            dlog("all ${sum} cash transactions have tried to push, which belongs to blocks [${f},${t}]",
-                 ("sum",params->size())("f",params->front().orig_trx_block_num)("t",params->back().orig_trx_block_num));
-         }
-      };
-
-      auto par = params->at(index);
-      auto actn = get_action( account, N(cash), vector<permission_level>{{ my_impl->relay, config::active_name}}, mvo()
-               ("seq_num",                      start_seq_num)
-               ("orig_trx_block_num",           par.orig_trx_block_num)
-               ("orig_trx_packed_trx_receipt",  par.orig_trx_packed_trx_receipt)
-               ("orig_trx_merkle_path",         par.orig_trx_merkle_path)
-               ("orig_trx_id",                  par.orig_trx_id)
-               ("to",                           par.to)
-               ("quantity",                     par.quantity)
-               ("memo",                         par.memo)
-               ("relay",                        my_impl->relay ));
-
-      if ( ! actn.valid() ){
-         elog("get cash action failed");
-         return;
-      }
-
-      auto trx_opt = generate_signed_transaction_from_action( *actn );
-      if ( ! trx_opt.valid() ){
-         elog("generate_signed_transaction_from_action failed");
-         return;
-      }
-      my_impl->chain_plug->get_read_write_api().push_transaction_v2( fc::variant_object(mvo(packed_transaction(*trx_opt))), next );
-   }
-
    void ibc_token_contract::push_cash_trxs( const std::vector<ibc_trx_rich_info>& params, uint32_t start_seq_num ){
       std::vector<cash_action_params> actions;
       for ( const auto& trx : params ){
@@ -1263,57 +1385,52 @@ namespace snax { namespace ibc {
          return;
       }
 
+      if ( cash_pusher && ! cash_pusher->finished() ){
+         wlog("previous cash transactions are still in flight, skip pushing ${n} more", ("n",actions.size()));
+         return;
+      }
+
       try {
          SNAX_ASSERT( actions.size() <= 1000, "Attempt to push too many transactions at once" );
          auto params_copy = std::make_shared<std::vector<cash_action_params>>(actions.begin(), actions.end());
-         push_cash_recurse( 0, params_copy, start_seq_num );
+         auto contract = account;
+         auto build = [params_copy, contract]( uint32_t first, uint32_t count, uint64_t seq_num ) -> optional<signed_transaction> {
+            vector<action> actns;
+            for ( uint32_t i = 0; i < count; ++i ){
+               const auto& par = params_copy->at(first + i);
+               auto actn = get_action( contract, N(cash), vector<permission_level>{{ my_impl->relay, config::active_name}}, mvo()
+                        ("seq_num",                      seq_num + i)
+                        ("orig_trx_block_num",           par.orig_trx_block_num)
+                        ("orig_trx_packed_trx_receipt",  par.orig_trx_packed_trx_receipt)
+                        ("orig_trx_merkle_path",         par.orig_trx_merkle_path)
+                        ("orig_trx_id",                  par.orig_trx_id)
+                        ("to",                           par.to)
+                        ("quantity",                     par.quantity)
+                        ("memo",                         par.memo)
+                        ("relay",                        my_impl->relay ));
+
+               if ( ! actn.valid() ){
+                  elog("get cash action failed");
+                  return optional<signed_transaction>();
+               }
+               actns.emplace_back( *actn );
+            }
+            return generate_signed_transaction_from_actions( actns );
+         };
+         auto done = [this, params_copy]( uint32_t first, uint32_t count, bool succeeded ){
+            if ( ! succeeded ){
+               elog("push cash transaction failed, orig_trx_id ${id}, index ${i}",("id", params_copy->at(first).orig_trx_id)("i",first));
+            }
+            last_origtrx_pushed = params_copy->at(first + count - 1).orig_trx_id; // used to push failed cash transactions a certain number of times
+         };
+
+         cash_pusher = make_pusher( "cash", params_copy->size(), start_seq_num, my_impl->max_actions_per_trx,
+                                    windowed_trx_pusher::rewind_on_failure, build, done );
+         cash_pusher->start();
       } FC_LOG_AND_DROP()
    }
 
 
-   void ibc_token_contract::push_cashconfirm_recurse( int index, const std::shared_ptr<std::vector<cashconfirm_action_params>>& params ){
-      auto next = [=](const fc::static_variant<fc::exception_ptr, chain_apis::read_write::push_transaction_results>& result) {
-         if (result.contains<fc::exception_ptr>()) {
-            try {
-               result.get<fc::exception_ptr>()->dynamic_rethrow_exception();
-            } FC_LOG_AND_DROP()
-            elog("push cashconfirm transaction failed, cash_trx_id: ${id}, ${s} succeed, ${l} left",("id",params->at(index).cash_trx_id)("s",index)("l",params->size() - index));
-            return;
-         } else {
-            auto trx_id = result.get<chain_apis::read_write::push_transaction_results>().transaction_id;
-            dlog("pushed cashconfirm transaction: ${id}, index ${idx}", ( "id", trx_id )("idx", index));
-         }
-
-         int next_index = index + 1;
-         if (next_index < params->size()) {
-            push_cashconfirm_recurse( next_index, params );
-         } else {
-            dlog("successfully pushed all ${sum} cashconfirm transactions, which belongs to blocks [${f},${t}]",
-               ("sum",params->size())("f",params->front().cash_trx_block_num)("t",params->back().cash_trx_block_num));
-         }
-      };
-
-      auto par = params->at(index);
-      auto actn = get_action( account, N(cashconfirm), vector<permission_level>{{ my_impl->relay, config::active_name}}, mvo()
-         ("cash_trx_block_num",           par.cash_trx_block_num)
-         ("cash_trx_packed_trx_receipt",  par.cash_trx_packed_trx_receipt)
-         ("cash_trx_merkle_path",         par.cash_trx_merkle_path)
-         ("cash_trx_id",                  par.cash_trx_id)
-         ("orig_trx_id",                  par.orig_trx_id));
-
-      if ( ! actn.valid() ){
-         elog("get cashconfirm action failed");
-         return;
-      }
-
-      auto trx_opt = generate_signed_transaction_from_action( *actn );
-      if ( ! trx_opt.valid() ){
-         elog("generate_signed_transaction_from_action failed");
-         return;
-      }
-      my_impl->chain_plug->get_read_write_api().push_transaction_v2( fc::variant_object(mvo(packed_transaction(*trx_opt))), next );
-   }
-
    void ibc_token_contract::push_cashconfirm_trxs( const std::vector<ibc_trx_rich_info>& params, uint64_t start_seq_num ) {
       std::vector<cashconfirm_action_params> actions;
       uint64_t next_seq_num = start_seq_num;
@@ -1353,10 +1470,44 @@ namespace snax { namespace ibc {
          return;
       }
 
+      if ( cashconfirm_pusher && ! cashconfirm_pusher->finished() ){
+         wlog("previous cashconfirm transactions are still in flight, skip pushing ${n} more", ("n",actions.size()));
+         return;
+      }
+
       try {
          SNAX_ASSERT( actions.size() <= 1000, "Attempt to push too many transactions at once" );
          auto params_copy = std::make_shared<std::vector<cashconfirm_action_params>>(actions.begin(), actions.end());
-         push_cashconfirm_recurse( 0, params_copy );
+         auto contract = account;
+         auto build = [params_copy, contract]( uint32_t first, uint32_t count, uint64_t ) -> optional<signed_transaction> {
+            vector<action> actns;
+            for ( uint32_t i = 0; i < count; ++i ){
+               const auto& par = params_copy->at(first + i);
+               auto actn = get_action( contract, N(cashconfirm), vector<permission_level>{{ my_impl->relay, config::active_name}}, mvo()
+                  ("cash_trx_block_num",           par.cash_trx_block_num)
+                  ("cash_trx_packed_trx_receipt",  par.cash_trx_packed_trx_receipt)
+                  ("cash_trx_merkle_path",         par.cash_trx_merkle_path)
+                  ("cash_trx_id",                  par.cash_trx_id)
+                  ("orig_trx_id",                  par.orig_trx_id));
+
+               if ( ! actn.valid() ){
+                  elog("get cashconfirm action failed");
+                  return optional<signed_transaction>();
+               }
+               actns.emplace_back( *actn );
+            }
+            return generate_signed_transaction_from_actions( actns );
+         };
+         auto done = [params_copy]( uint32_t first, uint32_t, bool succeeded ){
+            if ( ! succeeded ){
+               elog("push cashconfirm transaction failed, cash_trx_id: ${id}, ${s} succeed, ${l} left",("id",params_copy->at(first).cash_trx_id)("s",first)("l",params_copy->size() - first));
+            }
+         };
+
+         // cashconfirm can't jump over a failed seq_num, the next round restarts from the contract state
+         cashconfirm_pusher = make_pusher( "cashconfirm", params_copy->size(), start_seq_num, my_impl->max_actions_per_trx,
+                                           windowed_trx_pusher::stop_on_failure, build, done );
+         cashconfirm_pusher->start();
       } FC_LOG_AND_DROP()
    }
 
@@ -1394,40 +1545,28 @@ namespace snax { namespace ibc {
       push_action( *actn );
    }
 
-   void ibc_token_contract::push_rborrm_recurse( int index, const std::shared_ptr<std::vector<transaction_id_type>>& params, name action_name){
-      auto next = [=](const fc::static_variant<fc::exception_ptr, chain_apis::read_write::push_transaction_results>& result) {
-         if (result.contains<fc::exception_ptr>()) {
-            try {
-               result.get<fc::exception_ptr>()->dynamic_rethrow_exception();
-            } FC_LOG_AND_DROP()
-            elog("push rollback transaction failed, index ${idx}", ("idx", index));
-         } else {
-            auto trx_id = result.get<chain_apis::read_write::push_transaction_results>().transaction_id;
-            dlog("pushed rollback transaction: ${id}, index ${idx}", ( "id", trx_id )("idx", index));
-         }
+   void ibc_token_contract::push_rborrm_trxs( const std::vector<transaction_id_type>& params, name action_name ){
+      if ( rborrm_pusher && ! rborrm_pusher->finished() ){
+         wlog("previous rollback transactions are still in flight, skip pushing ${n} ${a}", ("n",params.size())("a",action_name));
+         return;
+      }
 
-         int next_index = index + 1;
-         if (next_index < params->size()) {
-            push_rborrm_recurse( next_index, params, action_name );
+      auto params_copy = std::make_shared<std::vector<transaction_id_type>>(params.begin(), params.end());
+      auto contract = account;
+      auto build = [params_copy, contract, action_name]( uint32_t first, uint32_t, uint64_t ) -> optional<signed_transaction> {
+         auto actn = get_action( contract, action_name, vector<permission_level>{{ my_impl->relay, config::active_name}}, mvo()
+            ("trx_id",         params_copy->at(first))
+            ("relay",          my_impl->relay));
+
+         if ( ! actn.valid() ){
+            elog("newsection: get action failed");
+            return optional<signed_transaction>();
          }
+         return generate_signed_transaction_from_action( *actn );
       };
 
-      auto trx_id = params->at(index);
-      auto actn = get_action( account, action_name, vector<permission_level>{{ my_impl->relay, config::active_name}}, mvo()
-         ("trx_id",         trx_id)
-         ("relay",          my_impl->relay));
-
-      if ( ! actn.valid() ){
-         elog("newsection: get action failed");
-         return;
-      }
-
-      auto trx_opt = generate_signed_transaction_from_action( *actn );
-      if ( ! trx_opt.valid() ){
-         elog("generate_signed_transaction_from_action failed");
-         return;
-      }
-      my_impl->chain_plug->get_read_write_api().push_transaction_v2( fc::variant_object(mvo(packed_transaction(*trx_opt))), next );
+      rborrm_pusher = make_pusher( action_name.to_string(), params_copy->size(), 0, 1, windowed_trx_pusher::skip_failed, build );
+      rborrm_pusher->start();
    }
 
    void ibc_token_contract::rollback( const std::vector<transaction_id_type> trxs ){
@@ -1437,8 +1576,7 @@ namespace snax { namespace ibc {
 
       try {
          SNAX_ASSERT( trxs.size() <= 1000, "Attempt to push too many transactions at once" );
-         auto params_copy = std::make_shared<std::vector<transaction_id_type>>(trxs.begin(), trxs.end());
-         push_rborrm_recurse( 0, params_copy, N(rollback) );
+         push_rborrm_trxs( trxs, N(rollback) );
       } FC_LOG_AND_DROP()
    }
 
@@ -1449,8 +1587,7 @@ namespace snax { namespace ibc {
 
       try {
          SNAX_ASSERT( trxs.size() <= 1000, "Attempt to push too many transactions at once" );
-         auto params_copy = std::make_shared<std::vector<transaction_id_type>>(trxs.begin(), trxs.end());
-         push_rborrm_recurse( 0, params_copy, N(rmunablerb) );
+         push_rborrm_trxs( trxs, N(rmunablerb) );
       } FC_LOG_AND_DROP()
    }
 
@@ -1630,6 +1767,22 @@ namespace snax { namespace ibc {
    }
 
    void connection::enqueue( const ibc_message &m, bool trigger_send ) {
+      if ( send_compressed ){
+         if ( m.contains<lwc_section_data_message>() ){
+            auto delta = encode_section( m.get<lwc_section_data_message>() );
+            if ( delta.valid() ){
+               enqueue( ibc_message( std::move(*delta) ), trigger_send );
+               return;
+            }
+         } else if ( m.contains<ibc_trxs_data_message>() ){
+            auto compressed = compress_message( m, min_compressed_message_size );
+            if ( compressed.valid() ){
+               enqueue( ibc_message( std::move(*compressed) ), trigger_send );
+               return;
+            }
+         }
+      }
+
       go_away_reason close_after_send = no_reason;
       if (m.contains<go_away_message>()) {
          close_after_send = m.get<go_away_message>().reason;
@@ -1641,7 +1794,7 @@ namespace snax { namespace ibc {
 
       size_t buffer_size = header_size + payload_size;
 
-      auto send_buffer = std::make_shared<vector<char>>(buffer_size);
+      auto send_buffer = my_impl->send_buffers.get( buffer_size );
       fc::datastream<char*> ds( send_buffer->data(), buffer_size);
       ds.write( header, header_size );
       fc::raw::pack( ds, m );
@@ -1686,9 +1839,8 @@ namespace snax { namespace ibc {
             by += 7;
          } while( uint8_t(b) & 0x80 && by < 32);
 
-         auto ds = pending_message_buffer.create_datastream();
          ibc_message msg;
-         fc::raw::unpack(ds, msg);
+         decode_message( pending_message_buffer, message_length, decode_scratch, msg );
          msgHandler m(impl, shared_from_this() );
          msg.visit(m);
       } catch(  const fc::exception& e ) {
@@ -2014,19 +2166,11 @@ namespace snax { namespace ibc {
 
    void ibc_plugin_impl::accepted_block(const block_state_ptr& block) {
       fc_dlog(logger,"signaled, block: ${n}, id: ${id}",("n", block->block_num)("id", block->id));
+      token_contract->on_accepted_block();
    }
 
    void ibc_plugin_impl::irreversible_block(const block_state_ptr& block) {
       /* fc_dlog(logger,"signaled, block: ${n}, id: ${id}",("n", block->block_num)("id", block->id)); */
-      blockroot_merkle_type brtm;
-      brtm.block_num = block->block_num;
-      brtm.merkle = block->blockroot_merkle;
-
-      blockroot_merkle_cache.push_back( brtm );
-      if ( blockroot_merkle_cache.size() > 3600*BlocksPerSecond*24*7 ){ // one week
-         blockroot_merkle_cache.erase( blockroot_merkle_cache.begin() );
-      }
-
 //      static constexpr uint32_t range = ( 1 << 10 ) * 4; // about 30 minutes
 //      if ( block->block_num % range == 0 ){
 //         ilog("push block ${n}'s block_merkle to chain contract",("n",block->block_num ));
@@ -2118,6 +2262,7 @@ namespace snax { namespace ibc {
 //         }
 //#endif
          c->protocol_version = msg.network_version;
+         c->send_compressed = compression && c->protocol_version >= compression_net_version;
          if(c->protocol_version != net_version) {
             if (network_version_match) {
                elog("Peer network version does not match expected ${nv} but got ${mnv}",
@@ -2369,70 +2514,24 @@ namespace snax { namespace ibc {
 
       for ( uint32_t start_num = msg.start_block_num; start_num < end_num; start_num += MaxSendSectionLength ){
          lwc_section_data_message ret_msg;
-         uint32_t check_num = start_num;
 
-         auto start_bsp = chain_plug->chain().fetch_block_state_by_number( check_num );
+         auto start_bsp = chain_plug->chain().fetch_block_state_by_number( start_num );
          if ( start_bsp != block_state_ptr() ){
             ret_msg.blockroot_merkle = start_bsp->blockroot_merkle;
-            ret_msg.headers.push_back( start_bsp->header );
          } else {
-            auto sbp = chain_plug->chain().fetch_block_by_number(start_num);
-            if ( sbp == signed_block_ptr() ){
-               elog("block ${n} not exist", ("n", start_num));
+            auto mkl = get_blockroot_merkle( start_num );
+            if ( ! mkl.valid() ){
+               elog("didn't find blockroot_merkle of block ${n} in blockroot merkle index", ("n", start_num));
                return;
             }
-
-            // search form cache
-            incremental_merkle mkl = get_brtm_from_cache( start_num );
-            if ( mkl._node_count != 0 && mkl._active_nodes.size() > 0 ){
-               ret_msg.blockroot_merkle = mkl;
-               ret_msg.headers.push_back( *sbp );
-            } else {    // when node restart
-               ilog("didn't find blockroot_merkle of block ${n} in cache, calculate it by known blockroot_merkles",("n",check_num));
-
-               blockroot_merkle_type walk_point;
-               walk_point.block_num = start_num - ( start_num % 64 );
-               auto sbp = chain_plug->chain().fetch_block_by_number(walk_point.block_num);
-               if ( sbp == signed_block_ptr() ){
-                  elog("block ${n} not exist", ("n", start_num));
-                  return;
-               }
-               bool has_merkle_extension = false;
-               for( auto& ext : sbp->block_extensions ){
-                  if ( ext.first == 0xF && ext.second.size() > 0 ){
-                     has_merkle_extension = true;
-                     walk_point.merkle = fc::raw::unpack<incremental_merkle>( ext.second );
-                     break;
-                  }
-               }
-
-               if ( ! has_merkle_extension ){
-                  elog("didn't find blockroot_merkle of block ${n} in block_log.dat, can't calculate block ${m}'s blockroot_merkle",("n",walk_point.block_num )("m",check_num));
-                  return;
-               } else {
-                  dlog("calculate block ${n}'s blockroot_merkle from block ${m}",("n",check_num)("m",walk_point.block_num ));
-               }
-
-               uint32_t count = check_num - walk_point.block_num;
-               for( uint32_t i = 0; i < count; ++i ){
-                  walk_point.merkle.append( chain_plug->chain().get_block_id_for_num( walk_point.block_num ) );
-                  walk_point.block_num++;
-               }
-
-               if (walk_point.block_num == check_num ){
-                  ret_msg.blockroot_merkle = walk_point.merkle;
-                  ret_msg.headers.push_back( *(chain_plug->chain().fetch_block_by_number(walk_point.block_num)) );
-               } else {
-                  elog("internal error, calculate blockroot_merkle of block ${n} failed", ("n",check_num));
-                  return;
-               }
-            }
+            ret_msg.blockroot_merkle = *mkl;
          }
-         ++check_num;
+
          uint32_t tmp_end_num = std::min( start_num + MaxSendSectionLength - 1, end_num );
-         while ( check_num <= tmp_end_num ){
-            ret_msg.headers.push_back( *(chain_plug->chain().fetch_block_by_number( check_num )) );
-            check_num += 1;
+         ret_msg.headers = chain_plug->chain().fetch_block_headers_by_number( start_num, tmp_end_num - start_num + 1 );
+         if ( ret_msg.headers.size() != tmp_end_num - start_num + 1 ){
+            elog("block headers [${from},${to}] not exist", ("from", start_num)("to", tmp_end_num));
+            return;
          }
          peer_ilog(c,"sending lwc_section_data_message, range [${from},${to}], merkle nodes ${nodes}", ("from",start_num)("to",tmp_end_num)("nodes",ret_msg.blockroot_merkle._active_nodes.size()));
          c->enqueue( ret_msg );
@@ -2441,9 +2540,102 @@ namespace snax { namespace ibc {
       }
    }
 
-   void ibc_plugin_impl::handle_message( connection_ptr c, const lwc_section_data_message &msg) {
+   void ibc_plugin_impl::handle_message( connection_ptr c, lwc_section_data_message &&msg) {
+      if ( msg.headers.empty() ){
+         peer_elog(c, "received lwc_section_data_message without headers");
+         return;
+      }
       peer_ilog(c, "received lwc_section_data_message [${from},${to}]",("from",msg.headers.front().block_num())("to",msg.headers.back().block_num()));
 
+      auto pending = std::make_shared<pending_section>();
+      pending->conn = c;
+      pending->msg = std::move(msg);
+      validating_sections.push_back( pending );
+      validate_section( pending );
+   }
+
+   section_validation_context ibc_plugin_impl::get_section_validation_context( uint32_t first_num ){
+      section_validation_context ctx;
+
+      // the contract's block right before the section, or its newest block if it doesn't have that one
+      auto bhs = chain_contract->get_chaindb_tb_bhs_by_block_num( first_num - 1 );
+      if ( ! bhs.valid() ){
+         auto ls = chain_contract->get_sections_tb_reverse_nth_section();
+         if ( ls.valid() ){
+            bhs = chain_contract->get_chaindb_tb_bhs_by_block_num( ls->last );
+         }
+      }
+      if ( ! bhs.valid() ){
+         return ctx;
+      }
+
+      auto active = chain_contract->get_prodsches_tb_schedule_by_id( bhs->active_schedule_id );
+      auto pending = chain_contract->get_prodsches_tb_schedule_by_id( bhs->pending_schedule_id );
+      if ( active.valid() ){
+         ctx.add_schedule( *active );
+      }
+      if ( pending.valid() ){
+         ctx.add_schedule( *pending );
+         ctx.pending_schedule_hash = digest_type::hash( *pending );
+      }
+      return ctx;
+   }
+
+   void ibc_plugin_impl::validate_section( const pending_section_ptr& pending ){
+      const auto& headers = pending->msg.headers;
+      auto ctx = std::make_shared<section_validation_context>( get_section_validation_context( headers.front().block_num() ) );
+
+      // linkage and digests are cheap and sequential, only the key recovery goes to the thread pool
+      auto digests = std::make_shared<vector<digest_type>>();
+      try {
+         *digests = check_section_headers( pending->msg, *ctx );
+      } catch ( const fc::exception& e ){
+         peer_elog(pending->conn, "invalid lwc section [${f},${t}]: ${e}",("f",headers.front().block_num())("t",headers.back().block_num())("e",e.to_string()));
+         pending->done = true;
+         process_validated_sections();
+         return;
+      }
+
+      uint32_t size = headers.size();
+      uint32_t threads = std::max<uint32_t>( chain_plug->chain().get_config().thread_pool_size, 1 );
+      uint32_t chunk = ( size + threads - 1 ) / threads;
+      auto remaining = std::make_shared<std::atomic<uint32_t>>( ( size + chunk - 1 ) / chunk );
+      auto failed = std::make_shared<std::atomic<bool>>( false );
+
+      for ( uint32_t first = 0; first < size; first += chunk ){
+         uint32_t last = std::min( first + chunk, size );
+         boost::asio::post( chain_plug->chain().get_thread_pool(), [pending, ctx, digests, first, last, remaining, failed](){
+            for ( uint32_t i = first; i < last && ! *failed; ++i ){
+               if ( ! verify_section_header_signee( pending->msg.headers[i], (*digests)[i], *ctx ) ){
+                  *failed = true;
+               }
+            }
+            if ( --*remaining == 0 ){
+               app().get_io_service().post( [pending, failed](){
+                  pending->valid = ! *failed;
+                  pending->done = true;
+                  my_impl->process_validated_sections();
+               });
+            }
+         });
+      }
+   }
+
+   void ibc_plugin_impl::process_validated_sections(){
+      while ( ! validating_sections.empty() && validating_sections.front()->done ){
+         auto pending = validating_sections.front();
+         validating_sections.pop_front();
+
+         const auto& headers = pending->msg.headers;
+         if ( pending->valid ){
+            process_section( pending->conn, pending->msg );
+         } else {
+            peer_elog(pending->conn, "rejected lwc section [${f},${t}]",("f",headers.front().block_num())("t",headers.back().block_num()));
+         }
+      }
+   }
+
+   void ibc_plugin_impl::process_section( connection_ptr c, const lwc_section_data_message &msg ){
       auto p = chain_contract->get_sections_tb_reverse_nth_section();
       if ( !p.valid() ){
          elog("can not get section info from ibc.chain contract");
@@ -2540,6 +2732,16 @@ namespace snax { namespace ibc {
       }
    }
 
+   void ibc_plugin_impl::handle_message( connection_ptr c, lwc_section_delta_message &&msg ) {
+      handle_message( c, decode_section( std::move(msg) ) );
+   }
+
+   void ibc_plugin_impl::handle_message( connection_ptr c, compressed_message &&msg ) {
+      auto inner = decompress_message( msg, max_decompressed_message_size );
+      msgHandler m( *this, c );
+      inner.visit( m );
+   }
+
    void ibc_plugin_impl::handle_message( connection_ptr c, const ibc_trxs_request_message &msg ) {
       peer_ilog(c, "received ibc_trxs_request_message, table ${tb}, id range [${f},${t}]",("tb",msg.table)("f",msg.range.first)("t",msg.range.second));
 
@@ -2588,31 +2790,31 @@ namespace snax { namespace ibc {
       c->enqueue( ret_msg );
    }
 
-   void ibc_plugin_impl::handle_message( connection_ptr c, const ibc_trxs_data_message &msg ) {
+   void ibc_plugin_impl::handle_message( connection_ptr c, ibc_trxs_data_message &&msg ) {
       peer_ilog(c, "received ibc_trxs_data_message, table ${tb}, id range [${f},${t}]", ("tb",msg.table)("f",msg.trxs_rich_info.front().table_id)("t",msg.trxs_rich_info.back().table_id));
 
       if ( msg.table == N(origtrxs) ) {
-         for( const auto& trx_info : msg.trxs_rich_info ){
+         for( auto& trx_info : msg.trxs_rich_info ){
             if ( local_origtrxs.size() == 0 ){
-               local_origtrxs.insert(trx_info);
+               local_origtrxs.insert(std::move(trx_info));
                break;
             }
 
             auto it =  local_origtrxs.find( trx_info.table_id );
             if ( it == local_origtrxs.end() ) { // link
                if ( trx_info.table_id == local_origtrxs.rbegin()->table_id + 1 ){
-                  local_origtrxs.insert(trx_info);
+                  local_origtrxs.insert(std::move(trx_info));
                } else {
                   peer_elog(c,"received unlinkable trxs_rich_info table: origtrxs, table_id: ${tb_id}, trx_id: ${trx_id}",("tb_id",trx_info.table_id)("trx_id",trx_info.trx_id));
-                  local_origtrxs.insert(trx_info); // add it still
+                  local_origtrxs.insert(std::move(trx_info)); // add it still
                }
             } else {
                if ( it->trx_id == trx_info.trx_id ){ // duplicate
                   break;
                } else { // replace
-                  local_origtrxs.erase( it );
-                  local_origtrxs.insert(trx_info);
                   peer_elog(c,"received conflict trxs_rich_info table: origtrxs, table_id: ${tb_id}",("tb_id",trx_info.table_id));
+                  local_origtrxs.erase( it );
+                  local_origtrxs.insert(std::move(trx_info));
                }
             }
          }
@@ -2625,27 +2827,27 @@ namespace snax { namespace ibc {
       }
 
       if ( msg.table == N(cashtrxs) ){
-         for( const auto& trx_info : msg.trxs_rich_info ){
+         for( auto& trx_info : msg.trxs_rich_info ){
             if ( local_cashtrxs.size() == 0 ){
-               local_cashtrxs.insert(trx_info);
+               local_cashtrxs.insert(std::move(trx_info));
                break;
             }
 
             auto it =  local_cashtrxs.find( trx_info.table_id );
             if ( it == local_cashtrxs.end() ) { // link
                if ( trx_info.table_id == local_cashtrxs.rbegin()->table_id + 1 ){
-                  local_cashtrxs.insert(trx_info);
+                  local_cashtrxs.insert(std::move(trx_info));
                } else {
                   peer_elog(c,"received unlinkable trxs_rich_info table: cashtrxs, table_id: ${tb_id}, trx_id: ${trx_id}",("tb_id",trx_info.table_id)("trx_id",trx_info.trx_id));
-                  local_cashtrxs.insert(trx_info); // add it still
+                  local_cashtrxs.insert(std::move(trx_info)); // add it still
                }
             } else {
                if ( it->trx_id == trx_info.trx_id ){
                   break;
                } else { // replace
-                  local_cashtrxs.erase( it );
-                  local_cashtrxs.insert(trx_info);
                   peer_elog(c,"received conflict trxs_rich_info table: cashtrxs, table_id: ${tb_id}",("tb_id",trx_info.table_id));
+                  local_cashtrxs.erase( it );
+                  local_cashtrxs.insert(std::move(trx_info));
                }
             }
          }
@@ -2658,15 +2860,8 @@ namespace snax { namespace ibc {
       }
    }
 
-   incremental_merkle ibc_plugin_impl::get_brtm_from_cache( uint32_t block_num ){
-      if ( blockroot_merkle_cache.begin() != blockroot_merkle_cache.end() &&
-      blockroot_merkle_cache.begin()->block_num <= block_num && block_num <= blockroot_merkle_cache.rbegin()->block_num ){
-         return blockroot_merkle_cache[ block_num - blockroot_merkle_cache.begin()->block_num  ].merkle;
-      }
-
-      incremental_merkle mkl;
-      mkl._node_count = 0;
-      return mkl;
+   optional<incremental_merkle> ibc_plugin_impl::get_blockroot_merkle( uint32_t block_num ){
+      return chain_plug->chain().fetch_blockroot_merkle_by_num( block_num );
    }
 
    uint32_t ibc_plugin_impl::get_safe_head_tslot(){
@@ -2848,60 +3043,52 @@ namespace snax { namespace ibc {
       });
    }
 
-   vector<digest_type>  get_merkle_path( vector<digest_type> ids, uint32_t num ) {
-      if( 0 == ids.size() || num > ids.size() - 1 ) { return vector<digest_type>(); }
-
-      vector<digest_type> result;
-
-      if( ids.size() == 1 ){
-         result.push_back( ids.front() );
-         return result;
+   /**
+    * Transactions merkle tree of a block, built once and kept in a small LRU cache, so that the
+    * proofs of many transactions in the same block don't rehash the whole tree each.
+    */
+   const block_trxs_merkle* ibc_plugin_impl::get_block_trxs_merkle( uint32_t block_num ){
+      auto header = chain_plug->chain().fetch_block_header_by_number( block_num );
+      if ( ! header.valid() ){
+         return nullptr;
       }
 
-      // add the first two elements to merkle path
-      if ( num % 2 == 0 ){ // left side
-         result.push_back(ids[num]);
-         if ( num == ids.size() - 1 ){
-            result.push_back(ids[num]);
-         } else {
-            result.push_back(ids[num+1]);
-         }
-      } else { // right side
-         result.push_back(ids[num-1]);
-         result.push_back(ids[num]);
+      auto& by_id_idx = block_trxs_merkles.get<by_block_id>();
+      auto itr = by_id_idx.find( header->id() );
+      if ( itr != by_id_idx.end() ){
+         block_trxs_merkles.relocate( block_trxs_merkles.begin(), block_trxs_merkles.project<by_lru>( itr ) );
+         return &*itr;
       }
 
-      // append middle path
-      uint32_t idx_in_layer = num;
-      while( ids.size() > 1 ) {
-         if( ids.size() % 2 )
-            ids.push_back(ids.back());
+      block_trxs_merkle bm;
+      bm.block_id = header->id();
+      bm.block = chain_plug->chain().fetch_block_by_number( block_num );
+      if ( bm.block == signed_block_ptr() ){
+         return nullptr;
+      }
 
-         for (int i = 0; i < ids.size() / 2; i++) {
-            ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
-         }
-         ids.resize(ids.size() / 2);
+      std::vector<digest_type> trx_digests;
+      trx_digests.reserve( bm.block->transactions.size() );
+      for ( auto const& trx : bm.block->transactions ){
+         try {
+            bm.trx_index.emplace( trx.trx.get<packed_transaction>().id(), trx_digests.size() );
+         } catch (...) {}
+         trx_digests.push_back( trx.digest() );
+      }
+      bm.tree = merkle_tree( std::move(trx_digests) );
 
-         if ( ids.size() > 1 ){ // not reach root yet
-            idx_in_layer /= 2;
-            if ( idx_in_layer % 2 == 0 ){ // left side
-               if ( idx_in_layer == ids.size() - 1 ){
-                  result.push_back( make_canonical_right(ids[idx_in_layer]) );
-               } else {
-                  result.push_back( make_canonical_right(ids[idx_in_layer+1]) );
-               }
-            } else { // right side
-               result.push_back( make_canonical_left(ids[idx_in_layer-1]) );
-            }
-         }
+      if ( bm.tree.root() != bm.block->transaction_mroot ){
+         elog("internal error, transaction_mroot of block ${n} mismatch", ("n", block_num));
+         return nullptr;
       }
 
-      // append merkle root
-      result.push_back( ids.front() );
-      return result;
+      block_trxs_merkles.push_front( std::move(bm) );
+      while ( block_trxs_merkles.size() > MaxBlockTrxsMerkleCache ){
+         block_trxs_merkles.pop_back();
+      }
+      return &block_trxs_merkles.front();
    }
 
-
    optional<ibc_trx_rich_info> ibc_plugin_impl::get_ibc_trx_rich_info( uint32_t block_time_slot, transaction_id_type trx_id, uint64_t table_id ){
       auto head_num = chain_plug->chain().fork_db_head_block_num(); // .head_block_num(); to do
       auto head_slot = chain_plug->chain().fetch_block_by_number(head_num)->timestamp.slot;
@@ -2916,54 +3103,28 @@ namespace snax { namespace ibc {
       trx_info.trx_id = trx_id;
 
       // get block number from block_time_slot
-      uint32_t check_num = head_num - ( head_slot  - block_time_slot );
-      uint32_t check_slot = chain_plug->chain().fetch_block_by_number(check_num)->timestamp.slot;
-      while ( check_slot < block_time_slot ){
-            check_num += 1;
-            check_slot = chain_plug->chain().fetch_block_by_number(check_num)->timestamp.slot;
-      }
-      if ( check_slot != block_time_slot ){
+      auto block_num = chain_plug->chain().fetch_block_num_by_slot( block_time_slot );
+      if ( ! block_num.valid() ){
          elog( "block of block_time_slot not found" );
          return  optional<ibc_trx_rich_info>();
       }
-      trx_info.block_num = check_num;
+      trx_info.block_num = *block_num;
 
       // get trx merkle path
-      auto blk_ptr =  chain_plug->chain().fetch_block_by_number( trx_info.block_num );
-      std::vector<digest_type>            trx_digests;
-      std::vector<transaction_id_type>    trx_ids;
-      std::vector<char>                   packed_trx_receipt;
-
-      bool found = false;
-      uint32_t found_num = 0;
-      for ( auto const& trx : blk_ptr->transactions ){
-         trx_digests.push_back( trx.digest() );
-
-         transaction_id_type check_trx_id = transaction_id_type();
-         try {
-            check_trx_id = trx.trx.get<packed_transaction>().id();
-         } catch (...) {}
-
-         if ( check_trx_id == trx_id ){
-            found = true;
-            packed_trx_receipt = fc::raw::pack(trx);
-         }
-         if (!found){
-            found_num += 1;
-         }
-      }
-
-      if ( merkle(trx_digests) != blk_ptr->transaction_mroot ){
-         elog("internal error");
+      auto bm = get_block_trxs_merkle( trx_info.block_num );
+      if ( bm == nullptr ){
+         elog("block ${n} not found", ("n", trx_info.block_num));
          return optional<ibc_trx_rich_info>();
       }
 
-      if ( !found ){
+      auto itr = bm->trx_index.find( trx_id );
+      if ( itr == bm->trx_index.end() ){
          elog("trx not found");
          return optional<ibc_trx_rich_info>();
       }
+      std::vector<char> packed_trx_receipt = fc::raw::pack( bm->block->transactions[itr->second] );
 
-      auto mp = get_merkle_path( trx_digests, found_num );
+      auto mp = bm->tree.get_path( itr->second );
       if ( mp.empty() ){
          elog("internal error");
          return optional<ibc_trx_rich_info>();
@@ -3589,6 +3750,12 @@ namespace snax { namespace ibc {
          ( "ibc-connection-cleanup-period", bpo::value<int>()->default_value(def_conn_retry_wait), "Number of seconds to wait before cleaning up dead connections")
          ( "ibc-max-cleanup-time-msec", bpo::value<int>()->default_value(10), "Maximum connection cleanup time per cleanup call in millisec")
          ( "ibc-version-match", bpo::value<bool>()->default_value(false), "True to require exact match of ibc plugin version.")
+         ( "ibc-compression", bpo::value<bool>()->default_value(true),
+           "True to send section data delta encoded and transaction data zlib compressed to peers whose ibc plugin supports it")
+         ( "ibc-push-window", bpo::value<uint32_t>()->default_value(8),
+           "Maximum number of cash, cashconfirm or rollback transactions of a batch waiting for their push result at once, 1 pushes them one by one")
+         ( "ibc-max-actions-per-trx", bpo::value<uint32_t>()->default_value(1),
+           "Maximum number of cash or cashconfirm actions packed into one transaction, the actual number adapts to max_transaction_cpu_usage and max_transaction_net_usage")
 
          ( "ibc-log-format", bpo::value<string>()->default_value( "[\"${_name}\" ${_ip}:${_port}]" ),
            "The string used to format peers when logging messages about them.  Variables are escaped with ${<variable name>}.\n"
@@ -3616,6 +3783,14 @@ namespace snax { namespace ibc {
          peer_log_format = options.at( "ibc-log-format" ).as<string>();
 
          my->network_version_match = options.at( "ibc-version-match" ).as<bool>();
+         my->compression = options.at( "ibc-compression" ).as<bool>();
+
+         my->push_window = options.at( "ibc-push-window" ).as<uint32_t>();
+         SNAX_ASSERT( my->push_window > 0, plugin_config_exception, "ibc-push-window must be positive" );
+
+         my->max_actions_per_trx = options.at( "ibc-max-actions-per-trx" ).as<uint32_t>();
+         SNAX_ASSERT( my->max_actions_per_trx > 0 && my->max_actions_per_trx <= 100, plugin_config_exception,
+                      "ibc-max-actions-per-trx must be in range [1,100]" );
 
          OPTION_ASSERT( "ibc-sidechain-id" )
          my->sidechain_id = fc::sha256( options.at( "ibc-sidechain-id" ).as<string>() );
@@ -3761,6 +3936,7 @@ namespace snax { namespace ibc {
       }
       chain::controller&cc = my->chain_plug->chain();
       cc.irreversible_block.connect( boost::bind(&ibc_plugin_impl::irreversible_block, my.get(), _1));
+      cc.accepted_block.connect( boost::bind(&ibc_plugin_impl::accepted_block, my.get(), _1));
 
       my->start_monitors();
 
@@ -3840,4 +4016,10 @@ namespace snax { namespace ibc {
       return result;
    }
 
+   vector<push_batch_stats> ibc_plugin::push_stats()const {
+      if( my->token_contract )
+         return my->token_contract->push_stats();
+      return vector<push_batch_stats>();
+   }
+
 }}
\ No newline at end of file
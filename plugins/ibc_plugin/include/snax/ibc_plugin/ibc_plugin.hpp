@@ -8,6 +8,7 @@
 #include <snax/chain_plugin/chain_plugin.hpp>
 #include <snax/chain/plugin_interface.hpp>
 #include <snax/ibc_plugin/protocol.hpp>
+#include <snax/ibc_plugin/windowed_trx_pusher.hpp>
 
 namespace snax { namespace ibc {
    using namespace appbase;
@@ -36,6 +37,8 @@ namespace snax { namespace ibc {
         string                       disconnect( const string& endpoint );
         optional<connection_status>  status( const string& endpoint )const;
         vector<connection_status>    connections()const;
+        /// the cash, cashconfirm and rollback batches pushed last, while in flight or finished
+        vector<push_batch_stats>     push_stats()const;
 
         size_t num_peers() const;
       private:
@@ -0,0 +1,202 @@
+/**
+ *  @file
+ *  @copyright defined in bos/LICENSE.txt
+ */
+#pragma once
+#include <snax/chain/contract_table_objects.hpp>
+#include <snax/ibc_plugin/protocol.hpp>
+#include <fc/container/flat.hpp>
+#include <fc/io/raw.hpp>
+#include <functional>
+
+namespace snax {
+   namespace ibc {
+      using namespace chain;
+
+      struct by_tslot;
+
+      /**
+       * In-memory copy of an ibc.token table, like origtrxs and cashtrxs, as of the head block. It is loaded
+       * from the table's key_value_objects on the first read; after that every accepted block applies the rows
+       * its undo state records as added, modified or removed, the same deltas state_history_plugin logs, so
+       * keeping it current costs the rows a block changed rather than a walk of the table. When the undo state
+       * of an accepted block does not follow the copy, as after a fork switch, it is loaded again on the next
+       * read.
+       *
+       * `head_block_num` returns the number of the block the state of `db` is at, not counting a pending block.
+       */
+      template<typename Row, uint64_t Row::*Key>
+      class ibc_table_mirror {
+      public:
+         typedef boost::multi_index_container<
+               Row,
+               indexed_by<
+                     ordered_unique<
+                           tag< by_id >,
+                           member< Row, uint64_t, Key > >,
+                     ordered_non_unique<
+                           tag< by_tslot >,
+                           member< Row, uint64_t, &Row::block_time_slot > >
+               >
+         > index_type;
+
+         using head_block_num_func = std::function<uint32_t()>;
+
+         ibc_table_mirror( const chainbase::database& db, head_block_num_func head_block_num, name code, name table )
+         :db(db),head_block_num(head_block_num),code(code),table(table){}
+
+         void on_accepted_block(){
+            if ( stale ){
+               return;
+            }
+            const auto& kv_index = db.get_index<chain::key_value_index>();
+            if ( kv_index.stack().empty() || kv_index.stack().back().revision != revision + 1 ){
+               stale = true;
+               return;
+            }
+
+            const auto& undo = kv_index.stack().back();
+            auto tids = table_ids();
+            for ( const auto& old : undo.removed_values ){
+               if ( tids.count( old.second.t_id ) ){
+                  _rows.erase( old.second.primary_key );
+               }
+            }
+            for ( const auto& old : undo.old_values ){
+               if ( tids.count( old.second.t_id ) ){
+                  _rows.erase( old.second.primary_key );
+               }
+               store( kv_index.get( old.first ), tids );
+            }
+            for ( auto id : undo.new_ids ){
+               store( kv_index.get( id ), tids );
+            }
+            revision = undo.revision;
+         }
+
+         const index_type& rows(){
+            if ( stale ){
+               sync();
+            }
+            return _rows;
+         }
+
+         optional<Row> find( uint64_t key ){
+            const auto& idx = rows();
+            auto it = idx.find( key );
+            if ( it != idx.end() ){
+               return *it;
+            }
+            return optional<Row>();
+         }
+
+         range_type key_range(){
+            const auto& idx = rows();
+            if ( idx.empty() ){
+               return range_type();
+            }
+            return std::make_pair( (*idx.begin()).*Key, (*idx.rbegin()).*Key );
+         }
+
+         /// the row with the lowest key among those stored at the first time slot not before `tslot`
+         optional<Row> first_row_from_tslot( uint64_t tslot ){
+            const auto& idx = rows().template get<by_tslot>();
+            auto it = idx.lower_bound( tslot );
+            if ( it == idx.end() ){
+               return optional<Row>();
+            }
+            auto first = it;
+            for ( auto end = idx.upper_bound( first->block_time_slot ); it != end; ++it ){
+               if ( (*it).*Key < (*first).*Key ){
+                  first = it;
+               }
+            }
+            return *first;
+         }
+
+      private:
+         void sync(){
+            stale = false;
+            _rows.clear();
+            revision = head_block_num();
+
+            auto tids = table_ids();
+            const auto* t_id = db.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(code, code, table));
+            if ( t_id != nullptr ){
+               const auto& idx = db.get_index<chain::key_value_index, chain::by_scope_primary>();
+               decltype(t_id->id) next_tid(t_id->id._id + 1);
+               auto lower = idx.lower_bound(boost::make_tuple(t_id->id));
+               auto upper = idx.lower_bound(boost::make_tuple(next_tid));
+               for ( auto itr = lower; itr != upper; ++itr ){
+                  store( *itr, tids );
+               }
+            }
+
+            if ( db.revision() == revision ){
+               return;
+            }
+            // the table as read includes what the pending block changed so far, take that out again
+            const auto& kv_index = db.get_index<chain::key_value_index>();
+            if ( db.revision() != revision + 1 || kv_index.stack().empty() || kv_index.stack().back().revision != db.revision() ){
+               revision = -1;   // can't tell, reload after the next block
+               return;
+            }
+            const auto& undo = kv_index.stack().back();
+            for ( auto id : undo.new_ids ){
+               const auto& obj = kv_index.get( id );
+               if ( tids.count( obj.t_id ) ){
+                  _rows.erase( obj.primary_key );
+               }
+            }
+            for ( const auto& old : undo.old_values ){
+               const auto& obj = kv_index.get( old.first );
+               if ( tids.count( obj.t_id ) ){
+                  _rows.erase( obj.primary_key );
+               }
+               store( old.second, tids );
+            }
+            for ( const auto& old : undo.removed_values ){
+               store( old.second, tids );
+            }
+         }
+
+         /// the ids the table had in the state and in the latest undo state, a table is removed along with its last row
+         flat_set<chain::table_id> table_ids()const {
+            flat_set<chain::table_id> ids;
+            const auto* t_id = db.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(code, code, table));
+            if ( t_id != nullptr ){
+               ids.insert( t_id->id );
+            }
+            const auto& t_index = db.get_index<chain::table_id_multi_index>();
+            if ( !t_index.stack().empty() ){
+               for ( const auto& rem : t_index.stack().back().removed_values ){
+                  if ( rem.second.code == code && rem.second.scope == code && rem.second.table == table ){
+                     ids.insert( rem.second.id );
+                  }
+               }
+            }
+            return ids;
+         }
+
+         void store( const chain::key_value_object& obj, const flat_set<chain::table_id>& tids ){
+            if ( !tids.count( obj.t_id ) ){
+               return;
+            }
+            fc::datastream<const char *> ds(obj.value.data(), obj.value.size());
+            Row row;
+            fc::raw::unpack( ds, row );
+            _rows.erase( obj.primary_key );
+            _rows.insert( row );
+         }
+
+         const chainbase::database&    db;
+         head_block_num_func           head_block_num;
+         name                          code;
+         name                          table;
+         bool                          stale = true;
+         int64_t                       revision = -1;   ///< of the block the copy is at
+         index_type                    _rows;
+      };
+
+   }
+}
@@ -0,0 +1,91 @@
+/**
+ *  @file
+ *  @copyright defined in bos/LICENSE.txt
+ */
+#pragma once
+#include <snax/ibc_plugin/protocol.hpp>
+#include <fc/network/message_buffer.hpp>
+#include <fc/io/raw.hpp>
+#include <memory>
+
+namespace snax {
+   namespace ibc {
+
+      /**
+       * Hands out the buffers outgoing messages are serialized into and takes them back once the last
+       * reference to a buffer is gone, so a connection doesn't allocate a new vector per message. Buffers
+       * that grew beyond max_buffer_size or don't fit into the free list are released instead.
+       * Not thread safe, connections only use it on the application thread.
+       */
+      class send_buffer_pool {
+      public:
+         using buffer_ptr = std::shared_ptr<std::vector<char>>;
+
+         explicit send_buffer_pool( size_t max_free = 64, size_t max_buffer_size = 1024*1024 )
+         :my( std::make_shared<state>() ) {
+            my->max_free = max_free;
+            my->max_buffer_size = max_buffer_size;
+         }
+
+         buffer_ptr get( size_t size ) {
+            std::unique_ptr<std::vector<char>> buff;
+            if( my->free.empty() ) {
+               buff.reset( new std::vector<char>() );
+               ++my->allocations;
+            } else {
+               buff = std::move( my->free.back() );
+               my->free.pop_back();
+               ++my->reuses;
+            }
+            buff->resize( size );
+
+            std::weak_ptr<state> weak_state = my;
+            return buffer_ptr( buff.release(), [weak_state]( std::vector<char>* b ) {
+               auto s = weak_state.lock();
+               if( s && s->free.size() < s->max_free && b->capacity() <= s->max_buffer_size ) {
+                  s->free.emplace_back( b );
+               } else {
+                  delete b;
+               }
+            });
+         }
+
+         size_t   free_count()const  { return my->free.size(); }
+         uint64_t allocations()const { return my->allocations; }
+         uint64_t reuses()const      { return my->reuses; }
+
+      private:
+         struct state {
+            std::vector<std::unique_ptr<std::vector<char>>> free;
+            size_t   max_free = 0;
+            size_t   max_buffer_size = 0;
+            uint64_t allocations = 0;
+            uint64_t reuses = 0;
+         };
+
+         std::shared_ptr<state> my;   ///< outstanding buffers only hold a weak reference, the pool may go first
+      };
+
+      /**
+       * Decode the `message_length` bytes at the read pointer of `buffer` into `msg` and consume them.
+       * A message that lies within one chunk of the buffer is unpacked straight from that memory rather
+       * than byte range by byte range through mb_datastream; one that straddles chunks is first read into
+       * `scratch`, which keeps its capacity for the next one.
+       */
+      template<uint32_t buffer_len>
+      void decode_message( fc::message_buffer<buffer_len>& buffer, uint32_t message_length, std::vector<char>& scratch, ibc_message& msg ) {
+         auto index = buffer.read_index();
+         if( index.second + message_length <= buffer_len ) {
+            fc::datastream<const char*> ds( buffer.read_ptr(), message_length );
+            fc::raw::unpack( ds, msg );
+            buffer.advance_read_ptr( message_length );
+         } else {
+            scratch.resize( message_length );
+            buffer.read( scratch.data(), message_length );
+            fc::datastream<const char*> ds( scratch.data(), message_length );
+            fc::raw::unpack( ds, msg );
+         }
+      }
+
+   } // namespace ibc
+} // namespace snax
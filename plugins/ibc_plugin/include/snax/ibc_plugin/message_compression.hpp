@@ -0,0 +1,143 @@
+/**
+ *  @file
+ *  @copyright defined in bos/LICENSE.txt
+ */
+#pragma once
+#include <snax/ibc_plugin/protocol.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+namespace snax {
+   namespace ibc {
+
+      /// a compressed message may not unpack to more than the largest message ibc_plugin reads off the wire
+      constexpr size_t max_decompressed_message_size = 1024*1024*4*2;
+
+      /**
+       * Delta encode the headers of a section, returns nothing if they don't form a chain the encoding
+       * can express, such a section is sent as it is.
+       */
+      inline optional<lwc_section_delta_message> encode_section( const lwc_section_data_message& msg ) {
+         if( msg.headers.empty() )
+            return optional<lwc_section_delta_message>();
+
+         lwc_section_delta_message result;
+         result.first = msg.headers.front();
+         result.blockroot_merkle = msg.blockroot_merkle;
+         result.deltas.reserve( msg.headers.size() - 1 );
+
+         for( size_t i = 1; i < msg.headers.size(); ++i ) {
+            const auto& prev = msg.headers[i - 1];
+            const auto& h = msg.headers[i];
+            if( h.previous != prev.id() || h.timestamp.slot < prev.timestamp.slot || h.schedule_version < prev.schedule_version )
+               return optional<lwc_section_delta_message>();
+
+            block_header_delta d;
+            d.timestamp_delta = h.timestamp.slot - prev.timestamp.slot;
+            if( h.producer != prev.producer )
+               d.producer = h.producer;
+            d.confirmed = h.confirmed;
+            d.transaction_mroot = h.transaction_mroot;
+            d.action_mroot = h.action_mroot;
+            d.schedule_version_delta = h.schedule_version - prev.schedule_version;
+            d.new_producers = h.new_producers;
+            d.header_extensions = h.header_extensions;
+            d.producer_signature = h.producer_signature;
+            result.deltas.push_back( std::move(d) );
+         }
+         return result;
+      }
+
+      inline lwc_section_data_message decode_section( lwc_section_delta_message&& msg ) {
+         lwc_section_data_message result;
+         result.blockroot_merkle = std::move( msg.blockroot_merkle );
+         result.headers.reserve( msg.deltas.size() + 1 );
+         result.headers.push_back( std::move( msg.first ) );
+
+         for( auto& d : msg.deltas ) {
+            const auto& prev = result.headers.back();
+            signed_block_header h;
+            h.timestamp = block_timestamp_type( prev.timestamp.slot + d.timestamp_delta.value );
+            h.producer = d.producer.valid() ? *d.producer : prev.producer;
+            h.confirmed = d.confirmed;
+            h.previous = prev.id();
+            h.transaction_mroot = d.transaction_mroot;
+            h.action_mroot = d.action_mroot;
+            h.schedule_version = prev.schedule_version + d.schedule_version_delta.value;
+            h.new_producers = std::move( d.new_producers );
+            h.header_extensions = std::move( d.header_extensions );
+            h.producer_signature = d.producer_signature;
+            result.headers.push_back( std::move(h) );
+         }
+         return result;
+      }
+
+      namespace detail {
+         namespace bio = boost::iostreams;
+
+         // zip bomb protection, same as read_limiter for compressed transactions
+         struct decompress_limiter {
+            using char_type = char;
+            using category = bio::multichar_output_filter_tag;
+
+            explicit decompress_limiter( size_t limit ):limit(limit){}
+
+            template<typename Sink>
+            size_t write( Sink& sink, const char* s, size_t count ) {
+               FC_ASSERT( total + count <= limit, "compressed ibc message exceeds ${l} bytes", ("l", limit) );
+               total += count;
+               return bio::write( sink, s, count );
+            }
+
+            size_t limit;
+            size_t total = 0;
+         };
+      }
+
+      /**
+       * zlib compress a message, returns nothing if it is smaller than `min_size` packed or doesn't shrink
+       */
+      inline optional<compressed_message> compress_message( const ibc_message& msg, size_t min_size ) {
+         auto in = fc::raw::pack( msg );
+         if( in.size() < min_size )
+            return optional<compressed_message>();
+
+         compressed_message result;
+         detail::bio::filtering_ostream comp;
+         comp.push( detail::bio::zlib_compressor( detail::bio::zlib::default_compression ) );
+         comp.push( detail::bio::back_inserter( result.data ) );
+         detail::bio::write( comp, in.data(), in.size() );
+         detail::bio::close( comp );
+
+         if( result.data.size() >= in.size() )
+            return optional<compressed_message>();
+         return result;
+      }
+
+      inline ibc_message decompress_message( const compressed_message& msg, size_t max_size ) {
+         std::vector<char> out;
+         try {
+            detail::bio::filtering_ostream decomp;
+            decomp.push( detail::bio::zlib_decompressor() );
+            decomp.push( detail::decompress_limiter( max_size ) );
+            decomp.push( detail::bio::back_inserter( out ) );
+            detail::bio::write( decomp, msg.data.data(), msg.data.size() );
+            detail::bio::close( decomp );
+         } catch( fc::exception& ) {
+            throw;
+         } catch( ... ) {
+            fc::unhandled_exception er( FC_LOG_MESSAGE( warn, "internal decompression error" ), std::current_exception() );
+            throw er;
+         }
+
+         auto result = fc::raw::unpack<ibc_message>( out );
+         FC_ASSERT( ! result.contains<compressed_message>(), "nested compressed ibc message" );
+         return result;
+      }
+
+   } // namespace ibc
+} // namespace snax
@@ -184,6 +184,38 @@ namespace snax {
          std::vector<ibc_trx_rich_info> trxs_rich_info;
       };
 
+      /**
+       * A header of a section encoded against the header before it. previous is that header's id,
+       * timestamp and schedule_version are sent as increments and producer only when it changes.
+       */
+      struct block_header_delta {
+         unsigned_int                        timestamp_delta;
+         optional<account_name>              producer;
+         uint16_t                            confirmed = 1;
+         checksum256_type                    transaction_mroot;
+         checksum256_type                    action_mroot;
+         unsigned_int                        schedule_version_delta;
+         optional<producer_schedule_type>    new_producers;
+         extensions_type                     header_extensions;
+         signature_type                      producer_signature;
+      };
+
+      /**
+       * lwc_section_data_message as sent to peers which support compression, see message_compression.hpp
+       */
+      struct lwc_section_delta_message {
+         signed_block_header                 first;
+         std::vector<block_header_delta>     deltas;
+         incremental_merkle                  blockroot_merkle;
+      };
+
+      /**
+       * a zlib compressed packed ibc_message, sent to peers which support compression
+       */
+      struct compressed_message {
+         std::vector<char>    data;
+      };
+
       using ibc_message = static_variant< handshake_message,
                                           go_away_message,
                                           time_message,
@@ -192,7 +224,9 @@ namespace snax {
                                           lwc_section_request_message,
                                           lwc_section_data_message,
                                           ibc_trxs_request_message,
-                                          ibc_trxs_data_message >;
+                                          ibc_trxs_data_message,
+                                          lwc_section_delta_message,
+                                          compressed_message >;
 
    } // namespace ibc
 } // namespace snax
@@ -215,5 +249,9 @@ FC_REFLECT( snax::ibc::lwc_section_data_message, (headers)(blockroot_merkle) )
 FC_REFLECT( snax::ibc::ibc_trx_rich_info, (table_id)(block_num)(trx_id)(packed_trx_receipt)(merkle_path) )
 FC_REFLECT( snax::ibc::ibc_trxs_request_message, (table)(range) )
 FC_REFLECT( snax::ibc::ibc_trxs_data_message, (table)(trxs_rich_info) )
+FC_REFLECT( snax::ibc::block_header_delta, (timestamp_delta)(producer)(confirmed)(transaction_mroot)(action_mroot)
+            (schedule_version_delta)(new_producers)(header_extensions)(producer_signature) )
+FC_REFLECT( snax::ibc::lwc_section_delta_message, (first)(deltas)(blockroot_merkle) )
+FC_REFLECT( snax::ibc::compressed_message, (data) )
 
 
@@ -0,0 +1,264 @@
+/**
+ *  @file
+ *  @copyright defined in bos/LICENSE.txt
+ */
+#pragma once
+#include <snax/chain/transaction.hpp>
+#include <snax/chain/chain_config.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+#include <fc/time.hpp>
+#include <fc/variant_object.hpp>
+#include <functional>
+#include <memory>
+
+namespace snax {
+   namespace ibc {
+      using namespace chain;
+
+      /// what a windowed_trx_pusher did so far, final once `finished` is set
+      struct push_batch_stats {
+         string      batch_name;
+         uint32_t    items = 0;
+         uint32_t    succeeded = 0;
+         uint32_t    failed = 0;
+         uint32_t    transactions = 0;
+         uint32_t    rewinds = 0;
+         uint32_t    in_flight = 0;
+         uint32_t    max_in_flight = 0;
+         uint32_t    pack_size = 0;        ///< items per transaction the next one is built with
+         uint64_t    avg_latency_us = 0;   ///< from pushing a transaction to its result
+         uint64_t    max_latency_us = 0;
+         uint64_t    duration_us = 0;
+         bool        finished = false;
+      };
+
+      /**
+       * Pushes an ordered batch of items keeping up to `window` transactions in flight, instead of waiting
+       * for each result before building the next one. Transactions reach the producer in batch order, so
+       * seq_num ordering is kept.
+       *
+       * Up to `max_pack` consecutive items are packed into one transaction, each item taking its own
+       * seq_num. The pack size grows at most twofold per success, limited by the cpu and net usage
+       * measured per item so that a transaction stays within half of max_transaction_cpu_usage and
+       * max_transaction_net_usage. A failed pack of more than one item is retried in halves, as one bad
+       * item makes the whole transaction fail.
+       *
+       * `build( first, count, seq_num )` returns the signed transaction of items [first, first + count)
+       * carrying seq_nums from `seq_num` on. When a single item fails the batch either skips it, stops,
+       * or rewinds: the transactions already in flight carry seq_nums that can't be accepted any more,
+       * so once they have drained the items after the failed one are rebuilt starting from its seq_num.
+       *
+       * `push` hands a transaction to the chain and calls its callback with the error, or with the
+       * processed trace; the callback may run before `push` returns.
+       */
+      class windowed_trx_pusher : public std::enable_shared_from_this<windowed_trx_pusher> {
+      public:
+         enum failure_mode {
+            skip_failed,
+            stop_on_failure,
+            rewind_on_failure
+         };
+
+         using result_func = std::function<void( const fc::exception_ptr& error, const fc::variant& processed )>;
+         using push_func   = std::function<void( const signed_transaction& trx, result_func next )>;
+         using config_func = std::function<chain_config()>;
+         using build_func  = std::function<optional<signed_transaction>( uint32_t first, uint32_t count, uint64_t seq_num )>;
+         using done_func   = std::function<void( uint32_t first, uint32_t count, bool succeeded )>;
+
+         windowed_trx_pusher( const string& batch_name, uint32_t count, uint64_t start_seq_num, uint32_t window, uint32_t max_pack,
+                              failure_mode mode, push_func push, config_func config, build_func build, done_func done = done_func() )
+         :batch_name(batch_name),count(count),window(std::max( window, 1u )),max_pack(std::max( max_pack, 1u )),
+          mode(mode),push(push),config(config),build(build),done(done),next_seq_num(start_seq_num),pack_size(this->max_pack){}
+
+         void start(){ fill_window(); }
+         bool finished()const { return is_finished; }
+
+         push_batch_stats stats()const {
+            push_batch_stats s;
+            s.batch_name = batch_name;
+            s.items = count;
+            s.succeeded = succeeded;
+            s.failed = failed;
+            s.transactions = transactions;
+            s.rewinds = rewinds;
+            s.in_flight = in_flight;
+            s.max_in_flight = max_in_flight;
+            s.pack_size = pack_size;
+            s.avg_latency_us = results ? total_latency.count() / results : 0;
+            s.max_latency_us = max_latency.count();
+            s.duration_us = ( ( is_finished ? end_time : fc::time_point::now() ) - start_time ).count();
+            s.finished = is_finished;
+            return s;
+         }
+
+      private:
+         void fill_window();
+         void on_result( uint32_t first, uint32_t n, uint64_t seq_num, uint32_t gen, fc::time_point sent,
+                         const transaction_id_type& id, const fc::exception_ptr& error, const fc::variant& processed );
+         void update_pack_size( uint32_t n, const fc::variant& processed );
+         void rewind( uint32_t first, uint64_t seq_num );
+         void finish();
+
+         string               batch_name;
+         uint32_t             count;
+         uint32_t             window;
+         uint32_t             max_pack;
+         failure_mode         mode;
+         push_func            push;
+         config_func          config;
+         build_func           build;
+         done_func            done;
+
+         uint32_t             next_index = 0;
+         uint64_t             next_seq_num = 0;
+         uint32_t             pack_size;
+         uint32_t             generation = 0;      ///< bumped on every rewind, results of older generations are stale
+         uint32_t             in_flight = 0;
+         bool                 draining = false;    ///< a rewind waits for older transactions to come back
+         bool                 pushing = false;     ///< push may call back before it returns
+         bool                 stopped = false;
+         bool                 is_finished = false;
+
+         // metrics
+         uint32_t             succeeded = 0;
+         uint32_t             failed = 0;
+         uint32_t             transactions = 0;
+         uint32_t             results = 0;
+         uint32_t             rewinds = 0;
+         uint32_t             max_in_flight = 0;
+         fc::microseconds     total_latency;
+         fc::microseconds     max_latency;
+         fc::time_point       start_time = fc::time_point::now();
+         fc::time_point       end_time;
+      };
+
+      inline void windowed_trx_pusher::fill_window(){
+         if ( pushing ){
+            return;  // called back synchronously, the loop below goes on
+         }
+         pushing = true;
+         while ( ! stopped && ! draining && next_index < count && in_flight < window ){
+            uint32_t first = next_index;
+            uint32_t n = std::min( pack_size, count - first );
+            uint64_t seq_num = next_seq_num;
+            next_index += n;
+            next_seq_num += n;
+
+            auto trx_opt = build( first, n, seq_num );
+            if ( ! trx_opt.valid() ){
+               elog("${n}: failed to build transaction of items [${f},${l}]", ("n",batch_name)("f",first)("l",first + n - 1));
+               stopped = true;
+               break;
+            }
+
+            ++in_flight;
+            ++transactions;
+            max_in_flight = std::max( max_in_flight, in_flight );
+            auto self = shared_from_this();
+            auto gen = generation;
+            auto sent = fc::time_point::now();
+            auto id = trx_opt->id();
+            push( *trx_opt, [self, first, n, seq_num, gen, sent, id]( const fc::exception_ptr& error, const fc::variant& processed ){
+               self->on_result( first, n, seq_num, gen, sent, id, error, processed );
+            });
+         }
+         pushing = false;
+
+         if ( in_flight == 0 && ( stopped || next_index >= count ) ){
+            finish();
+         }
+      }
+
+      inline void windowed_trx_pusher::rewind( uint32_t first, uint64_t seq_num ){
+         ++generation;
+         ++rewinds;
+         next_index = first;
+         next_seq_num = seq_num;
+         draining = in_flight > 0;
+      }
+
+      inline void windowed_trx_pusher::update_pack_size( uint32_t n, const fc::variant& processed ){
+         if ( max_pack == 1 ){
+            return;
+         }
+         try {
+            const auto& receipt = processed.get_object()["receipt"].get_object();
+            uint64_t cpu_per_item = std::max<uint64_t>( receipt["cpu_usage_us"].as_uint64() / n, 1 );
+            uint64_t net_per_item = std::max<uint64_t>( receipt["net_usage_words"].as_uint64() * 8 / n, 1 );
+
+            const auto cfg = config();
+            uint64_t fit = std::min( cfg.max_transaction_cpu_usage / 2 / cpu_per_item, cfg.max_transaction_net_usage / 2 / net_per_item );
+            pack_size = std::max<uint32_t>( std::min<uint64_t>( std::min<uint64_t>( fit, max_pack ), uint64_t(pack_size) * 2 ), 1 );
+         } FC_LOG_AND_DROP()
+      }
+
+      inline void windowed_trx_pusher::on_result( uint32_t first, uint32_t n, uint64_t seq_num, uint32_t gen, fc::time_point sent,
+                                                  const transaction_id_type& id, const fc::exception_ptr& error, const fc::variant& processed ){
+         --in_flight;
+         ++results;
+         auto latency = fc::time_point::now() - sent;
+         total_latency += latency;
+         max_latency = std::max( max_latency, latency );
+
+         bool stale = gen != generation;
+         if ( error ){
+            if ( stale ){
+               dlog("${n}: transaction of items [${f},${l}] pushed before the rewind failed", ("n",batch_name)("f",first)("l",first + n - 1));
+            } else if ( n > 1 ){
+               // don't know which item failed, retry them in smaller packs
+               wlog("${n}: transaction of items [${f},${l}] failed, retry with ${p} items per transaction",
+                    ("n",batch_name)("f",first)("l",first + n - 1)("p",n / 2));
+               pack_size = n / 2;
+               rewind( first, seq_num );
+            } else {
+               try {
+                  error->dynamic_rethrow_exception();
+               } FC_LOG_AND_DROP()
+               elog("${n}: push transaction failed, item ${i} seq_num ${s}", ("n",batch_name)("i",first)("s",seq_num));
+               ++failed;
+               if ( done ) done( first, 1, false );
+
+               if ( mode == stop_on_failure ){
+                  stopped = true;
+               } else if ( mode == rewind_on_failure ){
+                  rewind( first + 1, seq_num );
+               }
+            }
+         } else {
+            if ( stale ){
+               // can't happen while the contract checks seq_num, don't guess and let the next round resync
+               wlog("${n}: transaction ${id} of items [${f},${l}] pushed before the rewind succeeded, stop this batch",
+                    ("n",batch_name)("id",id)("f",first)("l",first + n - 1));
+               stopped = true;
+            } else {
+               dlog("${n}: pushed transaction ${id}, items [${f},${l}]", ("n",batch_name)("id",id)("f",first)("l",first + n - 1));
+               succeeded += n;
+               update_pack_size( n, processed );
+               if ( done ) done( first, n, true );
+            }
+         }
+
+         if ( draining && in_flight == 0 ){
+            draining = false;
+         }
+         fill_window();
+      }
+
+      inline void windowed_trx_pusher::finish(){
+         if ( is_finished ){
+            return;
+         }
+         is_finished = true;
+         end_time = fc::time_point::now();
+         auto s = stats();
+         ilog("${n}: ${s} of ${c} items succeeded in ${t} transactions, ${f} failed, ${r} rewinds, max in flight ${m}, latency avg ${a}us max ${x}us, took ${d}ms",
+              ("n",batch_name)("s",s.succeeded)("c",s.items)("t",s.transactions)("f",s.failed)("r",s.rewinds)("m",s.max_in_flight)
+              ("a",s.avg_latency_us)("x",s.max_latency_us)("d",s.duration_us / 1000));
+      }
+
+   }
+}
+
+FC_REFLECT( snax::ibc::push_batch_stats, (batch_name)(items)(succeeded)(failed)(transactions)(rewinds)(in_flight)(max_in_flight)
+                                          (pack_size)(avg_latency_us)(max_latency_us)(duration_us)(finished) )
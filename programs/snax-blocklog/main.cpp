@@ -27,6 +27,7 @@ struct blocklog {
    {}
 
    void read_log();
+   void list_segments();
    void set_program_options(options_description& cli);
    void initialize(const variables_map& options);
 
@@ -36,6 +37,7 @@ struct blocklog {
    uint32_t                         last_block;
    bool                             no_pretty_print;
    bool                             as_json_array;
+   bool                             segments;
 };
 
 void blocklog::read_log() {
@@ -44,7 +46,7 @@ void blocklog::read_log() {
    SNAX_ASSERT( end, block_log_exception, "No blocks found in block log" );
    SNAX_ASSERT( end->block_num() > 1, block_log_exception, "Only one block found in block log" );
 
-   ilog( "existing block log contains block num 1 through block num ${n}", ("n",end->block_num()) );
+   ilog( "existing block log contains block num ${f} through block num ${n}", ("f",block_logger.first_block_num())("n",end->block_num()) );
 
    optional<chainbase::database> reversible_blocks;
    try {
@@ -85,7 +87,7 @@ void blocklog::read_log() {
 
    if (as_json_array)
       *out << "[";
-   uint32_t block_num = (first_block < 1) ? 1 : first_block;
+   uint32_t block_num = std::max( first_block, block_logger.first_block_num() );
    signed_block_ptr next;
    fc::variant pretty_output;
    const fc::microseconds deadline = fc::seconds(10);
@@ -130,6 +132,20 @@ void blocklog::read_log() {
       *out << "]";
 }
 
+void blocklog::list_segments() {
+   block_log block_logger(blocks_dir);
+   const auto ranges = block_logger.segment_ranges();
+   for( const auto& range : ranges )
+      std::cout << "segment    " << range.first << " - " << range.second << "\n";
+
+   const auto end = block_logger.read_head();
+   uint32_t active_first = ranges.empty() ? block_logger.first_block_num() : ranges.back().second + 1;
+   if( end && end->block_num() >= active_first )
+      std::cout << "blocks.log " << active_first << " - " << end->block_num() << "\n";
+   else
+      std::cout << "blocks.log empty\n";
+}
+
 void blocklog::set_program_options(options_description& cli)
 {
    cli.add_options()
@@ -145,6 +161,8 @@ void blocklog::set_program_options(options_description& cli)
           "Do not pretty print the output.  Useful if piping to jq to improve performance.")
          ("as-json-array", bpo::bool_switch(&as_json_array)->default_value(false),
           "Print out json blocks wrapped in json array (otherwise the output is free-standing json objects).")
+         ("segments", bpo::bool_switch(&segments)->default_value(false),
+          "Print the block ranges of the completed segments of a segmented block log and of blocks.log instead of the blocks.")
          ("help", "Print this help message and exit.")
          ;
 
@@ -185,7 +203,10 @@ int main(int argc, char** argv)
         return 0;
       }
       blog.initialize(vmap);
-      blog.read_log();
+      if (blog.segments)
+         blog.list_segments();
+      else
+         blog.read_log();
    } catch( const fc::exception& e ) {
       elog( "${e}", ("e", e.to_detail_string()));
       return -1;
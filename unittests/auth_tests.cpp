@@ -518,5 +518,26 @@ BOOST_AUTO_TEST_CASE( linkauth_special ) { try {
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( authority_cache_undo ) { try {
+   TESTER chain;
+   chain.create_accounts( {N(alice)} );
+   chain.produce_block();
+
+   const auto& authorization = chain.control->get_authorization_manager();
+   const auto old_key = chain.get_public_key( N(alice), "active" );
+   const auto new_key = chain.get_public_key( N(alice), "new_active" );
+   authorization.check_authorization( N(alice), config::active_name, {old_key} );
+
+   chain.set_authority( N(alice), config::active_name, authority(new_key), config::owner_name );
+   BOOST_REQUIRE_THROW( authorization.check_authorization( N(alice), config::active_name, {old_key} ), unsatisfied_authorization );
+   authorization.check_authorization( N(alice), config::active_name, {new_key} );
+
+   // aborting the pending block undoes the change, the cached authority must not survive it
+   chain.control->abort_block();
+   BOOST_REQUIRE_THROW( authorization.check_authorization( N(alice), config::active_name, {new_key} ), unsatisfied_authorization );
+   authorization.check_authorization( N(alice), config::active_name, {old_key} );
+
+} FC_LOG_AND_RETHROW() }
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/chain/block_log.hpp>
+#include <snax/chain/block_log_reader.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <thread>
+
+using namespace snax;
+using namespace chain;
+
+namespace {
+   signed_block_ptr make_block( const block_id_type& previous ) {
+      auto b = std::make_shared<signed_block>();
+      b->previous = previous;
+      b->timestamp = block_timestamp_type( block_header::num_from_id( previous ) + 1 );
+      b->transaction_mroot = digest_type::hash( b->timestamp.slot );
+      return b;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(block_log_reader_tests)
+
+BOOST_AUTO_TEST_CASE(read_back_test) {
+   fc::temp_directory tempdir;
+   const uint32_t last = 100;
+
+   std::vector<block_id_type> ids;
+   {
+      block_log log( tempdir.path() );
+      auto reader = log.get_reader();
+      BOOST_CHECK_EQUAL( reader->head_block_num(), 0u );
+      BOOST_CHECK( !reader->read_block_by_num( 1 ) );
+
+      auto b = make_block( block_id_type() );
+      log.reset( genesis_state(), b );
+      ids.push_back( b->id() );
+      for( uint32_t n = 2; n <= last; ++n ) {
+         b = make_block( ids.back() );
+         log.append( b );
+         ids.push_back( b->id() );
+
+         // every block is visible as soon as it is appended
+         BOOST_REQUIRE_EQUAL( reader->head_block_num(), n );
+         BOOST_REQUIRE( reader->read_block_by_num( n )->id() == b->id() );
+      }
+      BOOST_CHECK_EQUAL( reader->first_block_num(), 1u );
+      BOOST_CHECK( !reader->read_block_by_num( last + 1 ) );
+   }
+
+   // reopen, the reader picks up the existing log
+   block_log log( tempdir.path() );
+   auto reader = log.get_reader();
+   BOOST_REQUIRE_EQUAL( reader->head_block_num(), last );
+   for( uint32_t n = 1; n <= last; ++n ) {
+      BOOST_CHECK( reader->read_block_by_num( n )->id() == ids[n - 1] );
+      BOOST_CHECK( reader->read_block_header_by_num( n )->id() == ids[n - 1] );
+      BOOST_CHECK_EQUAL( reader->get_block_pos( n ), log.get_block_pos( n ) );
+   }
+   BOOST_CHECK( !reader->read_block_header_by_num( 0 ).valid() );
+   BOOST_CHECK_EQUAL( reader->get_block_pos( last + 1 ), block_log::npos );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_read_test) {
+   fc::temp_directory tempdir;
+   const uint32_t last = 2000;
+
+   block_log log( tempdir.path() );
+   auto b = make_block( block_id_type() );
+   log.reset( genesis_state(), b );
+   auto reader = log.get_reader();
+
+   std::atomic<bool> done( false );
+   std::atomic<uint32_t> failures( 0 );
+   std::vector<std::thread> threads;
+   for( uint32_t t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&, t]() {
+         uint32_t n = 1;
+         while( !done.load() ) {
+            auto head = reader->head_block_num();
+            n = (n + 7 * (t + 1)) % head + 1;
+            auto blk = reader->read_block_by_num( n );
+            if( !blk || blk->block_num() != n || blk->transaction_mroot != digest_type::hash( n ) )
+               ++failures;
+         }
+      });
+   }
+
+   for( uint32_t n = 2; n <= last; ++n ) {
+      b = make_block( b->id() );
+      log.append( b );
+   }
+   done = true;
+   for( auto& t : threads )
+      t.join();
+
+   BOOST_CHECK_EQUAL( failures.load(), 0u );
+   BOOST_CHECK_EQUAL( reader->head_block_num(), last );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_roll_test) {
+   fc::temp_directory tempdir;
+   const uint32_t last = 2000;
+
+   // blocks.log is replaced every 50 blocks while the threads read
+   block_log log( tempdir.path(), 50 );
+   auto b = make_block( block_id_type() );
+   log.reset( genesis_state(), b );
+   auto reader = log.get_reader();
+
+   std::atomic<bool> done( false );
+   std::atomic<uint32_t> failures( 0 );
+   std::vector<std::thread> threads;
+   for( uint32_t t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&, t]() {
+         uint32_t n = 0;
+         while( !done.load() ) {
+            n += t + 1;
+            try {
+               // blocks rolled into a segment meanwhile aren't served, but a block served must be the right one
+               auto num = reader->head_block_num() - n % 60;
+               auto blk = reader->read_block_by_num( num );
+               if( blk && (blk->block_num() != num || blk->transaction_mroot != digest_type::hash( num )) )
+                  ++failures;
+            } catch( ... ) {
+               ++failures;
+            }
+         }
+      });
+   }
+
+   for( uint32_t n = 2; n <= last; ++n ) {
+      b = make_block( b->id() );
+      log.append( b );
+   }
+   done = true;
+   for( auto& t : threads )
+      t.join();
+
+   BOOST_CHECK_EQUAL( failures.load(), 0u );
+   BOOST_CHECK_EQUAL( reader->head_block_num(), last );
+   BOOST_CHECK( reader->read_block_by_num( last )->id() == b->id() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/chain/block_log.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <fstream>
+
+using namespace snax;
+using namespace chain;
+
+namespace {
+   signed_block_ptr make_block( const block_id_type& previous ) {
+      auto b = std::make_shared<signed_block>();
+      b->previous = previous;
+      b->timestamp = block_timestamp_type( block_header::num_from_id( previous ) + 1 );
+      return b;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(block_log_tests)
+
+BOOST_AUTO_TEST_CASE(segmented_log_test) {
+   fc::temp_directory tempdir;
+   const uint32_t last = 55;
+   typedef std::pair<uint32_t, uint32_t> range;
+
+   std::vector<block_id_type> ids;
+   {
+      block_log log( tempdir.path(), 10, 3 );
+      auto b = make_block( block_id_type() );
+      log.reset( genesis_state(), b );
+      ids.push_back( b->id() );
+      for( uint32_t n = 2; n <= last; ++n ) {
+         b = make_block( ids.back() );
+         log.append( b );
+         ids.push_back( b->id() );
+      }
+
+      std::vector<range> expected = { range(21, 30), range(31, 40), range(41, 50) };
+      BOOST_CHECK( log.segment_ranges() == expected );
+      BOOST_CHECK_EQUAL( log.first_block_num(), 21u );
+      BOOST_CHECK_EQUAL( log.read_head()->block_num(), last );
+      BOOST_CHECK( !fc::exists( tempdir.path() / "blocks-0000000001-0000000010.log" ) );
+      BOOST_CHECK( !log.read_block_by_num( 20 ) );
+   }
+
+   // the index of a completed segment is rebuilt from that segment alone
+   fc::remove( tempdir.path() / "blocks-0000000031-0000000040.index" );
+
+   block_log log( tempdir.path(), 10, 3 );
+   BOOST_CHECK_EQUAL( log.first_block_num(), 21u );
+   BOOST_CHECK_EQUAL( log.head()->block_num(), last );
+   for( uint32_t n = 21; n <= last; ++n ) {
+      BOOST_CHECK( log.read_block_by_num( n )->id() == ids[n - 1] );
+      BOOST_CHECK( log.read_block_header_by_num( n )->id() == ids[n - 1] );
+   }
+
+   auto headers = log.read_block_headers_by_num( 25, 100 );
+   BOOST_REQUIRE_EQUAL( headers.size(), last - 25 + 1 );
+   for( uint32_t i = 0; i < headers.size(); ++i )
+      BOOST_CHECK( headers[i].id() == ids[25 + i - 1] );
+}
+
+BOOST_AUTO_TEST_CASE(stop_segmenting_test) {
+   fc::temp_directory tempdir;
+   block_id_type head_id;
+   {
+      block_log log( tempdir.path(), 5 );
+      auto b = make_block( block_id_type() );
+      log.reset( genesis_state(), b );
+      for( uint32_t n = 2; n <= 12; ++n ) {
+         b = make_block( b->id() );
+         log.append( b );
+      }
+      head_id = b->id();
+      BOOST_CHECK_EQUAL( log.segment_ranges().size(), 2u );
+   }
+
+   // a node that stops segmenting still reads the completed segments and appends to blocks.log
+   block_log log( tempdir.path() );
+   BOOST_REQUIRE( log.head() );
+   BOOST_CHECK( log.head()->id() == head_id );
+   BOOST_CHECK_EQUAL( log.first_block_num(), 1u );
+   for( uint32_t n = 13; n <= 20; ++n ) {
+      auto b = make_block( head_id );
+      log.append( b );
+      head_id = b->id();
+   }
+   BOOST_CHECK_EQUAL( log.segment_ranges().size(), 2u );
+   BOOST_CHECK( log.read_block_by_num( 20 )->id() == head_id );
+   BOOST_CHECK_EQUAL( log.read_block_by_num( 3 )->block_num(), 3u );
+}
+
+BOOST_AUTO_TEST_CASE(interrupted_roll_test) {
+   fc::temp_directory tempdir;
+   block_id_type head_id;
+   {
+      block_log log( tempdir.path(), 5 );
+      auto b = make_block( block_id_type() );
+      log.reset( genesis_state(), b );
+      for( uint32_t n = 2; n <= 10; ++n ) {
+         b = make_block( b->id() );
+         log.append( b );
+      }
+      head_id = b->id();
+   }
+
+   // a crash while rolling blocks 6 to 10 into a segment, after the files were renamed and before
+   // the next blocks.log was written; the segment's index wasn't renamed yet either
+   fc::rename( tempdir.path() / "blocks.log", tempdir.path() / "blocks-0000000006-0000000010.log" );
+
+   block_log log( tempdir.path(), 5 );
+   BOOST_REQUIRE( log.head() );
+   BOOST_CHECK( log.head()->id() == head_id );
+   BOOST_CHECK_EQUAL( log.first_block_num(), 1u );
+   BOOST_CHECK_EQUAL( log.segment_ranges().size(), 2u );
+   BOOST_CHECK_EQUAL( log.read_block_by_num( 8 )->block_num(), 8u );
+
+   auto b = make_block( head_id );
+   log.append( b );
+   BOOST_CHECK( log.read_block_by_num( 11 )->id() == b->id() );
+}
+
+BOOST_AUTO_TEST_CASE(construct_index_test) {
+   fc::temp_directory tempdir;
+   std::vector<uint64_t> positions;
+   {
+      block_log log( tempdir.path() );
+      auto b = make_block( block_id_type() );
+      log.reset( genesis_state(), b );
+      positions.push_back( log.get_block_pos( 1 ) );
+      for( uint32_t n = 2; n <= 200; ++n ) {
+         b = make_block( b->id() );
+         b->block_extensions.emplace_back( 0, vector<char>( n % 17, char(n) ) );
+         positions.push_back( log.append( b ) );
+      }
+   }
+
+   for( uint32_t threads : {1, 4} ) {
+      auto index_file = tempdir.path() / "rebuilt.index";
+      block_log::construct_index( tempdir.path() / "blocks.log", index_file, threads );
+      BOOST_REQUIRE_EQUAL( fc::file_size( index_file ), positions.size() * sizeof(uint64_t) );
+      std::ifstream index( index_file.generic_string().c_str(), std::ios::binary );
+      for( auto expected : positions ) {
+         uint64_t pos = 0;
+         index.read( (char*)&pos, sizeof(pos) );
+         BOOST_CHECK_EQUAL( pos, expected );
+      }
+   }
+
+   // a log that lost its index gets it rebuilt on open
+   fc::remove( tempdir.path() / "blocks.index" );
+   block_log log( tempdir.path() );
+   BOOST_CHECK_EQUAL( log.read_block_by_num( 150 )->block_num(), 150u );
+   BOOST_CHECK_EQUAL( log.get_block_pos( 200 ), positions.back() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -163,4 +163,54 @@ BOOST_AUTO_TEST_CASE(untrusted_producer_test)
    }) ;
 }
 
+/**
+ * Headers read from the block log and the fork database must match the full blocks
+ */
+BOOST_AUTO_TEST_CASE(fetch_block_headers_test)
+{
+   tester main;
+   main.produce_blocks(400);
+
+   auto head_num = main.control->head_block_num();
+   BOOST_REQUIRE(main.control->last_irreversible_block_num() > 1);
+
+   auto headers = main.control->fetch_block_headers_by_number(1, head_num);
+   BOOST_REQUIRE_EQUAL(headers.size(), head_num);
+   for (uint32_t n = 1; n <= head_num; ++n)
+   {
+      auto b = main.control->fetch_block_by_number(n);
+      BOOST_REQUIRE(b);
+      BOOST_CHECK(headers[n - 1].id() == b->id());
+      BOOST_CHECK(main.control->fetch_block_header_by_number(n)->id() == b->id());
+   }
+
+   // ranges stop at the head
+   BOOST_CHECK_EQUAL(main.control->fetch_block_headers_by_number(head_num - 1, 10).size(), 2u);
+   BOOST_CHECK(!main.control->fetch_block_header_by_number(head_num + 1));
+}
+
+/**
+ * Blocks must be found by their timestamp slot both in the block log and in the fork database,
+ * missed slots must not resolve to a block
+ */
+BOOST_AUTO_TEST_CASE(fetch_block_num_by_slot_test)
+{
+   tester main;
+   main.produce_blocks(10);
+   auto missed_slot = main.control->head_block_header().timestamp.slot + 1;
+   main.produce_block(fc::milliseconds(config::block_interval_ms * 2));
+   main.produce_blocks(400);
+
+   BOOST_REQUIRE(main.control->last_irreversible_block_num() > 20);
+   for (uint32_t n = 1; n <= main.control->head_block_num(); ++n)
+   {
+      auto slot = main.control->fetch_block_by_number(n)->timestamp.slot;
+      auto found = main.control->fetch_block_num_by_slot(slot);
+      BOOST_REQUIRE(found.valid());
+      BOOST_CHECK_EQUAL(*found, n);
+   }
+   BOOST_CHECK(!main.control->fetch_block_num_by_slot(missed_slot).valid());
+   BOOST_CHECK(!main.control->fetch_block_num_by_slot(main.control->head_block_header().timestamp.slot + 1).valid());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
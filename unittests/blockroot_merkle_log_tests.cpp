@@ -0,0 +1,122 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/chain/blockroot_merkle_log.hpp>
+#include <snax/testing/tester.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/exception/exception.hpp>
+
+using namespace snax;
+using namespace chain;
+
+namespace {
+   block_id_type make_id( uint32_t n ) {
+      return digest_type::hash( n );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(blockroot_merkle_log_tests)
+
+BOOST_AUTO_TEST_CASE(read_back_test) {
+   fc::temp_directory tempdir;
+   const uint32_t stride = 7;
+   const uint32_t first = 3;
+   const uint32_t last = 200;
+
+   std::vector<incremental_merkle> expected;
+   {
+      blockroot_merkle_log log( tempdir.path(), stride );
+      BOOST_REQUIRE( log.empty() );
+
+      incremental_merkle merkle;
+      for( uint32_t n = first; n <= last; ++n ) {
+         log.append( n, make_id( n ), merkle );
+         expected.push_back( merkle );
+         merkle.append( make_id( n ) );
+      }
+      BOOST_CHECK_EQUAL( log.first_block_num(), first );
+      BOOST_CHECK_EQUAL( log.head_block_num(), last );
+      BOOST_CHECK_THROW( log.append( last + 2, make_id( last + 2 ), merkle ), block_log_append_fail );
+   }
+
+   // reopen and check every block, not only the checkpoints
+   blockroot_merkle_log log( tempdir.path(), stride );
+   BOOST_REQUIRE_EQUAL( log.head_block_num(), last );
+   for( uint32_t n = first; n <= last; ++n ) {
+      auto merkle = log.read_merkle_by_num( n );
+      BOOST_REQUIRE( merkle.valid() );
+      BOOST_CHECK_EQUAL( merkle->_node_count, expected[n - first]._node_count );
+      BOOST_CHECK( merkle->get_root() == expected[n - first].get_root() );
+      BOOST_CHECK( *log.read_id_by_num( n ) == make_id( n ) );
+   }
+   BOOST_CHECK( !log.read_merkle_by_num( first - 1 ).valid() );
+   BOOST_CHECK( !log.read_merkle_by_num( last + 1 ).valid() );
+}
+
+BOOST_AUTO_TEST_CASE(stride_change_test) {
+   fc::temp_directory tempdir;
+   {
+      blockroot_merkle_log log( tempdir.path(), 4 );
+      log.append( 1, make_id( 1 ), incremental_merkle() );
+      BOOST_REQUIRE( !log.empty() );
+   }
+   // a log written with another stride can't be used and is discarded
+   blockroot_merkle_log log( tempdir.path(), 8 );
+   BOOST_CHECK( log.empty() );
+   BOOST_CHECK_EQUAL( log.stride(), 8u );
+}
+
+BOOST_AUTO_TEST_CASE(controller_index_test) { try {
+   testing::tester chain;
+   chain.produce_blocks( 150 );
+   const auto& control = *chain.control;
+   BOOST_REQUIRE( control.last_irreversible_block_num() > 64 );
+
+   // irreversible blocks come from the index, reversible ones from their block state
+   for( uint32_t n = 1; n < control.head_block_num(); ++n ) {
+      auto merkle = control.fetch_blockroot_merkle_by_num( n );
+      BOOST_REQUIRE( merkle.valid() );
+      merkle->append( control.get_block_id_for_num( n ) );
+      BOOST_CHECK( merkle->get_root() == control.fetch_blockroot_merkle_by_num( n + 1 )->get_root() );
+   }
+   BOOST_CHECK( control.fetch_blockroot_merkle_by_num( control.head_block_num() )->get_root()
+                == control.head_block_state()->blockroot_merkle.get_root() );
+   BOOST_CHECK( !control.fetch_blockroot_merkle_by_num( control.head_block_num() + 1 ).valid() );
+
+   // the merkle is no longer carried in the logged blocks
+   BOOST_CHECK( control.fetch_block_by_number( 64 )->block_extensions.empty() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE(legacy_extension_test) { try {
+   testing::tester chain;
+   std::vector<signed_block_ptr> blocks;
+   while( chain.control->head_block_num() < 65 )
+      blocks.push_back( chain.produce_block() );
+   const auto merkle = fc::raw::pack( *chain.control->fetch_blockroot_merkle_by_num( 64 ) );
+
+   // pushes the blocks before block_num, then block_num with the extensions
+   auto push = [&]( uint32_t block_num, const extensions_type& extensions ) {
+      testing::tester other;
+      for( const auto& b : blocks ) {
+         if( b->block_num() < block_num )
+            other.push_block( b );
+      }
+      auto copy = std::make_shared<signed_block>( *blocks[block_num - blocks.front()->block_num()] );
+      copy->block_extensions = extensions;
+      other.push_block( copy );
+      return other.control->head_block_num();
+   };
+
+   BOOST_CHECK_EQUAL( push( 64, {{config::legacy_blockroot_merkle_extension, merkle}} ), 64u );
+   BOOST_CHECK_THROW( push( 64, {{0, merkle}} ), block_validate_exception );
+   BOOST_CHECK_THROW( push( 64, {{config::legacy_blockroot_merkle_extension, merkle},
+                                 {config::legacy_blockroot_merkle_extension, merkle}} ), block_validate_exception );
+   BOOST_CHECK_THROW( push( 64, {{config::legacy_blockroot_merkle_extension, vector<char>( merkle.size() )}} ), block_validate_exception );
+   BOOST_CHECK_THROW( push( 65, {{config::legacy_blockroot_merkle_extension, merkle}} ), block_validate_exception );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
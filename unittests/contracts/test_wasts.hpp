@@ -222,6 +222,40 @@ static const char mutable_global_wast[] = R"=====(
 )
 )=====";
 
+static const char data_reset_large_wast[] = R"=====(
+(module
+ (import "env" "snax_assert" (func $snax_assert (param i32 i32)))
+ (memory $0 2)
+ (data (i32.const 70000) "\2a\2a\2a\2a")
+ (export "apply" (func $apply))
+ (func $apply (param $0 i64) (param $1 i64) (param $2 i64)
+  (call $snax_assert (i32.eq (i32.load (i32.const 70000)) (i32.const 707406378)) (i32.const 0))
+  (call $snax_assert (i32.eqz (i32.load (i32.const 8))) (i32.const 0))
+  (call $snax_assert (i32.eqz (i32.load (i32.const 60000))) (i32.const 0))
+  (call $snax_assert (i32.eqz (i32.load (i32.const 100000))) (i32.const 0))
+  (i32.store (i32.const 70000) (i32.const 7))
+  (i32.store (i32.const 8) (i32.const 7))
+  (i32.store (i32.const 60000) (i32.const 7))
+  (i32.store (i32.const 100000) (i32.const 7))
+ )
+)
+)=====";
+
+static const char data_reset_small_wast[] = R"=====(
+(module
+ (import "env" "snax_assert" (func $snax_assert (param i32 i32)))
+ (memory $0 1)
+ (data (i32.const 8) "\2b\2b\2b\2b")
+ (export "apply" (func $apply))
+ (func $apply (param $0 i64) (param $1 i64) (param $2 i64)
+  (call $snax_assert (i32.eq (i32.load (i32.const 8)) (i32.const 724249387)) (i32.const 0))
+  (call $snax_assert (i32.eqz (i32.load (i32.const 60000))) (i32.const 0))
+  (i32.store (i32.const 8) (i32.const 9))
+  (i32.store (i32.const 60000) (i32.const 9))
+ )
+)
+)=====";
+
 static const char biggest_memory_wast[] = R"=====(
 (module
  (import "env" "snax_assert" (func $$snax_assert (param i32 i32)))
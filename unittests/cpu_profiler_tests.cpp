@@ -0,0 +1,59 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/chain/cpu_profiler.hpp>
+#include <thread>
+
+using namespace snax;
+using namespace chain;
+
+BOOST_AUTO_TEST_SUITE(cpu_profiler_tests)
+
+BOOST_AUTO_TEST_CASE(histogram_test) {
+   cpu_profiler::reset();
+   cpu_profiler::set_enabled( false );
+   {
+      cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::action, N(alice), N(snax), N(transfer) );
+   }
+   BOOST_CHECK( cpu_profiler::snapshot().empty() );
+
+   cpu_profiler::set_enabled( true );
+   cpu_profiler::sample_key key;
+   key.kind = cpu_profiler::sample_kind::db;
+   key.receiver = N(alice);
+   key.function = "db_find_i64";
+   cpu_profiler::record( key, 0 );
+   cpu_profiler::record( key, 1000 );
+   std::thread( [&]() { cpu_profiler::record( key, uint64_t(1) << 40 ); } ).join();
+   {
+      cpu_profiler::profile_scope prof( cpu_profiler::sample_kind::action, N(alice), N(snax), N(transfer) );
+   }
+   cpu_profiler::set_enabled( false );
+
+   auto entries = cpu_profiler::snapshot();
+   BOOST_REQUIRE_EQUAL( entries.size(), 2u );
+   const auto& db = entries.front();
+   BOOST_CHECK_EQUAL( db.kind, "db" );
+   BOOST_CHECK_EQUAL( db.function, "db_find_i64" );
+   BOOST_CHECK( db.receiver == N(alice) );
+   BOOST_CHECK_EQUAL( db.count, 3u );
+   BOOST_CHECK_EQUAL( db.total_ns, 1000 + ( uint64_t(1) << 40 ) );
+   BOOST_CHECK_EQUAL( db.max_ns, uint64_t(1) << 40 );
+   BOOST_REQUIRE_EQUAL( db.buckets.size(), cpu_profiler::bucket_count );
+   BOOST_CHECK_EQUAL( db.buckets[0], 1u );
+   BOOST_CHECK_EQUAL( db.buckets[9], 1u );   // 1000 ns
+   BOOST_CHECK_EQUAL( db.buckets.back(), 1u );
+
+   const auto& act = entries.back();
+   BOOST_CHECK_EQUAL( act.kind, "action" );
+   BOOST_CHECK_EQUAL( act.count, 1u );
+   BOOST_CHECK( act.account == N(snax) && act.action == N(transfer) );
+
+   cpu_profiler::reset();
+   BOOST_CHECK( cpu_profiler::snapshot().empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/chain/fork_database.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/exception/exception.hpp>
+#include <boost/filesystem.hpp>
+
+using namespace snax;
+using namespace chain;
+
+namespace {
+   block_state_ptr make_genesis( uint32_t producer_count ) {
+      producer_schedule_type schedule;
+      for( uint32_t i = 0; i < producer_count; ++i )
+         schedule.producers.push_back( producer_key{ account_name( string("prod") + char('a' + i) ), public_key_type() } );
+
+      block_header_state genheader;
+      genheader.active_schedule = schedule;
+      genheader.pending_schedule = schedule;
+      genheader.pending_schedule_hash = fc::sha256::hash( schedule );
+      genheader.id = genheader.header.id();
+      genheader.block_num = genheader.header.block_num();
+
+      auto s = std::make_shared<block_state>( genheader );
+      s->block = std::make_shared<signed_block>( genheader.header );
+      return s;
+   }
+
+   /// `skip` leaves slots empty, so blocks built on the same previous block differ
+   block_state_ptr make_next( const block_state& prev, uint32_t skip = 0 ) {
+      auto when = prev.header.timestamp;
+      when.slot += 1 + skip;
+      auto s = std::make_shared<block_state>( prev, when );
+      s->set_confirmed( 1 );
+      static_cast<block_header&>( *s->block ) = s->header;
+      s->id = s->header.id();
+      return s;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(fork_database_tests)
+
+BOOST_AUTO_TEST_CASE(persist_test) {
+   fc::temp_directory tempdir;
+   vector<block_state_ptr> main, fork;
+   {
+      // with 21 producers nothing becomes irreversible within 30 blocks
+      fork_database fork_db( tempdir.path() );
+      main.push_back( make_genesis( 21 ) );
+      fork_db.set( main.back() );
+      fork_db.mark_in_current_chain( main.back(), true );
+      for( uint32_t n = 2; n <= 30; ++n ) {
+         main.push_back( make_next( *main.back() ) );
+         fork_db.add( main.back(), false );
+         fork_db.mark_in_current_chain( main.back(), true );
+         fork_db.set_validity( main.back(), true );
+      }
+
+      fork.push_back( make_next( *main[18], 1 ) );
+      fork_db.add( fork.back(), false );
+      for( uint32_t n = 21; n <= 25; ++n ) {
+         fork.push_back( make_next( *fork.back() ) );
+         fork_db.add( fork.back(), false );
+      }
+      BOOST_CHECK( fork_db.head()->id == main.back()->id );
+
+      // drops 23' to 25'
+      fork_db.remove( fork[3]->id );
+      BOOST_CHECK( !fork_db.get_block( fork[5]->id ) );
+      BOOST_CHECK( fork_db.get_block( fork[2]->id ) );
+   }
+
+   fork_database fork_db( tempdir.path() );
+   BOOST_REQUIRE( fork_db.head() );
+   BOOST_CHECK( fork_db.head()->id == main.back()->id );
+   for( const auto& s : main ) {
+      auto b = fork_db.get_block( s->id );
+      BOOST_REQUIRE( b );
+      BOOST_CHECK( b->in_current_chain );
+      BOOST_CHECK_EQUAL( b->validated, s->block_num > 1 );
+      BOOST_CHECK( fork_db.get_block_in_current_chain_by_num( s->block_num )->id == s->id );
+   }
+   for( uint32_t i = 0; i < fork.size(); ++i ) {
+      auto b = fork_db.get_block( fork[i]->id );
+      BOOST_CHECK_EQUAL( bool(b), i < 3 );
+      if( b )
+         BOOST_CHECK( !b->in_current_chain && !b->validated );
+   }
+
+   auto branches = fork_db.fetch_branch_from( fork[2]->id, main.back()->id );
+   BOOST_REQUIRE_EQUAL( branches.first.size(), 3u );
+   BOOST_REQUIRE_EQUAL( branches.second.size(), 11u );
+   BOOST_CHECK( branches.first.back()->id == fork[0]->id );
+   BOOST_CHECK( branches.second.back()->id == main[19]->id );
+   BOOST_CHECK( branches.first.back()->header.previous == main[18]->id );
+}
+
+BOOST_AUTO_TEST_CASE(unclean_close_test) {
+   fc::temp_directory tempdir;
+   auto fork_db_dat = tempdir.path() / config::forkdb_filename;
+   {
+      fork_database fork_db( tempdir.path() );
+      auto s = make_genesis( 21 );
+      fork_db.set( s );
+      for( uint32_t n = 2; n <= 5; ++n ) {
+         s = make_next( *s );
+         fork_db.add( s, false );
+      }
+   }
+
+   // without the head block id at its end the file is what a crash leaves behind
+   auto size = fc::file_size( fork_db_dat );
+   BOOST_REQUIRE( size > sizeof(uint8_t) + sizeof(block_id_type) );
+   boost::filesystem::resize_file( fork_db_dat, size - sizeof(uint8_t) - sizeof(block_id_type) );
+
+   fork_database fork_db( tempdir.path() );
+   BOOST_CHECK( !fork_db.head() );
+}
+
+BOOST_AUTO_TEST_CASE(prune_test) {
+   fc::temp_directory tempdir;
+   auto fork_db_dat = tempdir.path() / config::forkdb_filename;
+   const uint32_t last = 2000;
+
+   vector<block_id_type> ids;
+   vector<uint32_t> irreversible;
+   {
+      // with a single producer confirming its previous block, blocks become irreversible two blocks later
+      fork_database fork_db( tempdir.path() );
+      fork_db.irreversible.connect( [&]( const block_state_ptr& s ) { irreversible.push_back( s->block_num ); } );
+
+      auto s = make_genesis( 1 );
+      fork_db.set( s );
+      fork_db.mark_in_current_chain( s, true );
+      ids.push_back( s->id );
+      size_t max_state_size = 0;
+      for( uint32_t n = 2; n <= last; ++n ) {
+         s = make_next( *s );
+         fork_db.add( s, false );
+         fork_db.mark_in_current_chain( s, true );
+         fork_db.set_validity( s, true );
+         ids.push_back( s->id );
+         max_state_size = std::max( max_state_size, fc::raw::pack_size( *s ) );
+      }
+
+      BOOST_REQUIRE( !irreversible.empty() );
+      BOOST_CHECK_EQUAL( irreversible.front(), 1u );
+      for( uint32_t i = 1; i < irreversible.size(); ++i )
+         BOOST_CHECK_EQUAL( irreversible[i], irreversible[i - 1] + 1 );
+      BOOST_CHECK( irreversible.back() + 10 > last );
+      BOOST_CHECK( !fork_db.get_block( ids[irreversible.back() - 1] ) );
+      BOOST_CHECK( fork_db.get_block( ids.back() ) );
+
+      // the file is rewritten rather than growing with every block
+      BOOST_CHECK( fc::file_size( fork_db_dat ) < 300 * ( max_state_size + 128 ) );
+   }
+
+   fork_database fork_db( tempdir.path() );
+   BOOST_REQUIRE( fork_db.head() );
+   BOOST_CHECK( fork_db.head()->id == ids.back() );
+   BOOST_CHECK( fork_db.get_block_in_current_chain_by_num( last )->id == ids.back() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/ibc_plugin/message_compression.hpp>
+
+using namespace snax;
+using namespace snax::ibc;
+
+namespace {
+   lwc_section_data_message make_section( uint32_t count ) {
+      lwc_section_data_message msg;
+      for( uint32_t i = 0; i < count; ++i ) {
+         signed_block_header h;
+         if( !msg.headers.empty() ) {
+            const auto& prev = msg.headers.back();
+            h.previous = prev.id();
+            h.timestamp = block_timestamp_type( prev.timestamp.slot + 1 + i % 3 );
+            h.schedule_version = prev.schedule_version;
+         }
+         h.producer = i % 12 < 6 ? N(alice) : N(bob);
+         h.confirmed = i % 2;
+         h.transaction_mroot = digest_type::hash( i );
+         h.action_mroot = digest_type::hash( i + count );
+         if( i == count / 2 ) {
+            h.schedule_version = 1;
+            producer_schedule_type schedule;
+            schedule.version = 1;
+            schedule.producers.push_back( producer_key{ N(bob), public_key_type() } );
+            h.new_producers = schedule;
+         }
+         h.header_extensions.emplace_back( uint16_t(1), vector<char>( 4, char(i) ) );
+         msg.headers.push_back( h );
+         msg.blockroot_merkle.append( h.id() );
+      }
+      return msg;
+   }
+
+   ibc_trxs_data_message make_trxs( uint32_t count, size_t receipt_size ) {
+      ibc_trxs_data_message msg;
+      msg.table = N(origtrxs);
+      for( uint32_t i = 0; i < count; ++i ) {
+         ibc_trx_rich_info info;
+         info.table_id = i;
+         info.block_num = 100 + i;
+         info.trx_id = transaction_id_type::hash( i );
+         info.packed_trx_receipt.resize( receipt_size, char(i) );
+         info.merkle_path.resize( 10, digest_type::hash( i ) );
+         msg.trxs_rich_info.push_back( info );
+      }
+      return msg;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(ibc_message_compression_tests)
+
+BOOST_AUTO_TEST_CASE(section_round_trip) {
+   auto section = make_section( 30 );
+   auto delta = encode_section( section );
+   BOOST_REQUIRE( delta.valid() );
+   BOOST_CHECK_EQUAL( delta->deltas.size(), 29u );
+   BOOST_CHECK( fc::raw::pack_size( *delta ) < fc::raw::pack_size( section ) );
+
+   auto decoded = decode_section( std::move(*delta) );
+   BOOST_CHECK( fc::raw::pack( decoded ) == fc::raw::pack( section ) );
+}
+
+BOOST_AUTO_TEST_CASE(section_not_encoded) {
+   BOOST_CHECK( !encode_section( lwc_section_data_message() ).valid() );
+
+   // a header which doesn't follow the one before it
+   auto section = make_section( 5 );
+   section.headers[3].previous = digest_type::hash( 3 );
+   BOOST_CHECK( !encode_section( section ).valid() );
+
+   // a timestamp going back
+   section = make_section( 5 );
+   section.headers[3].timestamp = block_timestamp_type( section.headers[2].timestamp.slot - 1 );
+   section.headers[4].previous = section.headers[3].id();
+   BOOST_CHECK( !encode_section( section ).valid() );
+}
+
+BOOST_AUTO_TEST_CASE(message_round_trip) {
+   ibc_message msg( make_trxs( 50, 320 ) );
+   auto compressed = compress_message( msg, 0 );
+   BOOST_REQUIRE( compressed.valid() );
+   BOOST_CHECK( compressed->data.size() < fc::raw::pack_size( msg ) );
+
+   auto decompressed = decompress_message( *compressed, max_decompressed_message_size );
+   BOOST_REQUIRE( decompressed.contains<ibc_trxs_data_message>() );
+   BOOST_CHECK( fc::raw::pack( decompressed ) == fc::raw::pack( msg ) );
+
+   // too small to be worth it
+   BOOST_CHECK( !compress_message( msg, fc::raw::pack_size( msg ) + 1 ).valid() );
+}
+
+BOOST_AUTO_TEST_CASE(decompress_limit) {
+   // compresses to a few kilobytes, unpacks to more than a read message may hold
+   ibc_message msg( make_trxs( 1, max_decompressed_message_size ) );
+   auto compressed = compress_message( msg, 0 );
+   BOOST_REQUIRE( compressed.valid() );
+   BOOST_CHECK( compressed->data.size() < max_decompressed_message_size / 100 );
+   BOOST_CHECK_THROW( decompress_message( *compressed, max_decompressed_message_size ), fc::exception );
+
+   // right at the limit it still unpacks
+   BOOST_CHECK_NO_THROW( decompress_message( *compressed, fc::raw::pack_size( msg ) ) );
+   BOOST_CHECK_THROW( decompress_message( *compressed, fc::raw::pack_size( msg ) - 1 ), fc::exception );
+}
+
+BOOST_AUTO_TEST_CASE(nested_compression) {
+   auto inner = compress_message( ibc_message( make_trxs( 50, 320 ) ), 0 );
+   BOOST_REQUIRE( inner.valid() );
+   inner->data.resize( inner->data.size() * 4 );   // padding so the outer message shrinks too
+   auto outer = compress_message( ibc_message( *inner ), 0 );
+   BOOST_REQUIRE( outer.valid() );
+   BOOST_CHECK_THROW( decompress_message( *outer, max_decompressed_message_size ), fc::exception );
+}
+
+BOOST_AUTO_TEST_CASE(corrupted_data) {
+   auto compressed = compress_message( ibc_message( make_trxs( 50, 320 ) ), 0 );
+   BOOST_REQUIRE( compressed.valid() );
+   compressed->data.resize( compressed->data.size() / 2 );
+   BOOST_CHECK_THROW( decompress_message( *compressed, max_decompressed_message_size ), fc::exception );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,220 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/ibc_plugin/ibc_table_mirror.hpp>
+#include <snax/testing/chainbase_fixture.hpp>
+
+using namespace snax;
+using namespace snax::ibc;
+
+namespace mirror_test {
+   struct test_row {
+      uint64_t    id;
+      uint64_t    block_time_slot;
+      std::string memo;
+   };
+}
+
+FC_REFLECT( mirror_test::test_row, (id)(block_time_slot)(memo) )
+
+namespace {
+   using mirror_test::test_row;
+   using test_mirror = ibc_table_mirror<test_row, &test_row::id>;
+
+   /// a state with the tables of two contracts, blocks are undo sessions pushed on top of it
+   struct mirror_fixture : snax::testing::chainbase_fixture<1024*1024> {
+      mirror_fixture() {
+         _db->add_index<table_id_multi_index>();
+         _db->add_index<key_value_index>();
+         origtrxs = create_table( N(ibc.token) );
+         other = create_table( N(other) );
+      }
+
+      chainbase::database& db() { return *_db; }
+
+      test_mirror make_mirror() {
+         return test_mirror( db(), [this]() { return head; }, N(ibc.token), N(origtrxs) );
+      }
+
+      table_id create_table( account_name code ) {
+         return db().create<table_id_object>( [&]( auto& t ) {
+            t.code = code;
+            t.scope = code;
+            t.table = N(origtrxs);
+            t.payer = code;
+         } ).id;
+      }
+
+      void put( table_id tid, uint64_t id, uint64_t tslot, const string& memo ) {
+         auto data = fc::raw::pack( test_row{ id, tslot, memo } );
+         const auto* obj = db().find<key_value_object, by_scope_primary>( boost::make_tuple( tid, id ) );
+         if( obj == nullptr ) {
+            db().create<key_value_object>( [&]( auto& o ) {
+               o.t_id = tid;
+               o.primary_key = id;
+               o.value.assign( data.data(), data.size() );
+            } );
+         } else {
+            db().modify( *obj, [&]( auto& o ) {
+               o.value.assign( data.data(), data.size() );
+            } );
+         }
+      }
+
+      void remove( table_id tid, uint64_t id ) {
+         db().remove( db().get<key_value_object, by_scope_primary>( boost::make_tuple( tid, id ) ) );
+      }
+
+      /// "id:memo" of every row of the mirror, in key order
+      static vector<string> contents( test_mirror& mirror ) {
+         vector<string> result;
+         for( const auto& r : mirror.rows() )
+            result.push_back( std::to_string( r.id ) + ":" + r.memo );
+         return result;
+      }
+
+      table_id   origtrxs;
+      table_id   other;
+      uint32_t   head = 0;   ///< the block the state is at, sessions beyond it are pending
+   };
+
+   using strings = vector<string>;
+}
+
+BOOST_AUTO_TEST_SUITE(ibc_table_mirror_tests)
+
+BOOST_FIXTURE_TEST_CASE(block_deltas, mirror_fixture) {
+   put( origtrxs, 1, 10, "a" );
+   put( origtrxs, 2, 10, "b" );
+   put( origtrxs, 3, 11, "c" );
+   put( other, 7, 10, "x" );
+
+   auto mirror = make_mirror();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a", "2:b", "3:c" }) );
+
+   // block 1 modifies, removes and adds rows, and touches a table with the same name of another contract
+   {
+      auto block = db().start_undo_session( true );
+      put( origtrxs, 2, 10, "b2" );
+      remove( origtrxs, 3 );
+      put( origtrxs, 4, 12, "d" );
+      put( other, 7, 10, "x2" );
+      put( other, 8, 12, "y" );
+      block.push();
+   }
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a", "2:b2", "4:d" }) );
+   BOOST_CHECK( mirror.key_range() == std::make_pair( uint64_t(1), uint64_t(4) ) );
+   BOOST_REQUIRE( mirror.first_row_from_tslot( 11 ).valid() );
+   BOOST_CHECK_EQUAL( mirror.first_row_from_tslot( 11 )->id, 4u );
+
+   // block 2 removes a row it added itself and re-adds one removed before
+   {
+      auto block = db().start_undo_session( true );
+      put( origtrxs, 5, 13, "e" );
+      remove( origtrxs, 5 );
+      put( origtrxs, 3, 13, "c2" );
+      remove( origtrxs, 1 );
+      block.push();
+   }
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "2:b2", "3:c2", "4:d" }) );
+   BOOST_CHECK( !mirror.find( 1 ).valid() );
+   BOOST_CHECK( !mirror.find( 5 ).valid() );
+   BOOST_REQUIRE( mirror.find( 3 ).valid() );
+   BOOST_CHECK_EQUAL( mirror.find( 3 )->block_time_slot, 13u );
+}
+
+BOOST_FIXTURE_TEST_CASE(fork_switch, mirror_fixture) {
+   put( origtrxs, 1, 10, "a" );
+   auto mirror = make_mirror();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a" }) );
+
+   {
+      auto block = db().start_undo_session( true );
+      put( origtrxs, 2, 11, "b" );
+      block.push();
+   }
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a", "2:b" }) );
+
+   // switch to a fork where block 1 changed something else; its undo state doesn't follow the mirror at block 1
+   db().undo();
+   --head;
+   {
+      auto block = db().start_undo_session( true );
+      put( origtrxs, 1, 10, "a2" );
+      put( origtrxs, 3, 11, "c" );
+      block.push();
+   }
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a2", "3:c" }) );
+
+   // and the reloaded mirror follows the next block again
+   {
+      auto block = db().start_undo_session( true );
+      remove( origtrxs, 3 );
+      block.push();
+   }
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a2" }) );
+}
+
+BOOST_FIXTURE_TEST_CASE(sync_in_pending_block, mirror_fixture) {
+   put( origtrxs, 1, 10, "a" );
+   put( origtrxs, 2, 10, "b" );
+
+   auto block = db().start_undo_session( true );
+   put( origtrxs, 1, 10, "a2" );
+   remove( origtrxs, 2 );
+   put( origtrxs, 3, 11, "c" );
+   put( other, 4, 11, "x" );
+
+   // read while the block is pending: the copy is as of the head block
+   auto mirror = make_mirror();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a", "2:b" }) );
+
+   block.push();
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a2", "3:c" }) );
+}
+
+BOOST_FIXTURE_TEST_CASE(sync_in_unknown_state, mirror_fixture) {
+   put( origtrxs, 1, 10, "a" );
+
+   // two undo sessions beyond the head block, the mirror can't tell which changes the head block has
+   auto block = db().start_undo_session( true );
+   put( origtrxs, 2, 11, "b" );
+   auto trx = db().start_undo_session( true );
+   put( origtrxs, 3, 11, "c" );
+
+   auto mirror = make_mirror();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a", "2:b", "3:c" }) );
+
+   // the second session doesn't make it into the block, the mirror reloads instead of applying the block
+   trx.undo();
+   block.push();
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a", "2:b" }) );
+
+   {
+      auto next = db().start_undo_session( true );
+      put( origtrxs, 4, 12, "d" );
+      next.push();
+   }
+   ++head;
+   mirror.on_accepted_block();
+   BOOST_CHECK( contents( mirror ) == strings({ "1:a", "2:b", "4:d" }) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -608,6 +608,39 @@ BOOST_AUTO_TEST_CASE(transaction_test) { try {
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE(merkle_tree_test) { try {
+   for( uint32_t count : {0, 1, 2, 3, 5, 8, 13, 64, 100} ) {
+      vector<digest_type> leaves;
+      for( uint32_t i = 0; i < count; ++i )
+         leaves.push_back( digest_type::hash( i ) );
+
+      merkle_tree tree( leaves );
+      BOOST_REQUIRE_EQUAL( tree.size(), count );
+      BOOST_REQUIRE_EQUAL( tree.root(), merkle( leaves ) );
+      BOOST_CHECK( tree.get_path( count ).empty() );
+
+      // every path must fold back to the root
+      for( uint32_t i = 0; i < count; ++i ) {
+         auto path = tree.get_path( i );
+         BOOST_REQUIRE( !path.empty() );
+         BOOST_CHECK_EQUAL( path.back(), tree.root() );
+         if( count == 1 ) {
+            BOOST_CHECK_EQUAL( path.size(), 1u );
+            continue;
+         }
+         BOOST_CHECK( path[i % 2] == leaves[i] );
+         auto node = digest_type::hash( make_canonical_pair( path[0], path[1] ) );
+         for( size_t j = 2; j + 1 < path.size(); ++j ) {
+            if( is_canonical_left( path[j] ) )
+               node = digest_type::hash( make_canonical_pair( path[j], node ) );
+            else
+               node = digest_type::hash( make_canonical_pair( node, path[j] ) );
+         }
+         BOOST_CHECK_EQUAL( node, tree.root() );
+      }
+   }
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace snax
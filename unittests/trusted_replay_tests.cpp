@@ -0,0 +1,138 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/testing/tester.hpp>
+#include <snax/chain/block_log.hpp>
+#include <fc/filesystem.hpp>
+
+#include <algorithm>
+
+using namespace snax;
+using namespace testing;
+using namespace chain;
+
+namespace {
+   /// a block log with transactions in two blocks, both irreversible
+   struct replay_fixture {
+      replay_fixture() {
+         chain.create_accounts( {N(alice), N(bob), N(carol)} );
+         first_trx_block = chain.produce_block()->block_num();
+         chain.create_accounts( {N(dave), N(erin)} );
+         second_trx_block = chain.produce_block()->block_num();
+         while( chain.control->last_irreversible_block_num() <= second_trx_block )
+            chain.produce_block();
+
+         for( uint32_t n = 1; n <= chain.control->last_irreversible_block_num(); ++n )
+            blocks.push_back( chain.control->fetch_block_by_number( n ) );
+         cfg = chain.get_config();
+         log_dir = cfg.blocks_dir;
+         chain.close();
+      }
+
+      /// a config with fresh state on top of a copy of the block log written by `blocks`
+      controller::config replay_config( fc::temp_directory& dir ) {
+         auto result = cfg;
+         result.blocks_dir = dir.path() / config::default_blocks_dir_name;
+         result.state_dir = dir.path() / config::default_state_dir_name;
+         fc::create_directories( result.blocks_dir );
+         fc::copy( log_dir / "blocks.log", result.blocks_dir / "blocks.log" );
+         return result;
+      }
+
+      /// the number of the block of every replayed transaction, split by whether its signing keys were recovered
+      struct recovery {
+         vector<uint32_t> recovered;
+         vector<uint32_t> not_recovered;
+      };
+
+      static recovery replay( const controller::config& cfg ) {
+         recovery result;
+         controller c( cfg );
+         c.add_indices();
+         c.accepted_transaction.connect( [&]( const transaction_metadata_ptr& trx ) {
+            if( trx->implicit )
+               return;
+            auto block_num = c.pending_block_state()->block_num;
+            if( trx->signing_keys.valid() || trx->signing_keys_future.valid() )
+               result.recovered.push_back( block_num );
+            else
+               result.not_recovered.push_back( block_num );
+         } );
+         c.startup( []() { return false; } );
+         BOOST_REQUIRE( c.head_block_num() >= cfg.checkpoints.rbegin()->first );
+         return result;
+      }
+
+      tester                    chain;   ///< closed, keeps the block log
+      uint32_t                  first_trx_block = 0;
+      uint32_t                  second_trx_block = 0;
+      vector<signed_block_ptr>  blocks;
+      controller::config        cfg;
+      fc::path                  log_dir;
+   };
+
+   bool every( const vector<uint32_t>& nums, std::function<bool(uint32_t)> pred ) {
+      return std::all_of( nums.begin(), nums.end(), pred );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(trusted_replay_tests)
+
+BOOST_FIXTURE_TEST_CASE(no_key_recovery_up_to_checkpoint, replay_fixture) { try {
+   const uint32_t checkpoint = first_trx_block;
+
+   // without trusted replay force-all-checks recovers the keys of every transaction
+   {
+      fc::temp_directory dir;
+      auto replay_cfg = replay_config( dir );
+      replay_cfg.force_all_checks = true;
+      replay_cfg.checkpoints[checkpoint] = blocks[checkpoint - 1]->id();
+      auto result = replay( replay_cfg );
+      BOOST_CHECK( result.not_recovered.empty() );
+      BOOST_CHECK( !result.recovered.empty() );
+   }
+
+   // with it, none at or below the checkpoint and all of them above
+   {
+      fc::temp_directory dir;
+      auto replay_cfg = replay_config( dir );
+      replay_cfg.force_all_checks = true;
+      replay_cfg.trusted_replay = true;
+      replay_cfg.checkpoints[checkpoint] = blocks[checkpoint - 1]->id();
+      auto result = replay( replay_cfg );
+      BOOST_REQUIRE( !result.not_recovered.empty() );
+      BOOST_REQUIRE( !result.recovered.empty() );
+      BOOST_CHECK( every( result.not_recovered, [&]( uint32_t n ) { return n <= checkpoint; } ) );
+      BOOST_CHECK( every( result.recovered, [&]( uint32_t n ) { return n > checkpoint; } ) );
+   }
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE(corrupted_transaction_mroot, replay_fixture) { try {
+   const uint32_t checkpoint = second_trx_block;
+
+   // a block log ending in a block with a corrupted transaction_mroot, the checkpoint is that block
+   fc::temp_directory dir;
+   auto replay_cfg = cfg;
+   replay_cfg.blocks_dir = dir.path() / config::default_blocks_dir_name;
+   replay_cfg.state_dir = dir.path() / config::default_state_dir_name;
+   auto corrupted = std::make_shared<signed_block>( *blocks[checkpoint - 1] );
+   corrupted->transaction_mroot = digest_type::hash( string("corrupted") );
+   {
+      block_log log( replay_cfg.blocks_dir );
+      log.reset( cfg.genesis, blocks[0] );
+      for( uint32_t n = 2; n < checkpoint; ++n )
+         log.append( blocks[n - 1] );
+      log.append( corrupted );
+   }
+
+   replay_cfg.force_all_checks = true;
+   replay_cfg.trusted_replay = true;
+   replay_cfg.checkpoints[checkpoint] = corrupted->id();
+   BOOST_CHECK_EXCEPTION( replay( replay_cfg ), block_validate_exception,
+                          fc_exception_message_is( "transaction_mroot does not match" ) );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/chain/wasm_code_cache.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace snax;
+using namespace chain;
+
+namespace {
+   wasm_code_cache::entry make_entry( uint8_t fill ) {
+      wasm_code_cache::entry e;
+      e.code.assign( 1000, fill );
+      e.initial_memory.assign( 100, uint8_t( fill + 1 ) );
+      return e;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(wasm_code_cache_tests)
+
+BOOST_AUTO_TEST_CASE(roundtrip_test) {
+   fc::temp_directory tempdir;
+   auto id1 = fc::sha256::hash( string("code1") );
+   auto id2 = fc::sha256::hash( string("code2") );
+   {
+      wasm_code_cache cache( tempdir.path() / "code_cache" );
+      BOOST_REQUIRE( cache.enabled() );
+      BOOST_CHECK( !cache.get( id1 ) );
+      cache.put( id1, make_entry( 1 ) );
+      cache.put( id2, make_entry( 2 ) );
+   }
+
+   wasm_code_cache cache( tempdir.path() / "code_cache" );
+   auto e = cache.get( id1 );
+   BOOST_REQUIRE( e );
+   BOOST_CHECK( e->code == make_entry( 1 ).code );
+   BOOST_CHECK( e->initial_memory == make_entry( 1 ).initial_memory );
+   BOOST_CHECK( cache.get( id2 )->code == make_entry( 2 ).code );
+
+   cache.remove( id2 );
+   BOOST_CHECK( !cache.get( id2 ) );
+}
+
+BOOST_AUTO_TEST_CASE(damaged_entry_test) {
+   fc::temp_directory tempdir;
+   auto dir = tempdir.path() / "code_cache";
+   auto id = fc::sha256::hash( string("code") );
+   wasm_code_cache cache( dir );
+   auto file = dir / ( id.str() + ".wasm" );
+
+   // a flipped byte of the code fails the checksum
+   cache.put( id, make_entry( 1 ) );
+   {
+      std::fstream f( file.generic_string().c_str(), std::ios::in | std::ios::out | std::ios::binary );
+      f.seekp( fc::file_size( file ) - 200 );
+      f.put( 7 );
+   }
+   BOOST_CHECK( !cache.get( id ) );
+   BOOST_CHECK( !fc::exists( file ) );
+
+   // so does a truncated file
+   cache.put( id, make_entry( 1 ) );
+   boost::filesystem::resize_file( file, fc::file_size( file ) / 2 );
+   BOOST_CHECK( !cache.get( id ) );
+   BOOST_CHECK( !fc::exists( file ) );
+
+   // an entry stored under another code id is never returned for this one
+   auto other = fc::sha256::hash( string("other") );
+   cache.put( other, make_entry( 2 ) );
+   fc::rename( dir / ( other.str() + ".wasm" ), file );
+   BOOST_CHECK( !cache.get( id ) );
+}
+
+BOOST_AUTO_TEST_CASE(disabled_test) {
+   wasm_code_cache cache{ fc::path() };
+   auto id = fc::sha256::hash( string("code") );
+   BOOST_CHECK( !cache.enabled() );
+   cache.put( id, make_entry( 1 ) );
+   BOOST_CHECK( !cache.get( id ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/chain/wasm_instantiation_cache.hpp>
+#include <fc/crypto/sha256.hpp>
+
+using namespace snax;
+using namespace chain;
+
+namespace {
+   struct fake_module : wasm_instantiated_module_interface {
+      explicit fake_module( size_t size ) : size(size) {}
+      void apply( apply_context& ) override {}
+      size_t memory_size() const override { return size; }
+      size_t size;
+   };
+
+   std::unique_ptr<wasm_instantiated_module_interface> make_module( size_t size ) {
+      return std::make_unique<fake_module>( size );
+   }
+
+   digest_type code( const string& name ) {
+      return fc::sha256::hash( name );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(wasm_instantiation_cache_tests)
+
+BOOST_AUTO_TEST_CASE(lru_eviction_test) {
+   wasm_instantiation_cache cache( 300, {} );
+
+   cache.add( code("a"), N(alice), make_module( 100 ) );
+   cache.add( code("b"), N(bob), make_module( 100 ) );
+   cache.add( code("c"), N(carol), make_module( 100 ) );
+   BOOST_CHECK_EQUAL( cache.stats().memory_size, 300u );
+
+   // a is used again, so b is the least recently used one now
+   BOOST_CHECK( cache.get( code("a"), N(alice) ) );
+   cache.add( code("d"), N(dan), make_module( 100 ) );
+   BOOST_CHECK( cache.contains( code("a") ) );
+   BOOST_CHECK( !cache.contains( code("b") ) );
+   BOOST_CHECK( cache.contains( code("c") ) );
+   BOOST_CHECK( cache.contains( code("d") ) );
+
+   BOOST_CHECK( !cache.get( code("b"), N(bob) ) );
+
+   const auto& stats = cache.stats();
+   BOOST_CHECK_EQUAL( stats.hits, 1u );
+   BOOST_CHECK_EQUAL( stats.misses, 1u );
+   BOOST_CHECK_EQUAL( stats.evictions, 1u );
+   BOOST_CHECK_EQUAL( stats.entries, 3u );
+   BOOST_CHECK_EQUAL( stats.memory_size, 300u );
+   BOOST_CHECK_EQUAL( stats.max_memory_size, 300u );
+
+   // a module larger than the cache evicts everything else but is kept itself
+   cache.add( code("e"), N(erin), make_module( 500 ) );
+   BOOST_CHECK_EQUAL( cache.stats().entries, 1u );
+   BOOST_CHECK( cache.contains( code("e") ) );
+   BOOST_CHECK_EQUAL( cache.stats().evictions, 4u );
+}
+
+BOOST_AUTO_TEST_CASE(add_unused_test) {
+   wasm_instantiation_cache cache( 300, {} );
+
+   cache.add( code("a"), N(alice), make_module( 100 ) );
+   BOOST_CHECK( cache.add_unused( code("b"), make_module( 100 ) ) );
+   BOOST_CHECK( !cache.add_unused( code("b"), make_module( 100 ) ) );
+   // doesn't fit without evicting a module, so it is dropped
+   BOOST_CHECK( !cache.add_unused( code("c"), make_module( 200 ) ) );
+   BOOST_CHECK( !cache.contains( code("c") ) );
+   BOOST_CHECK_EQUAL( cache.stats().evictions, 0u );
+   BOOST_CHECK_EQUAL( cache.stats().memory_size, 200u );
+
+   // the unused module is the least recently used one, evicted before those in use
+   cache.add( code("d"), N(dan), make_module( 200 ) );
+   BOOST_CHECK( cache.contains( code("a") ) );
+   BOOST_CHECK( !cache.contains( code("b") ) );
+   BOOST_CHECK( cache.contains( code("d") ) );
+}
+
+BOOST_AUTO_TEST_CASE(pinned_test) {
+   wasm_instantiation_cache cache( 200, { N(snax) } );
+
+   cache.add( code("system"), N(snax), make_module( 100 ) );
+   cache.add( code("a"), N(alice), make_module( 100 ) );
+   BOOST_CHECK_EQUAL( cache.stats().pinned_entries, 1u );
+
+   // the system contract is the least recently used one but stays
+   cache.add( code("b"), N(bob), make_module( 100 ) );
+   cache.add( code("c"), N(carol), make_module( 100 ) );
+   BOOST_CHECK( cache.contains( code("system") ) );
+   BOOST_CHECK( !cache.contains( code("a") ) );
+   BOOST_CHECK( !cache.contains( code("b") ) );
+   BOOST_CHECK( cache.contains( code("c") ) );
+
+   // the same code run by an account that isn't pinned doesn't pin it twice
+   BOOST_CHECK( cache.get( code("system"), N(alice) ) );
+   BOOST_CHECK_EQUAL( cache.stats().pinned_entries, 1u );
+
+   // once the account runs new code, its old code may be evicted
+   cache.add( code("system2"), N(snax), make_module( 100 ) );
+   BOOST_CHECK_EQUAL( cache.stats().pinned_entries, 1u );
+   cache.add( code("d"), N(dan), make_module( 100 ) );
+   BOOST_CHECK( !cache.contains( code("system") ) );
+   BOOST_CHECK( cache.contains( code("system2") ) );
+   BOOST_CHECK( cache.contains( code("d") ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include <snax/chain/resource_limits.hpp>
 #include <snax/chain/exceptions.hpp>
 #include <snax/chain/wast_to_wasm.hpp>
+#include <snax/chain/wasm_instantiation_cache.hpp>
 #include <asserter/asserter.wast.hpp>
 #include <asserter/asserter.abi.hpp>
 
@@ -28,6 +29,8 @@
 
 #include <array>
 #include <utility>
+#include <thread>
+#include <chrono>
 
 #include "incbin.h"
 
@@ -131,6 +134,98 @@ BOOST_FIXTURE_TEST_CASE( basic_test, TESTER ) try {
 
 } FC_LOG_AND_RETHROW() /// basic_test
 
+/**
+ * Prove a contract can be called right after its setcode, before the block starts compiling it ahead
+ */
+BOOST_FIXTURE_TEST_CASE( call_after_setcode, TESTER ) try {
+   produce_blocks(2);
+
+   create_accounts( {N(asserter)} );
+   produce_block();
+
+   auto wasm = wast_to_wasm( asserter_wast );
+   signed_transaction trx;
+   trx.actions.emplace_back( vector<permission_level>{{N(asserter),config::active_name}},
+                             setcode{ N(asserter), 0, 0, bytes(wasm.begin(), wasm.end()) } );
+   trx.actions.emplace_back( vector<permission_level>{{N(asserter),config::active_name}},
+                             assertdef {1, "Should Not Assert!"} );
+   set_transaction_headers(trx);
+   trx.sign( get_private_key( N(asserter), "active" ), control->get_chain_id() );
+   auto result = push_transaction( trx );
+   BOOST_CHECK_EQUAL(result->receipt->status, transaction_receipt::executed);
+   BOOST_CHECK_EQUAL(result->action_traces.size(), 2);
+
+   signed_transaction assert_trx;
+   assert_trx.actions.emplace_back( vector<permission_level>{{N(asserter),config::active_name}},
+                                    assertdef {0, "Should Assert!"} );
+   set_transaction_headers(assert_trx);
+   assert_trx.sign( get_private_key( N(asserter), "active" ), control->get_chain_id() );
+   BOOST_CHECK_THROW(push_transaction( assert_trx ), snax_assert_message_exception);
+   produce_blocks(1);
+
+   BOOST_REQUIRE_EQUAL(true, chain_has_transaction(trx.id()));
+} FC_LOG_AND_RETHROW() /// call_after_setcode
+
+/**
+ * Prove a contract compiled ahead but never called ends up in the size bounded module cache
+ */
+BOOST_FIXTURE_TEST_CASE( compiled_ahead_uncalled, TESTER ) try {
+   produce_blocks(2);
+
+   create_accounts( {N(asserter), N(noop)} );
+   set_code( N(noop), noop_wast );
+   set_abi( N(noop), noop_abi );
+   produce_block();
+
+   const auto entries = control->get_wasm_interface().get_cache_stats().entries;
+   set_code( N(asserter), asserter_wast );
+   // the compilation only starts once the block is accepted
+   produce_block();
+
+   // the modules compiled ahead are collected on the next call of any contract once they are finished
+   for( uint32_t i = 0; i < 500 && control->get_wasm_interface().get_cache_stats().entries < entries + 2; ++i ) {
+      std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+      push_action( N(noop), N(anyaction), N(noop), mutable_variant_object()
+                   ("from", "noop")
+                   ("type", "some type")
+                   ("data", std::to_string(i)) );
+   }
+   BOOST_REQUIRE_EQUAL( entries + 2, control->get_wasm_interface().get_cache_stats().entries );
+} FC_LOG_AND_RETHROW() /// compiled_ahead_uncalled
+
+/**
+ * Prove the code of a setcode whose transaction fails is not compiled ahead
+ */
+BOOST_FIXTURE_TEST_CASE( failed_setcode_not_compiled, TESTER ) try {
+   produce_blocks(2);
+
+   create_accounts( {N(asserter), N(noop)} );
+   produce_block();
+   const auto entries = control->get_wasm_interface().get_cache_stats().entries;
+
+   auto wasm = wast_to_wasm( asserter_wast );
+   signed_transaction trx;
+   trx.actions.emplace_back( vector<permission_level>{{N(asserter),config::active_name}},
+                             setcode{ N(asserter), 0, 0, bytes(wasm.begin(), wasm.end()) } );
+   trx.actions.emplace_back( vector<permission_level>{{N(asserter),config::active_name}},
+                             assertdef {0, "Should Assert!"} );
+   set_transaction_headers(trx);
+   trx.sign( get_private_key( N(asserter), "active" ), control->get_chain_id() );
+   BOOST_CHECK_THROW( push_transaction( trx ), snax_assert_message_exception );
+
+   set_code( N(noop), noop_wast );
+   set_abi( N(noop), noop_abi );
+   produce_block();
+
+   // give a compilation of the asserter the time to finish, it would be collected with noop's module
+   std::this_thread::sleep_for( std::chrono::milliseconds(500) );
+   push_action( N(noop), N(anyaction), N(noop), mutable_variant_object()
+                ("from", "noop")
+                ("type", "some type")
+                ("data", "") );
+   BOOST_REQUIRE_EQUAL( entries + 1, control->get_wasm_interface().get_cache_stats().entries );
+} FC_LOG_AND_RETHROW() /// failed_setcode_not_compiled
+
 /**
  * Prove the modifications to global variables are wiped between runs
  */
@@ -689,6 +784,37 @@ BOOST_FIXTURE_TEST_CASE( check_global_reset, TESTER ) try {
    BOOST_CHECK_EQUAL(transaction_receipt::executed, receipt.status);
 } FC_LOG_AND_RETHROW()
 
+//Make sure the initial data and zeroed memory are restored for every action, also when contracts with
+//initial data of different sizes take turns
+BOOST_FIXTURE_TEST_CASE( check_data_reset, TESTER ) try {
+   produce_blocks(2);
+
+   create_accounts( {N(datalarge), N(datasmall)} );
+   produce_block();
+
+   set_code(N(datalarge), data_reset_large_wast);
+   set_code(N(datasmall), data_reset_small_wast);
+   produce_blocks(1);
+
+   signed_transaction trx;
+   for( auto contract : {N(datalarge), N(datalarge), N(datasmall), N(datalarge), N(datasmall), N(datasmall)} ) {
+      action act;
+      act.account = contract;
+      act.name = N();
+      act.authorization = vector<permission_level>{{contract,config::active_name}};
+      trx.actions.push_back(act);
+   }
+
+   set_transaction_headers(trx);
+   trx.sign(get_private_key( N(datalarge), "active" ), control->get_chain_id());
+   trx.sign(get_private_key( N(datasmall), "active" ), control->get_chain_id());
+   push_transaction(trx);
+   produce_blocks(1);
+   BOOST_REQUIRE_EQUAL(true, chain_has_transaction(trx.id()));
+   const auto& receipt = get_transaction_receipt(trx.id());
+   BOOST_CHECK_EQUAL(transaction_receipt::executed, receipt.status);
+} FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE( stl_test, TESTER ) try {
     produce_blocks(2);
 
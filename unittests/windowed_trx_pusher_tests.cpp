@@ -0,0 +1,125 @@
+/**
+ *  @file
+ *  @copyright defined in snax/LICENSE.txt
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <snax/ibc_plugin/windowed_trx_pusher.hpp>
+
+#include <deque>
+
+using namespace snax;
+using namespace snax::ibc;
+
+namespace {
+   /// a chain that answers the pushed transactions only when the test says so, in the order they came
+   struct fake_chain {
+      std::deque<windowed_trx_pusher::result_func>   pending;
+      std::vector<std::pair<uint32_t, uint64_t>>     built;   ///< first item and seq_num of every transaction built
+
+      windowed_trx_pusher::push_func push_func() {
+         return [this]( const signed_transaction&, windowed_trx_pusher::result_func next ) {
+            pending.push_back( next );
+         };
+      }
+
+      windowed_trx_pusher::build_func build_func() {
+         return [this]( uint32_t first, uint32_t, uint64_t seq_num ) -> optional<signed_transaction> {
+            built.emplace_back( first, seq_num );
+            signed_transaction trx;
+            trx.ref_block_num = uint16_t( built.size() );   // tells the transactions apart
+            return trx;
+         };
+      }
+
+      void succeed() {
+         auto next = pending.front();
+         pending.pop_front();
+         next( fc::exception_ptr(), fc::variant() );
+      }
+
+      void fail() {
+         auto next = pending.front();
+         pending.pop_front();
+         next( std::make_shared<fc::exception>(), fc::variant() );
+      }
+
+      std::shared_ptr<windowed_trx_pusher> make( uint32_t count, uint32_t window, windowed_trx_pusher::failure_mode mode,
+                                                 std::vector<std::pair<uint32_t, bool>>& done ) {
+         return std::make_shared<windowed_trx_pusher>( "test", count, 10, window, 1, mode, push_func(),
+                                                       []() { return chain_config(); }, build_func(),
+                                                       [&done]( uint32_t first, uint32_t, bool succeeded ) {
+                                                          done.emplace_back( first, succeeded );
+                                                       } );
+      }
+   };
+}
+
+BOOST_AUTO_TEST_SUITE(windowed_trx_pusher_tests)
+
+BOOST_AUTO_TEST_CASE(rewind_test) {
+   fake_chain chain;
+   std::vector<std::pair<uint32_t, bool>> done;
+   auto pusher = chain.make( 6, 3, windowed_trx_pusher::rewind_on_failure, done );
+   pusher->start();
+   BOOST_REQUIRE_EQUAL( chain.pending.size(), 3u );
+   BOOST_CHECK_EQUAL( pusher->stats().in_flight, 3u );
+
+   chain.succeed();   // item 0
+   BOOST_REQUIRE_EQUAL( chain.pending.size(), 3u );   // item 3 took its place
+   chain.fail();      // item 1, items 2 and 3 carry seq_nums that can't be accepted now
+   BOOST_CHECK_EQUAL( chain.pending.size(), 2u );     // nothing new while they drain
+   chain.fail();      // item 2, stale
+   chain.fail();      // item 3, stale
+   BOOST_REQUIRE_EQUAL( chain.pending.size(), 3u );
+
+   // the items after the failed one are rebuilt from its seq_num
+   std::vector<std::pair<uint32_t, uint64_t>> expected = { {0, 10}, {1, 11}, {2, 12}, {3, 13}, {2, 11}, {3, 12}, {4, 13} };
+   BOOST_CHECK( chain.built == expected );
+
+   while( !chain.pending.empty() )
+      chain.succeed();
+   BOOST_CHECK( chain.built.back() == std::make_pair( 5u, uint64_t(14) ) );
+   BOOST_REQUIRE( pusher->finished() );
+
+   auto stats = pusher->stats();
+   BOOST_CHECK( stats.finished );
+   BOOST_CHECK_EQUAL( stats.items, 6u );
+   BOOST_CHECK_EQUAL( stats.succeeded, 5u );
+   BOOST_CHECK_EQUAL( stats.failed, 1u );
+   BOOST_CHECK_EQUAL( stats.rewinds, 1u );
+   BOOST_CHECK_EQUAL( stats.transactions, 8u );
+   BOOST_CHECK_EQUAL( stats.in_flight, 0u );
+   BOOST_CHECK_EQUAL( stats.max_in_flight, 3u );
+
+   std::vector<std::pair<uint32_t, bool>> expected_done = { {0, true}, {1, false}, {2, true}, {3, true}, {4, true}, {5, true} };
+   BOOST_CHECK( done == expected_done );
+}
+
+BOOST_AUTO_TEST_CASE(stop_on_failure_test) {
+   fake_chain chain;
+   std::vector<std::pair<uint32_t, bool>> done;
+   auto pusher = chain.make( 5, 2, windowed_trx_pusher::stop_on_failure, done );
+   pusher->start();
+   BOOST_REQUIRE_EQUAL( chain.pending.size(), 2u );
+
+   chain.fail();      // item 0
+   BOOST_CHECK_EQUAL( chain.pending.size(), 1u );   // nothing is pushed after a failure
+   BOOST_CHECK( !pusher->finished() );               // until item 1 is back
+   chain.succeed();   // item 1
+   BOOST_REQUIRE( pusher->finished() );
+   BOOST_CHECK_EQUAL( chain.built.size(), 2u );
+
+   auto stats = pusher->stats();
+   BOOST_CHECK( stats.finished );
+   BOOST_CHECK_EQUAL( stats.succeeded, 1u );
+   BOOST_CHECK_EQUAL( stats.failed, 1u );
+   BOOST_CHECK_EQUAL( stats.rewinds, 0u );
+   BOOST_CHECK_EQUAL( stats.transactions, 2u );
+   BOOST_CHECK_EQUAL( stats.max_in_flight, 2u );
+
+   std::vector<std::pair<uint32_t, bool>> expected_done = { {0, false}, {1, true} };
+   BOOST_CHECK( done == expected_done );
+}
+
+BOOST_AUTO_TEST_SUITE_END()